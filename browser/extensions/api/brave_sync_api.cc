@@ -4,6 +4,8 @@
 
 #include "brave/browser/extensions/api/brave_sync_api.h"
 
+#include <utility>
+
 #include "brave/common/extensions/api/brave_sync.h"
 #include "brave/components/brave_sync/client/brave_sync_client.h"
 #include "brave/components/brave_sync/brave_sync_service.h"
@@ -96,7 +98,8 @@ ExtensionFunction::ResponseAction BraveSyncGetExistingObjectsFunction::Run() {
   EXTENSION_FUNCTION_VALIDATE(params.get());
 
   auto records = std::make_unique<std::vector<::brave_sync::SyncRecordPtr>>();
-  ::brave_sync::ConvertSyncRecords(params->records, *records.get());
+  ::brave_sync::ConvertSyncRecords(std::move(params->records),
+                                   *records.get());
 
   BraveSyncService* sync_service = GetBraveSyncService(browser_context());
   DCHECK(sync_service);
@@ -115,7 +118,8 @@ ExtensionFunction::ResponseAction BraveSyncResolvedSyncRecordsFunction::Run() {
   EXTENSION_FUNCTION_VALIDATE(params.get());
 
   auto records = std::make_unique<std::vector<::brave_sync::SyncRecordPtr>>();
-  ::brave_sync::ConvertSyncRecords(params->records, *records.get());
+  ::brave_sync::ConvertSyncRecords(std::move(params->records),
+                                   *records.get());
 
   BraveSyncService* sync_service = GetBraveSyncService(browser_context());
   DCHECK(sync_service);
@@ -151,6 +155,15 @@ ExtensionFunction::ResponseAction BraveSyncSyncWordsPreparedFunction::Run() {
   return RespondNow(NoArguments());
 }
 
+ExtensionFunction::ResponseAction
+BraveSyncRecordsChunkProcessedFunction::Run() {
+  BraveSyncService* sync_service = GetBraveSyncService(browser_context());
+  DCHECK(sync_service);
+  sync_service->GetSyncClient()->OnRecordsChunkProcessed();
+
+  return RespondNow(NoArguments());
+}
+
 ExtensionFunction::ResponseAction BraveSyncExtensionInitializedFunction::Run() {
   // Also inform sync client extension started
   BraveSyncService* sync_service = GetBraveSyncService(browser_context());
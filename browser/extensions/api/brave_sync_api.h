@@ -58,6 +58,13 @@ class BraveSyncSaveBookmarksBaseOrderFunction : public UIThreadExtensionFunction
   ResponseAction Run() override;
 };
 
+class BraveSyncRecordsChunkProcessedFunction
+    : public UIThreadExtensionFunction {
+  ~BraveSyncRecordsChunkProcessedFunction() override {}
+  DECLARE_EXTENSION_FUNCTION("braveSync.recordsChunkProcessed", UNKNOWN)
+  ResponseAction Run() override;
+};
+
 class BraveSyncSyncWordsPreparedFunction : public UIThreadExtensionFunction {
   ~BraveSyncSyncWordsPreparedFunction() override {}
   DECLARE_EXTENSION_FUNCTION("braveSync.syncWordsPrepared", UNKNOWN)
@@ -4,7 +4,11 @@
 
 #include "brave/browser/extensions/api/brave_sync_event_router.h"
 
+#include <utility>
+
+#include "base/bind.h"
 #include "brave/common/extensions/api/brave_sync.h"
+#include "brave/common/payload_size.h"
 #include "chrome/browser/profiles/profile.h"
 #include "extensions/browser/extension_event_histogram_value.h"
 
@@ -12,12 +16,86 @@ using extensions::api::brave_sync::RecordAndExistingObject;
 
 namespace extensions {
 
+namespace {
+
+// Records of one event are turned into a base::Value tree and serialized on
+// the UI thread, so events are kept to roughly this many bytes of record
+// data, and to at most kMaxChunkRecords records.
+const size_t kMaxChunkBytes = 256 * 1024;
+const size_t kMaxChunkRecords = 500;
+// How long to wait for the extension to acknowledge a chunk before sending
+// the next one anyway.
+const int kChunkAckTimeoutSec = 30;
+
+// Splits |items| into chunks of at most kMaxChunkBytes estimated bytes and
+// kMaxChunkRecords items. A single oversized item gets a chunk of its own.
+template <typename T>
+std::vector<std::vector<T>> SplitIntoChunks(std::vector<T> items) {
+  std::vector<std::vector<T>> chunks;
+  std::vector<T> chunk;
+  size_t chunk_bytes = 0;
+  for (auto& item : items) {
+    const size_t item_bytes = brave::EstimatePayloadSize(item);
+    if (!chunk.empty() && (chunk_bytes + item_bytes > kMaxChunkBytes ||
+                           chunk.size() == kMaxChunkRecords)) {
+      chunks.push_back(std::move(chunk));
+      chunk = std::vector<T>();
+      chunk_bytes = 0;
+    }
+    chunk.push_back(std::move(item));
+    chunk_bytes += item_bytes;
+  }
+  if (!chunk.empty())
+    chunks.push_back(std::move(chunk));
+  return chunks;
+}
+
+std::unique_ptr<Event> CreateResolveSyncRecordsEvent(
+    const std::string& category_name,
+    std::vector<RecordAndExistingObject> records_and_existing_objects) {
+  std::unique_ptr<base::ListValue> args(
+     extensions::api::brave_sync::OnResolveSyncRecords::Create(
+          category_name,
+          records_and_existing_objects).release());
+  return std::make_unique<Event>(extensions::events::FOR_TEST,
+      extensions::api::brave_sync::OnResolveSyncRecords::kEventName,
+      std::move(args));
+}
+
+std::unique_ptr<Event> CreateSendSyncRecordsEvent(
+    const std::string& category_name,
+    std::vector<api::brave_sync::SyncRecord> records) {
+  std::unique_ptr<base::ListValue> args(
+     extensions::api::brave_sync::OnSendSyncRecords::Create(
+          category_name,
+          records).release());
+  return std::make_unique<Event>(extensions::events::FOR_TEST,
+      extensions::api::brave_sync::OnSendSyncRecords::kEventName,
+      std::move(args));
+}
+
+}  // namespace
+
+BraveSyncEventRouter::PendingChunk::PendingChunk() : records(0) {}
+
+BraveSyncEventRouter::PendingChunk::PendingChunk(PendingChunk&& chunk) =
+    default;
+
+BraveSyncEventRouter::PendingChunk::~PendingChunk() {}
+
 BraveSyncEventRouter::BraveSyncEventRouter(Profile* profile) :
-    event_router_(EventRouter::Get(profile)) {
+    profile_(profile),
+    awaiting_ack_(false),
+    records_sent_(0),
+    records_total_(0) {
 }
 
 BraveSyncEventRouter::~BraveSyncEventRouter() {}
 
+void BraveSyncEventRouter::BroadcastEvent(std::unique_ptr<Event> event) {
+  EventRouter::Get(profile_)->BroadcastEvent(std::move(event));
+}
+
 void BraveSyncEventRouter::GotInitData(
     const brave_sync::Uint8Array& seed,
     const brave_sync::Uint8Array& device_id,
@@ -36,7 +114,7 @@ void BraveSyncEventRouter::GotInitData(
      new Event(extensions::events::FOR_TEST,
        extensions::api::brave_sync::OnGotInitData::kEventName,
        std::move(args)));
-  event_router_->BroadcastEvent(std::move(event));
+  BroadcastEvent(std::move(event));
 }
 
 void BraveSyncEventRouter::FetchSyncRecords(
@@ -51,7 +129,7 @@ void BraveSyncEventRouter::FetchSyncRecords(
      new Event(extensions::events::FOR_TEST,
        extensions::api::brave_sync::OnFetchSyncRecords::kEventName,
        std::move(args)));
-  event_router_->BroadcastEvent(std::move(event));
+  BroadcastEvent(std::move(event));
 }
 
 void BraveSyncEventRouter::FetchSyncDevices() {
@@ -63,12 +141,12 @@ void BraveSyncEventRouter::FetchSyncDevices() {
      new Event(extensions::events::FOR_TEST,
        extensions::api::brave_sync::OnFetchSyncDevices::kEventName,
        std::move(args)));
-  event_router_->BroadcastEvent(std::move(event));
+  BroadcastEvent(std::move(event));
 }
 
 void BraveSyncEventRouter::ResolveSyncRecords(
     const std::string& category_name,
-    const std::vector<RecordAndExistingObject>& records_and_existing_objects) {
+    std::vector<RecordAndExistingObject> records_and_existing_objects) {
   for (const auto & entry : records_and_existing_objects) {
     DCHECK(!entry.server_record.object_data.empty());
     DCHECK(!entry.local_record ||
@@ -78,31 +156,79 @@ void BraveSyncEventRouter::ResolveSyncRecords(
         entry.local_record->object_data == "siteSetting"));
   }
 
-  std::unique_ptr<base::ListValue> args(
-     extensions::api::brave_sync::OnResolveSyncRecords::Create(
-          category_name,
-          records_and_existing_objects).release());
-  std::unique_ptr<Event> event(
-     new Event(extensions::events::FOR_TEST,
-       extensions::api::brave_sync::OnResolveSyncRecords::kEventName,
-       std::move(args)));
+  // the extension still expects an answer for an empty resolve
+  if (records_and_existing_objects.empty()) {
+    QueueChunk(base::BindOnce(&CreateResolveSyncRecordsEvent, category_name,
+                              std::vector<RecordAndExistingObject>()),
+               0);
+    MaybeDispatchChunk();
+    return;
+  }
 
-  event_router_->BroadcastEvent(std::move(event));
+  for (auto& chunk : SplitIntoChunks(std::move(records_and_existing_objects))) {
+    const size_t chunk_size = chunk.size();
+    QueueChunk(base::BindOnce(&CreateResolveSyncRecordsEvent, category_name,
+                              std::move(chunk)),
+               chunk_size);
+  }
+  MaybeDispatchChunk();
 }
 
 void BraveSyncEventRouter::SendSyncRecords(
     const std::string& category_name,
-    const std::vector<api::brave_sync::SyncRecord>& records) {
-  std::unique_ptr<base::ListValue> args(
-     extensions::api::brave_sync::OnSendSyncRecords::Create(
-          category_name,
-          records).release());
-  std::unique_ptr<Event> event(
-     new Event(extensions::events::FOR_TEST,
-       extensions::api::brave_sync::OnSendSyncRecords::kEventName,
-       std::move(args)));
+    std::vector<api::brave_sync::SyncRecord> records) {
+  for (auto& chunk : SplitIntoChunks(std::move(records))) {
+    const size_t chunk_size = chunk.size();
+    QueueChunk(base::BindOnce(&CreateSendSyncRecordsEvent, category_name,
+                              std::move(chunk)),
+               chunk_size);
+  }
+  MaybeDispatchChunk();
+}
+
+void BraveSyncEventRouter::OnChunkProcessed() {
+  if (!awaiting_ack_)
+    return;
+
+  awaiting_ack_ = false;
+  ack_timer_.Stop();
+  MaybeDispatchChunk();
+}
+
+void BraveSyncEventRouter::QueueChunk(
+    base::OnceCallback<std::unique_ptr<Event>()> create_event,
+    size_t records) {
+  PendingChunk chunk;
+  chunk.create_event = std::move(create_event);
+  chunk.records = records;
+  pending_chunks_.push_back(std::move(chunk));
+  records_total_ += records;
+}
 
-  event_router_->BroadcastEvent(std::move(event));
+void BraveSyncEventRouter::MaybeDispatchChunk() {
+  if (awaiting_ack_)
+    return;
+
+  if (pending_chunks_.empty()) {
+    records_sent_ = 0;
+    records_total_ = 0;
+    return;
+  }
+
+  PendingChunk chunk = std::move(pending_chunks_.front());
+  pending_chunks_.pop_front();
+
+  awaiting_ack_ = true;
+  ack_timer_.Start(FROM_HERE,
+                   base::TimeDelta::FromSeconds(kChunkAckTimeoutSec),
+                   this,
+                   &BraveSyncEventRouter::OnChunkProcessed);
+
+  BroadcastEvent(std::move(chunk.create_event).Run());
+
+  records_sent_ += chunk.records;
+  if (progress_callback_)
+    progress_callback_.Run(records_sent_, records_total_);
 }
 
 void BraveSyncEventRouter::SendGetBookmarksBaseOrder(
@@ -116,7 +242,7 @@ void BraveSyncEventRouter::SendGetBookmarksBaseOrder(
        extensions::api::brave_sync::OnSendGetBookmarksBaseOrder::kEventName,
        std::move(args)));
 
-  event_router_->BroadcastEvent(std::move(event));
+  BroadcastEvent(std::move(event));
 }
 
 void BraveSyncEventRouter::NeedSyncWords(const std::string& seed) {
@@ -127,10 +253,17 @@ void BraveSyncEventRouter::NeedSyncWords(const std::string& seed) {
      new Event(extensions::events::FOR_TEST,
        extensions::api::brave_sync::OnNeedSyncWords::kEventName,
        std::move(args)));
-  event_router_->BroadcastEvent(std::move(event));
+  BroadcastEvent(std::move(event));
 }
 
 void BraveSyncEventRouter::LoadClient() {
+  // a reloaded extension won't acknowledge chunks sent to the previous one
+  pending_chunks_.clear();
+  awaiting_ack_ = false;
+  ack_timer_.Stop();
+  records_sent_ = 0;
+  records_total_ = 0;
+
   std::unique_ptr<base::ListValue> args(
      extensions::api::brave_sync::OnLoadClient::Create()
        .release());
@@ -139,7 +272,7 @@ void BraveSyncEventRouter::LoadClient() {
      new Event(extensions::events::FOR_TEST,
        extensions::api::brave_sync::OnLoadClient::kEventName,
        std::move(args)));
-  event_router_->BroadcastEvent(std::move(event));
+  BroadcastEvent(std::move(event));
 }
 
 } // namespace extensions
@@ -5,7 +5,13 @@
 #ifndef BRAVE_BROWSER_EXTENSIONS_API_BRAVE_SYNC_EVENT_ROUTER_H_
 #define BRAVE_BROWSER_EXTENSIONS_API_BRAVE_SYNC_EVENT_ROUTER_H_
 
+#include <deque>
+#include <memory>
 #include <string>
+#include <vector>
+
+#include "base/callback.h"
+#include "base/timer/timer.h"
 #include "extensions/browser/event_router.h"
 
 class Profile;
@@ -31,7 +37,7 @@ namespace extensions {
 class BraveSyncEventRouter {
  public:
   BraveSyncEventRouter(Profile* profile);
-  ~BraveSyncEventRouter();
+  virtual ~BraveSyncEventRouter();
 
   void GotInitData(
     const brave_sync::Uint8Array& seed,
@@ -46,11 +52,24 @@ class BraveSyncEventRouter {
 
   void FetchSyncDevices();
 
+  // Records are sent in chunks of bounded size. The next chunk is only
+  // dispatched once the extension acknowledged the previous one.
   void ResolveSyncRecords(const std::string &category_name,
-    const std::vector<RecordAndExistingObject>& records_and_existing_objects);
+    std::vector<RecordAndExistingObject> records_and_existing_objects);
 
   void SendSyncRecords(const std::string& category_name,
-                       const std::vector<api::brave_sync::SyncRecord>& records);
+                       std::vector<api::brave_sync::SyncRecord> records);
+
+  // Called when the extension has handled the last chunk of records.
+  void OnChunkProcessed();
+
+  // Runs with the number of records dispatched to the extension and the
+  // number queued in total, each time a chunk is dispatched.
+  using ProgressCallback =
+      base::RepeatingCallback<void(size_t records_sent, size_t records_total)>;
+  void set_progress_callback(const ProgressCallback& callback) {
+    progress_callback_ = callback;
+  }
 
   void SendGetBookmarksBaseOrder(const std::string& device_id,
                                  const std::string& platform);
@@ -59,8 +78,38 @@ class BraveSyncEventRouter {
 
   void LoadClient();
 
+ protected:
+  // Sends |event| to the extension.
+  virtual void BroadcastEvent(std::unique_ptr<Event> event);
+
 private:
-  EventRouter* event_router_;
+  struct PendingChunk {
+    PendingChunk();
+    PendingChunk(PendingChunk&& chunk);
+    ~PendingChunk();
+
+    // Builds the event only when dispatched, so queued chunks are not held
+    // as base::Value trees.
+    base::OnceCallback<std::unique_ptr<Event>()> create_event;
+    size_t records;
+  };
+
+  // Queued chunks are dispatched by MaybeDispatchChunk(), once every chunk
+  // of a call is queued so that the progress counts all of them.
+  void QueueChunk(base::OnceCallback<std::unique_ptr<Event>()> create_event,
+                  size_t records);
+  void MaybeDispatchChunk();
+
+  Profile* profile_;
+
+  std::deque<PendingChunk> pending_chunks_;
+  bool awaiting_ack_;
+  // Guards against an extension that never acknowledges a chunk.
+  base::OneShotTimer ack_timer_;
+  // Progress of the chunks queued since the queue was last empty.
+  size_t records_sent_;
+  size_t records_total_;
+  ProgressCallback progress_callback_;
 };
 
 } // namespace extensions
@@ -0,0 +1,233 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/browser/extensions/api/brave_sync_event_router.h"
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/bind.h"
+#include "base/macros.h"
+#include "base/test/scoped_task_environment.h"
+#include "base/time/time.h"
+#include "brave/common/extensions/api/brave_sync.h"
+#include "testing/gmock/include/gmock/gmock.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+// npm run test -- brave_unit_tests --filter=BraveSyncEventRouterTest.*
+
+using testing::ElementsAre;
+using testing::Pair;
+
+namespace extensions {
+
+namespace {
+
+// Estimated size of a device record is the per-record overhead, its object
+// data and its name. Records of this name size fill a chunk by fours.
+const size_t kQuarterChunkNameSize = 64 * 1024 - 64 - 6;
+
+// Keeps the names and record counts of the events instead of sending them.
+class TestBraveSyncEventRouter : public BraveSyncEventRouter {
+ public:
+  TestBraveSyncEventRouter() : BraveSyncEventRouter(nullptr) {}
+  ~TestBraveSyncEventRouter() override {}
+
+  // Pairs of event name and number of records in the event.
+  const std::vector<std::pair<std::string, size_t>>& events() const {
+    return events_;
+  }
+
+ protected:
+  void BroadcastEvent(std::unique_ptr<Event> event) override {
+    size_t records = 0;
+    const auto& args = event->event_args->GetList();
+    if (args.size() == 2 && args[1].is_list())
+      records = args[1].GetList().size();
+    events_.push_back(std::make_pair(event->event_name, records));
+  }
+
+ private:
+  std::vector<std::pair<std::string, size_t>> events_;
+
+  DISALLOW_COPY_AND_ASSIGN(TestBraveSyncEventRouter);
+};
+
+api::brave_sync::SyncRecord DeviceRecord(size_t name_size) {
+  api::brave_sync::SyncRecord record;
+  record.object_data = "device";
+  record.device = std::make_unique<api::brave_sync::Device>();
+  record.device->name = std::string(name_size, 'd');
+  return record;
+}
+
+std::vector<api::brave_sync::SyncRecord> DeviceRecords(size_t count,
+                                                       size_t name_size) {
+  std::vector<api::brave_sync::SyncRecord> records;
+  for (size_t i = 0; i < count; ++i)
+    records.push_back(DeviceRecord(name_size));
+  return records;
+}
+
+}  // namespace
+
+class BraveSyncEventRouterTest : public testing::Test {
+ public:
+  BraveSyncEventRouterTest()
+      : scoped_task_environment_(
+            base::test::ScopedTaskEnvironment::MainThreadType::MOCK_TIME) {}
+  ~BraveSyncEventRouterTest() override {}
+
+ protected:
+  void SetUp() override {
+    router_.set_progress_callback(base::BindRepeating(
+        [](std::vector<std::pair<size_t, size_t>>* progress,
+           size_t records_sent, size_t records_total) {
+          progress->push_back(std::make_pair(records_sent, records_total));
+        },
+        &progress_));
+  }
+
+  // Acknowledges every chunk until the queue is empty.
+  void AckAll() {
+    size_t events;
+    do {
+      events = router_.events().size();
+      router_.OnChunkProcessed();
+    } while (router_.events().size() > events);
+  }
+
+  // Record counts of the events sent.
+  std::vector<size_t> ChunkSizes() const {
+    std::vector<size_t> sizes;
+    for (const auto& event : router_.events())
+      sizes.push_back(event.second);
+    return sizes;
+  }
+
+  base::test::ScopedTaskEnvironment scoped_task_environment_;
+  TestBraveSyncEventRouter router_;
+  std::vector<std::pair<size_t, size_t>> progress_;
+};
+
+TEST_F(BraveSyncEventRouterTest, ChunksByRecordCount) {
+  router_.SendSyncRecords("BOOKMARKS", DeviceRecords(1001, 10));
+  AckAll();
+  EXPECT_THAT(ChunkSizes(), ElementsAre(500u, 500u, 1u));
+  EXPECT_THAT(progress_, ElementsAre(Pair(500u, 1001u), Pair(1000u, 1001u),
+                                     Pair(1001u, 1001u)));
+}
+
+TEST_F(BraveSyncEventRouterTest, ChunksBySize) {
+  // exactly full chunks
+  router_.SendSyncRecords("BOOKMARKS",
+                          DeviceRecords(8, kQuarterChunkNameSize));
+  AckAll();
+  EXPECT_THAT(ChunkSizes(), ElementsAre(4u, 4u));
+
+  // one byte more and the fourth record starts the next chunk
+  router_.SendSyncRecords("BOOKMARKS",
+                          DeviceRecords(4, kQuarterChunkNameSize + 1));
+  AckAll();
+  EXPECT_THAT(ChunkSizes(), ElementsAre(4u, 4u, 3u, 1u));
+}
+
+TEST_F(BraveSyncEventRouterTest, OversizedRecordGetsItsOwnChunk) {
+  std::vector<api::brave_sync::SyncRecord> records;
+  records.push_back(DeviceRecord(10));
+  records.push_back(DeviceRecord(5 * kQuarterChunkNameSize));
+  records.push_back(DeviceRecord(10));
+  router_.SendSyncRecords("BOOKMARKS", std::move(records));
+  AckAll();
+  EXPECT_THAT(ChunkSizes(), ElementsAre(1u, 1u, 1u));
+}
+
+TEST_F(BraveSyncEventRouterTest, EmptyResolveIsAnswered) {
+  router_.SendSyncRecords("BOOKMARKS", DeviceRecords(0, 10));
+  EXPECT_TRUE(router_.events().empty());
+
+  router_.ResolveSyncRecords("BOOKMARKS",
+                             std::vector<RecordAndExistingObject>());
+  ASSERT_EQ(1u, router_.events().size());
+  EXPECT_EQ(api::brave_sync::OnResolveSyncRecords::kEventName,
+            router_.events()[0].first);
+  EXPECT_EQ(0u, router_.events()[0].second);
+}
+
+TEST_F(BraveSyncEventRouterTest, ChunksWaitForTheAck) {
+  router_.SendSyncRecords("BOOKMARKS", DeviceRecords(600, 10));
+  std::vector<RecordAndExistingObject> records;
+  for (int i = 0; i < 3; ++i) {
+    RecordAndExistingObject record;
+    record.server_record = DeviceRecord(10);
+    records.push_back(std::move(record));
+  }
+  router_.ResolveSyncRecords("BOOKMARKS", std::move(records));
+  ASSERT_EQ(1u, router_.events().size());
+
+  router_.OnChunkProcessed();
+  ASSERT_EQ(2u, router_.events().size());
+  router_.OnChunkProcessed();
+  ASSERT_EQ(3u, router_.events().size());
+  // an ack while none is awaited is ignored
+  router_.OnChunkProcessed();
+  router_.OnChunkProcessed();
+  EXPECT_EQ(3u, router_.events().size());
+
+  // chunks go out in the order they were queued
+  EXPECT_EQ(api::brave_sync::OnSendSyncRecords::kEventName,
+            router_.events()[0].first);
+  EXPECT_EQ(api::brave_sync::OnSendSyncRecords::kEventName,
+            router_.events()[1].first);
+  EXPECT_EQ(api::brave_sync::OnResolveSyncRecords::kEventName,
+            router_.events()[2].first);
+  EXPECT_THAT(ChunkSizes(), ElementsAre(500u, 100u, 3u));
+  EXPECT_THAT(progress_, ElementsAre(Pair(500u, 600u), Pair(600u, 603u),
+                                     Pair(603u, 603u)));
+}
+
+TEST_F(BraveSyncEventRouterTest, MissingAckTimesOut) {
+  router_.SendSyncRecords("BOOKMARKS", DeviceRecords(1500, 10));
+  ASSERT_EQ(1u, router_.events().size());
+
+  scoped_task_environment_.FastForwardBy(base::TimeDelta::FromSeconds(29));
+  EXPECT_EQ(1u, router_.events().size());
+  scoped_task_environment_.FastForwardBy(base::TimeDelta::FromSeconds(1));
+  EXPECT_EQ(2u, router_.events().size());
+
+  // an ack sends the next chunk right away
+  scoped_task_environment_.FastForwardBy(base::TimeDelta::FromSeconds(20));
+  router_.OnChunkProcessed();
+  ASSERT_EQ(3u, router_.events().size());
+
+  // the last chunk timing out has nothing to follow it
+  scoped_task_environment_.FastForwardBy(base::TimeDelta::FromSeconds(30));
+  EXPECT_EQ(3u, router_.events().size());
+  router_.SendSyncRecords("BOOKMARKS", DeviceRecords(1, 10));
+  EXPECT_EQ(4u, router_.events().size());
+}
+
+TEST_F(BraveSyncEventRouterTest, LoadClientDropsQueuedChunks) {
+  router_.SendSyncRecords("BOOKMARKS", DeviceRecords(1500, 10));
+  ASSERT_EQ(1u, router_.events().size());
+
+  router_.LoadClient();
+  ASSERT_EQ(2u, router_.events().size());
+  EXPECT_EQ(api::brave_sync::OnLoadClient::kEventName,
+            router_.events()[1].first);
+
+  // nothing is awaited from the new client
+  router_.OnChunkProcessed();
+  scoped_task_environment_.FastForwardBy(base::TimeDelta::FromSeconds(30));
+  EXPECT_EQ(2u, router_.events().size());
+
+  router_.SendSyncRecords("BOOKMARKS", DeviceRecords(1, 10));
+  ASSERT_EQ(3u, router_.events().size());
+  EXPECT_EQ(1u, router_.events()[2].second);
+  EXPECT_THAT(progress_.back(), Pair(1u, 1u));
+}
+
+}  // namespace extensions
@@ -6,6 +6,8 @@
 
 #include "brave/browser/importer/brave_external_process_importer_client.h"
 
+#include "chrome/common/importer/importer_data_types.h"
+
 BraveExternalProcessImporterClient::BraveExternalProcessImporterClient(
     base::WeakPtr<ExternalProcessImporterHost> importer_host,
     const importer::SourceProfile& source_profile,
@@ -13,6 +15,8 @@ BraveExternalProcessImporterClient::BraveExternalProcessImporterClient(
     BraveInProcessImporterBridge* bridge)
     : ExternalProcessImporterClient(
           importer_host, source_profile, items, bridge),
+      total_history_rows_count_(0),
+      total_favicons_count_(0),
       total_cookies_count_(0),
       bridge_(bridge),
       cancelled_(false) {}
@@ -25,6 +29,53 @@ void BraveExternalProcessImporterClient::Cancel() {
   ExternalProcessImporterClient::Cancel();
 }
 
+void BraveExternalProcessImporterClient::OnHistoryImportStart(
+    uint32_t total_history_rows_count) {
+  if (cancelled_)
+    return;
+
+  total_history_rows_count_ = total_history_rows_count;
+  history_rows_.reserve(total_history_rows_count);
+}
+
+void BraveExternalProcessImporterClient::OnHistoryImportGroup(
+    const std::vector<ImporterURLRow>& history_rows_group,
+    int visit_source) {
+  if (cancelled_)
+    return;
+
+  history_rows_.insert(history_rows_.end(), history_rows_group.begin(),
+                       history_rows_group.end());
+  if (history_rows_.size() >= total_history_rows_count_) {
+    bridge_->SetHistoryItems(history_rows_,
+                             static_cast<importer::VisitSource>(visit_source));
+    // don't hold on to rows already written
+    std::vector<ImporterURLRow>().swap(history_rows_);
+  }
+}
+
+void BraveExternalProcessImporterClient::OnFaviconsImportStart(
+    uint32_t total_favicons_count) {
+  if (cancelled_)
+    return;
+
+  total_favicons_count_ = total_favicons_count;
+  favicons_.reserve(total_favicons_count);
+}
+
+void BraveExternalProcessImporterClient::OnFaviconsImportGroup(
+    const favicon_base::FaviconUsageDataList& favicons_group) {
+  if (cancelled_)
+    return;
+
+  favicons_.insert(favicons_.end(), favicons_group.begin(),
+                   favicons_group.end());
+  if (favicons_.size() >= total_favicons_count_) {
+    bridge_->SetFavicons(favicons_);
+    favicon_base::FaviconUsageDataList().swap(favicons_);
+  }
+}
+
 void BraveExternalProcessImporterClient::OnCookiesImportStart(
     uint32_t total_cookies_count) {
   if (cancelled_)
@@ -41,8 +92,11 @@ void BraveExternalProcessImporterClient::OnCookiesImportGroup(
 
   cookies_.insert(cookies_.end(), cookies_group.begin(),
                   cookies_group.end());
-  if (cookies_.size() >= total_cookies_count_)
+  if (cookies_.size() >= total_cookies_count_) {
     bridge_->SetCookies(cookies_);
+    // importers may send their cookies in several chunks
+    std::vector<net::CanonicalCookie>().swap(cookies_);
+  }
 }
 
 void BraveExternalProcessImporterClient::OnStatsImportReady(
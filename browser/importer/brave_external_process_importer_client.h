@@ -9,6 +9,8 @@
 
 #include "brave/browser/importer/brave_in_process_importer_bridge.h"
 #include "chrome/browser/importer/external_process_importer_client.h"
+#include "chrome/common/importer/importer_url_row.h"
+#include "components/favicon_base/favicon_usage_data.h"
 #include "net/cookies/canonical_cookie.h"
 
 struct BraveStats;
@@ -24,6 +26,16 @@ class BraveExternalProcessImporterClient : public ExternalProcessImporterClient
   // Called by the ExternalProcessImporterHost on import cancel.
   void Cancel();
 
+  // The importer sends history in chunks, each announced by its own
+  // OnHistoryImportStart, and every chunk is written once complete.
+  void OnHistoryImportStart(uint32_t total_history_rows_count) override;
+  void OnHistoryImportGroup(
+      const std::vector<ImporterURLRow>& history_rows_group,
+      int visit_source) override;
+  // Favicons are also sent in batches, each written once complete.
+  void OnFaviconsImportStart(uint32_t total_favicons_count) override;
+  void OnFaviconsImportGroup(
+      const favicon_base::FaviconUsageDataList& favicons_group) override;
   void OnCookiesImportStart(
       uint32_t total_cookies_count) override;
   void OnCookiesImportGroup(
@@ -34,11 +46,19 @@ class BraveExternalProcessImporterClient : public ExternalProcessImporterClient
  private:
   ~BraveExternalProcessImporterClient() override;
 
+  // Number of rows in the history chunk being received.
+  size_t total_history_rows_count_;
+
+  // Number of favicons in the batch being received.
+  size_t total_favicons_count_;
+
   // Total number of cookies to import.
   size_t total_cookies_count_;
 
   scoped_refptr<BraveInProcessImporterBridge> bridge_;
 
+  std::vector<ImporterURLRow> history_rows_;
+  favicon_base::FaviconUsageDataList favicons_;
   std::vector<net::CanonicalCookie> cookies_;
 
   // True if import process has been cancelled.
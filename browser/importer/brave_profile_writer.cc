@@ -7,6 +7,11 @@
 #include "brave/common/pref_names.h"
 #include "brave/utility/importer/brave_importer.h"
 
+#include <algorithm>
+#include <utility>
+
+#include "base/barrier_closure.h"
+#include "base/bind.h"
 #include "base/time/time.h"
 #include "chrome/browser/profiles/profile.h"
 #include "content/public/browser/browser_context.h"
@@ -19,28 +24,69 @@
 #include "net/url_request/url_request_context_getter.h"
 #include "services/network/public/mojom/cookie_manager.mojom.h"
 
+namespace {
+
+// Cookies sent to the network service before waiting for it to store them.
+const size_t kCookieGroupSize = 500;
+
+void OnCookieSet(const base::RepeatingClosure& barrier, bool success) {
+  barrier.Run();
+}
+
+}  // namespace
+
 BraveProfileWriter::BraveProfileWriter(Profile* profile)
-    : ProfileWriter(profile) {}
+    : ProfileWriter(profile),
+      cookies_in_flight_(0) {}
 
 BraveProfileWriter::~BraveProfileWriter() {}
 
 void BraveProfileWriter::AddCookies(
     const std::vector<net::CanonicalCookie>& cookies) {
-  network::mojom::CookieManagerPtr cookie_manager;
-  content::BrowserContext::GetDefaultStoragePartition(profile_)
-      ->GetNetworkContext()
-      ->GetCookieManager(mojo::MakeRequest(&cookie_manager));
-
-  for (auto& cookie : cookies) {
-    cookie_manager->SetCanonicalCookie(
-        cookie,
-        true,  // secure_source
-        true,  // modify_http_only
-        // Fire and forget
-        network::mojom::CookieManager::SetCanonicalCookieCallback());
+  DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
+  pending_cookies_.insert(pending_cookies_.end(),
+                          cookies.begin(), cookies.end());
+  if (cookies_in_flight_ == 0)
+    SendCookieGroup();
+}
+
+void BraveProfileWriter::SendCookieGroup() {
+  if (pending_cookies_.empty())
+    return;
+
+  cookies_in_flight_ = std::min(kCookieGroupSize, pending_cookies_.size());
+  // The callbacks keep the writer alive until the group is stored. They are
+  // dropped if the network service goes away.
+  base::RepeatingClosure barrier = base::BarrierClosure(
+      cookies_in_flight_,
+      base::BindOnce(&BraveProfileWriter::OnCookieGroupSet,
+                     base::WrapRefCounted(this)));
+  for (size_t i = 0; i < cookies_in_flight_; ++i) {
+    SetCanonicalCookie(pending_cookies_.front(),
+                       base::BindOnce(&OnCookieSet, barrier));
+    pending_cookies_.pop_front();
   }
 }
 
+void BraveProfileWriter::SetCanonicalCookie(
+    const net::CanonicalCookie& cookie,
+    base::OnceCallback<void(bool)> callback) {
+  if (!cookie_manager_) {
+    content::BrowserContext::GetDefaultStoragePartition(profile_)
+        ->GetNetworkContext()
+        ->GetCookieManager(mojo::MakeRequest(&cookie_manager_));
+  }
+  cookie_manager_->SetCanonicalCookie(cookie,
+                                      true,  // secure_source
+                                      true,  // modify_http_only
+                                      std::move(callback));
+}
+
+void BraveProfileWriter::OnCookieGroupSet() {
+  cookies_in_flight_ = 0;
+  SendCookieGroup();
+}
+
 void BraveProfileWriter::UpdateStats(const BraveStats& stats) {
   PrefService* prefs = profile_->GetOriginalProfile()->GetPrefs();
 
@@ -7,9 +7,12 @@
 
 #include <vector>
 
+#include "base/callback.h"
+#include "base/containers/circular_deque.h"
 #include "base/macros.h"
 #include "chrome/browser/importer/profile_writer.h"
 #include "net/cookies/canonical_cookie.h"
+#include "services/network/public/mojom/cookie_manager.mojom.h"
 
 struct BraveStats;
 
@@ -17,12 +20,29 @@ class BraveProfileWriter : public ProfileWriter {
  public:
   explicit BraveProfileWriter(Profile* profile);
 
+  // Hands |cookies| to the network service in groups, sending the next
+  // group once the previous one is stored.
   virtual void AddCookies(const std::vector<net::CanonicalCookie>& cookies);
   virtual void UpdateStats(const BraveStats& stats);
 
  protected:
   friend class base::RefCountedThreadSafe<BraveProfileWriter>;
   ~BraveProfileWriter() override;
+
+  // Sends one cookie to the network service. Overridden in tests.
+  virtual void SetCanonicalCookie(const net::CanonicalCookie& cookie,
+                                  base::OnceCallback<void(bool)> callback);
+
+ private:
+  void SendCookieGroup();
+  void OnCookieGroupSet();
+
+  network::mojom::CookieManagerPtr cookie_manager_;
+  base::circular_deque<net::CanonicalCookie> pending_cookies_;
+  // Cookies of the group sent to the network service.
+  size_t cookies_in_flight_;
+
+  DISALLOW_COPY_AND_ASSIGN(BraveProfileWriter);
 };
 
 #endif  // BRAVE_BROWSER_IMPORTER_BRAVE_PROFILE_WRITER_H_
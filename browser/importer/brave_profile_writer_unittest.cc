@@ -0,0 +1,128 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/browser/importer/brave_profile_writer.h"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/callback.h"
+#include "base/macros.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/time/time.h"
+#include "content/public/test/test_browser_thread_bundle.h"
+#include "net/cookies/canonical_cookie.h"
+#include "net/cookies/cookie_constants.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+// npm run test -- brave_unit_tests --filter=BraveProfileWriterTest.*
+
+namespace {
+
+// Keeps the cookies sent to the network service and stores them on demand.
+class TestBraveProfileWriter : public BraveProfileWriter {
+ public:
+  TestBraveProfileWriter() : BraveProfileWriter(nullptr) {}
+
+  // Names of the cookies sent so far, in order.
+  const std::vector<std::string>& sent() const { return sent_; }
+  size_t in_flight() const { return callbacks_.size(); }
+
+  // Reports every cookie sent so far as stored.
+  void StoreAll() {
+    std::vector<base::OnceCallback<void(bool)>> callbacks;
+    callbacks.swap(callbacks_);
+    for (auto& callback : callbacks)
+      std::move(callback).Run(true);
+  }
+
+  // Drops the callbacks, which hold a reference to the writer.
+  void DropAll() { callbacks_.clear(); }
+
+ protected:
+  ~TestBraveProfileWriter() override {}
+
+  void SetCanonicalCookie(const net::CanonicalCookie& cookie,
+                          base::OnceCallback<void(bool)> callback) override {
+    sent_.push_back(cookie.Name());
+    callbacks_.push_back(std::move(callback));
+  }
+
+ private:
+  std::vector<std::string> sent_;
+  std::vector<base::OnceCallback<void(bool)>> callbacks_;
+
+  DISALLOW_COPY_AND_ASSIGN(TestBraveProfileWriter);
+};
+
+std::vector<net::CanonicalCookie> Cookies(int first, int count) {
+  std::vector<net::CanonicalCookie> cookies;
+  for (int i = first; i < first + count; ++i) {
+    cookies.push_back(net::CanonicalCookie(
+        "cookie" + base::IntToString(i), "value", "brave.com", "/",
+        base::Time(), base::Time(), base::Time(), false, false,
+        net::CookieSameSite::NO_RESTRICTION, net::COOKIE_PRIORITY_DEFAULT));
+  }
+  return cookies;
+}
+
+}  // namespace
+
+class BraveProfileWriterTest : public testing::Test {
+ public:
+  BraveProfileWriterTest() : writer_(new TestBraveProfileWriter) {}
+  ~BraveProfileWriterTest() override {}
+
+ protected:
+  void TearDown() override { writer_->DropAll(); }
+
+  content::TestBrowserThreadBundle thread_bundle_;
+  scoped_refptr<TestBraveProfileWriter> writer_;
+};
+
+TEST_F(BraveProfileWriterTest, SendsCookiesInGroups) {
+  writer_->AddCookies(Cookies(0, 1001));
+  EXPECT_EQ(500u, writer_->in_flight());
+
+  // the next group goes out once the whole group is stored
+  writer_->StoreAll();
+  EXPECT_EQ(500u, writer_->in_flight());
+  writer_->StoreAll();
+  EXPECT_EQ(1u, writer_->in_flight());
+  writer_->StoreAll();
+  EXPECT_EQ(0u, writer_->in_flight());
+
+  ASSERT_EQ(1001u, writer_->sent().size());
+  EXPECT_EQ("cookie0", writer_->sent().front());
+  EXPECT_EQ("cookie1000", writer_->sent().back());
+}
+
+TEST_F(BraveProfileWriterTest, ExactlyFullGroup) {
+  writer_->AddCookies(Cookies(0, 500));
+  EXPECT_EQ(500u, writer_->in_flight());
+  writer_->StoreAll();
+  EXPECT_EQ(0u, writer_->in_flight());
+  EXPECT_EQ(500u, writer_->sent().size());
+}
+
+TEST_F(BraveProfileWriterTest, CookiesAddedWhileAGroupIsInFlightWait) {
+  writer_->AddCookies(Cookies(0, 10));
+  writer_->AddCookies(Cookies(10, 10));
+  EXPECT_EQ(10u, writer_->in_flight());
+
+  writer_->StoreAll();
+  EXPECT_EQ(10u, writer_->in_flight());
+  ASSERT_EQ(20u, writer_->sent().size());
+  EXPECT_EQ("cookie10", writer_->sent()[10]);
+}
+
+TEST_F(BraveProfileWriterTest, NoCookies) {
+  writer_->AddCookies(Cookies(0, 0));
+  EXPECT_TRUE(writer_->sent().empty());
+
+  // nothing is awaited, so the next cookies go out right away
+  writer_->AddCookies(Cookies(0, 1));
+  EXPECT_EQ(1u, writer_->in_flight());
+}
@@ -226,6 +226,12 @@ void BraveNetworkDelegateBase::RunNextCallback(
     return;
   }
 
+  if (ctx->pending_error != net::OK) {
+    RunCallbackForRequestIdentifier(ctx->request_identifier,
+                                    ctx->pending_error);
+    return;
+  }
+
   // Continue processing callbacks until we hit one that returns PENDING
   int rv = net::OK;
 
@@ -4,8 +4,10 @@
 
 #include "brave/browser/net/brave_tor_network_delegate_helper.h"
 
+#include "base/bind.h"
 #include "brave/browser/renderer_host/brave_navigation_ui_data.h"
 #include "brave/browser/tor/tor_profile_service.h"
+#include "brave/browser/tor/tor_proxy_config_service.h"
 #include "content/public/browser/browser_thread.h"
 #include "content/public/browser/resource_request_info.h"
 #include "content/public/common/url_constants.h"
@@ -17,6 +19,35 @@ using content::ResourceRequestInfo;
 
 namespace brave {
 
+namespace {
+
+// Only navigations carry the navigation data, but subresources use the same
+// proxy service. Each request keys its circuit on the site of the page that
+// made it, which is the request's own for a main frame.
+void SetRequestFirstParty(net::ProxyResolutionService* proxy_service,
+                          const BraveRequestInfo& ctx) {
+  const GURL first_party =
+      ctx.tab_origin.is_empty() ? ctx.request_url : ctx.tab_origin;
+  tor::TorProxyConfigService::SetRequestFirstParty(
+      proxy_service, ctx.request_url, first_party);
+}
+
+// |proxy_service| only identifies the service, it may be gone by now.
+void OnTorConnected(const ResponseCallback& next_callback,
+                    net::ProxyResolutionService* proxy_service,
+                    std::shared_ptr<BraveRequestInfo> ctx,
+                    bool connected) {
+  // The first party is noted now that the request will be resolved, a
+  // request that waited long could have outlived the note otherwise.
+  if (connected)
+    SetRequestFirstParty(proxy_service, *ctx);
+  else
+    ctx->pending_error = net::ERR_TUNNEL_CONNECTION_FAILED;
+  next_callback.Run();
+}
+
+}  // namespace
+
 int OnBeforeURLRequest_TorWork(
     const ResponseCallback& next_callback,
     std::shared_ptr<BraveRequestInfo> ctx) {
@@ -28,28 +59,28 @@ int OnBeforeURLRequest_TorWork(
     return net::OK;
   }
 
+  auto* proxy_service = ctx->request->context()->proxy_resolution_service();
   const BraveNavigationUIData* ui_data =
     static_cast<const BraveNavigationUIData*>(
         resource_info->GetNavigationUIData());
-  if (!ui_data) {
-    return net::OK;
-  }
+  auto* tor_profile_service =
+      ui_data ? ui_data->GetTorProfileService() : nullptr;
+  if (tor_profile_service) {
+    if (!(ctx->request_url.SchemeIsHTTPOrHTTPS() ||
+          ctx->request_url.SchemeIs(content::kChromeUIScheme) ||
+          ctx->request_url.SchemeIs(extensions::kExtensionScheme) ||
+          ctx->request_url.SchemeIs(content::kChromeDevToolsScheme))) {
+      return net::ERR_DISALLOWED_URL_SCHEME;
+    }
+    tor_profile_service->SetProxy(proxy_service, ctx->request_url, false);
 
-  auto* tor_profile_service = ui_data->GetTorProfileService();
-  if (!tor_profile_service) {
-    return net::OK;
+    // Until tor has a circuit the request could only fail, so it waits.
+    if (!tor_profile_service->WaitForTorConnected(base::BindOnce(
+            &OnTorConnected, next_callback, proxy_service, ctx)))
+      return net::ERR_IO_PENDING;
   }
 
-  if (!(ctx->request_url.SchemeIsHTTPOrHTTPS() ||
-        ctx->request_url.SchemeIs(content::kChromeUIScheme) ||
-        ctx->request_url.SchemeIs(extensions::kExtensionScheme) ||
-        ctx->request_url.SchemeIs(content::kChromeDevToolsScheme))) {
-    return net::ERR_DISALLOWED_URL_SCHEME;
-  }
-
-  auto* proxy_service = ctx->request->context()->proxy_resolution_service();
-  tor_profile_service->SetProxy(proxy_service, ctx->request_url, false);
-
+  SetRequestFirstParty(proxy_service, *ctx);
   return net::OK;
 }
 
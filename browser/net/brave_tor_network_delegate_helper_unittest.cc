@@ -4,13 +4,16 @@
 
 #include "brave/browser/net/brave_tor_network_delegate_helper.h"
 
+#include "base/bind.h"
 #include "base/files/file_path.h"
 #include "base/files/scoped_temp_dir.h"
+#include "base/run_loop.h"
 #include "brave/browser/net/url_context.h"
 #include "brave/browser/profiles/brave_profile_manager.h"
 #include "brave/browser/profiles/tor_unittest_profile_manager.h"
 #include "brave/browser/renderer_host/brave_navigation_ui_data.h"
 #include "brave/browser/tor/mock_tor_profile_service_factory.h"
+#include "brave/browser/tor/mock_tor_profile_service_impl.h"
 #include "brave/common/tor/tor_test_constants.h"
 #include "chrome/test/base/chrome_render_view_host_test_harness.h"
 #include "chrome/test/base/scoped_testing_local_state.h"
@@ -183,3 +186,104 @@ TEST_F(BraveTorNetworkDelegateHelperTest, TorProfileBlockFile) {
   EXPECT_TRUE(before_url_context->new_url_spec.empty());
   EXPECT_EQ(ret, net::ERR_DISALLOWED_URL_SCHEME);
 }
+
+TEST_F(BraveTorNetworkDelegateHelperTest, TorProfileWaitsForCircuit) {
+  ProfileManager* profile_manager = g_browser_process->profile_manager();
+  base::FilePath tor_path = BraveProfileManager::GetTorProfilePath();
+
+  Profile* profile = profile_manager->GetProfile(tor_path);
+  ASSERT_TRUE(profile);
+  auto* tor_profile_service = static_cast<tor::MockTorProfileServiceImpl*>(
+      MockTorProfileServiceFactory::GetForProfile(profile));
+  tor_profile_service->SetTorConnectedForTesting(false);
+  content::RunAllTasksUntilIdle();
+
+  net::TestDelegate test_delegate;
+  GURL url("https://check.torproject.org/");
+  std::unique_ptr<net::URLRequest> request =
+      context()->CreateRequest(url, net::IDLE, &test_delegate,
+                             TRAFFIC_ANNOTATION_FOR_TESTS);
+  std::shared_ptr<brave::BraveRequestInfo>
+      before_url_context(new brave::BraveRequestInfo());
+  brave::BraveRequestInfo::FillCTXFromRequest(request.get(), before_url_context);
+  int continued = 0;
+  brave::ResponseCallback callback =
+      base::Bind([](int* continued) { ++*continued; }, &continued);
+
+  std::unique_ptr<BraveNavigationUIData> navigation_ui_data =
+    std::make_unique<BraveNavigationUIData>();
+  BraveNavigationUIData* navigation_ui_data_ptr = navigation_ui_data.get();
+  content::ResourceRequestInfo::AllocateForTesting(
+    request.get(), content::RESOURCE_TYPE_MAIN_FRAME, resource_context(),
+    kRenderProcessId, /*render_view_id=*/-1, kRenderFrameId,
+    /*is_main_frame=*/true, /*allow_download=*/false, /*is_async=*/true,
+    content::PREVIEWS_OFF, std::move(navigation_ui_data));
+
+  MockTorProfileServiceFactory::SetTorNavigationUIData(profile,
+                                                   navigation_ui_data_ptr);
+  EXPECT_EQ(net::ERR_IO_PENDING,
+            brave::OnBeforeURLRequest_TorWork(callback, before_url_context));
+  // the proxy is already set up for when the circuit is there
+  auto* proxy_service = request->context()->proxy_resolution_service();
+  ASSERT_TRUE(proxy_service->config());
+  EXPECT_FALSE(proxy_service->config()->value().proxy_rules().empty());
+
+  // losing a circuit that never came doesn't let the request go
+  tor_profile_service->SetTorConnectedForTesting(false);
+  content::RunAllTasksUntilIdle();
+  EXPECT_EQ(0, continued);
+
+  tor_profile_service->SetTorConnectedForTesting(true);
+  content::RunAllTasksUntilIdle();
+  EXPECT_EQ(1, continued);
+  EXPECT_EQ(net::OK, before_url_context->pending_error);
+
+  // once connected requests go on right away and only once
+  EXPECT_EQ(net::OK,
+            brave::OnBeforeURLRequest_TorWork(callback, before_url_context));
+  tor_profile_service->SetTorConnectedForTesting(true);
+  content::RunAllTasksUntilIdle();
+  EXPECT_EQ(1, continued);
+}
+
+TEST_F(BraveTorNetworkDelegateHelperTest, TorProfileCircuitTimesOut) {
+  ProfileManager* profile_manager = g_browser_process->profile_manager();
+  base::FilePath tor_path = BraveProfileManager::GetTorProfilePath();
+
+  Profile* profile = profile_manager->GetProfile(tor_path);
+  ASSERT_TRUE(profile);
+  auto* tor_profile_service = static_cast<tor::MockTorProfileServiceImpl*>(
+      MockTorProfileServiceFactory::GetForProfile(profile));
+  tor_profile_service->SetTorConnectedForTesting(false);
+  tor_profile_service->SetTorConnectTimeoutForTesting(
+      base::TimeDelta::FromMilliseconds(10));
+  content::RunAllTasksUntilIdle();
+
+  net::TestDelegate test_delegate;
+  GURL url("https://check.torproject.org/");
+  std::unique_ptr<net::URLRequest> request =
+      context()->CreateRequest(url, net::IDLE, &test_delegate,
+                             TRAFFIC_ANNOTATION_FOR_TESTS);
+  std::shared_ptr<brave::BraveRequestInfo>
+      before_url_context(new brave::BraveRequestInfo());
+  brave::BraveRequestInfo::FillCTXFromRequest(request.get(), before_url_context);
+  base::RunLoop run_loop;
+  brave::ResponseCallback callback = run_loop.QuitClosure();
+
+  std::unique_ptr<BraveNavigationUIData> navigation_ui_data =
+    std::make_unique<BraveNavigationUIData>();
+  BraveNavigationUIData* navigation_ui_data_ptr = navigation_ui_data.get();
+  content::ResourceRequestInfo::AllocateForTesting(
+    request.get(), content::RESOURCE_TYPE_MAIN_FRAME, resource_context(),
+    kRenderProcessId, /*render_view_id=*/-1, kRenderFrameId,
+    /*is_main_frame=*/true, /*allow_download=*/false, /*is_async=*/true,
+    content::PREVIEWS_OFF, std::move(navigation_ui_data));
+
+  MockTorProfileServiceFactory::SetTorNavigationUIData(profile,
+                                                   navigation_ui_data_ptr);
+  EXPECT_EQ(net::ERR_IO_PENDING,
+            brave::OnBeforeURLRequest_TorWork(callback, before_url_context));
+  run_loop.Run();
+  EXPECT_EQ(net::ERR_TUNNEL_CONNECTION_FAILED,
+            before_url_context->pending_error);
+}
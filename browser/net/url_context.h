@@ -10,6 +10,7 @@
 
 #include "chrome/browser/net/chrome_network_delegate.h"
 #include "content/public/common/resource_type.h"
+#include "net/base/net_errors.h"
 #include "net/url_request/url_request.h"
 #include "url/gurl.h"
 
@@ -71,6 +72,9 @@ struct BraveRequestInfo {
   BraveNetworkDelegateEventType event_type = kUnknownEventType;
   const base::ListValue* referral_headers_list = nullptr;
   BlockedBy blocked_by = kNotBlocked;
+  // Set by a callback that returned ERR_IO_PENDING to fail the request when
+  // it runs |next_callback|.
+  int pending_error = net::OK;
   // Default to invalid type for resource_type, so delegate helpers
   // can properly detect that the info couldn't be obtained.
   content::ResourceType resource_type = content::RESOURCE_TYPE_LAST_TYPE;
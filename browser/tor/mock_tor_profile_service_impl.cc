@@ -17,7 +17,9 @@ using tor::TorProxyConfigService;
 namespace tor {
 
 MockTorProfileServiceImpl::MockTorProfileServiceImpl(Profile* profile) :
-    profile_(profile) {
+    TorProfileService(true),
+    profile_(profile),
+    tor_connected_(true) {
   base::FilePath path(kTestTorPath);
   std::string proxy(kTestTorProxy);
   config_ = TorConfig(path, proxy);
@@ -39,6 +41,10 @@ const TorConfig& MockTorProfileServiceImpl::GetTorConfig() {
 
 int64_t MockTorProfileServiceImpl::GetTorPid() { return -1; }
 
+bool MockTorProfileServiceImpl::IsTorConnected() {
+  return tor_connected_;
+}
+
 void MockTorProfileServiceImpl::SetProxy(
     net::ProxyResolutionService* service, const GURL& request_url,
     bool new_circuit) {
@@ -47,7 +53,12 @@ void MockTorProfileServiceImpl::SetProxy(
   if (url.host().empty() || config_.empty())
     return;
   TorProxyConfigService::TorSetProxy(service, config_.proxy_string(),
-                                     url.host(), nullptr, new_circuit);
+                                     nullptr);
+}
+
+void MockTorProfileServiceImpl::SetTorConnectedForTesting(bool connected) {
+  tor_connected_ = connected;
+  SetTorConnected(connected);
 }
 
 }  // namespace tor
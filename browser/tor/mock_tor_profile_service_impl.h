@@ -22,13 +22,19 @@ class MockTorProfileServiceImpl : public TorProfileService {
   void SetNewTorCircuit(const GURL& request_url, const base::Closure&) override;
   const TorConfig& GetTorConfig() override;
   int64_t GetTorPid() override;
+  bool IsTorConnected() override;
 
   void SetProxy(net::ProxyResolutionService*, const GURL& request_url,
                 bool new_circuit) override;
 
+  // Tor counts as connected until told otherwise. The change reaches
+  // WaitForTorConnected once the IO thread ran.
+  void SetTorConnectedForTesting(bool connected);
+
  private:
   Profile* profile_;  // NOT OWNED
   TorConfig config_;
+  bool tor_connected_;
   DISALLOW_COPY_AND_ASSIGN(MockTorProfileServiceImpl);
 };
 
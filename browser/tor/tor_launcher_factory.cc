@@ -7,6 +7,7 @@
 #include "brave/browser/tor/tor_profile_service_impl.h"
 #include "content/public/browser/browser_thread.h"
 #include "content/public/common/service_manager_connection.h"
+#include "mojo/public/cpp/bindings/interface_request.h"
 #include "services/service_manager/public/cpp/connector.h"
 
 using content::BrowserThread;
@@ -21,7 +22,10 @@ TorLauncherFactory* TorLauncherFactory::GetInstance() {
 }
 
 TorLauncherFactory::TorLauncherFactory()
-    : tor_pid_(-1) {
+    : observer_binding_(this),
+      tor_pid_(-1),
+      bootstrap_progress_(0),
+      circuit_established_(false) {
   if (g_prevent_tor_launch_for_tests) {
     VLOG(1) << "Skipping the tor process launch in tests.";
     return;
@@ -38,6 +42,10 @@ TorLauncherFactory::TorLauncherFactory()
   tor_launcher_->SetCrashHandler(base::Bind(
                         &TorLauncherFactory::OnTorCrashed,
                         base::Unretained(this)));
+
+  tor::mojom::TorLauncherObserverPtr observer;
+  observer_binding_.Bind(mojo::MakeRequest(&observer));
+  tor_launcher_->SetObserver(std::move(observer));
 }
 
 TorLauncherFactory::~TorLauncherFactory() {}
@@ -85,6 +93,8 @@ void TorLauncherFactory::ReLaunchTorProcess(const tor::TorConfig& config) {
     LOG(WARNING) << "config is empty.";
     return;
   }
+  bootstrap_progress_ = 0;
+  circuit_established_ = false;
   tor_launcher_->ReLaunch(config_,
                         base::Bind(&TorLauncherFactory::OnTorLaunched,
                                    base::Unretained(this)));
@@ -92,6 +102,12 @@ void TorLauncherFactory::ReLaunchTorProcess(const tor::TorConfig& config) {
 
 void TorLauncherFactory::KillTorProcess() {
   tor_launcher_.reset();
+  bootstrap_progress_ = 0;
+  if (!circuit_established_)
+    return;
+  circuit_established_ = false;
+  for (auto& observer : observers_)
+    observer.NotifyTorCircuitEstablished(false);
 }
 
 void TorLauncherFactory::AddObserver(tor::TorProfileServiceImpl* service) {
@@ -104,12 +120,16 @@ void TorLauncherFactory::RemoveObserver(tor::TorProfileServiceImpl* service) {
 
 void TorLauncherFactory::OnTorLauncherCrashed() {
   LOG(ERROR) << "Tor Launcher Crashed";
+  bootstrap_progress_ = 0;
+  circuit_established_ = false;
   for (auto& observer : observers_)
     observer.NotifyTorLauncherCrashed();
 }
 
 void TorLauncherFactory::OnTorCrashed(int64_t pid) {
   LOG(ERROR) << "Tor Process(" << pid << ") Crashed";
+  bootstrap_progress_ = 0;
+  circuit_established_ = false;
   for (auto& observer : observers_)
     observer.NotifyTorCrashed(pid);
 }
@@ -123,6 +143,20 @@ void TorLauncherFactory::OnTorLaunched(bool result, int64_t pid) {
     observer.NotifyTorLaunched(result, pid);
 }
 
+void TorLauncherFactory::OnTorBootstrapProgress(int32_t progress,
+                                                const std::string& summary) {
+  VLOG(1) << "Tor bootstrapped " << progress << "%: " << summary;
+  bootstrap_progress_ = progress;
+  for (auto& observer : observers_)
+    observer.NotifyTorBootstrapProgress(progress, summary);
+}
+
+void TorLauncherFactory::OnTorCircuitEstablished(bool result) {
+  circuit_established_ = result;
+  for (auto& observer : observers_)
+    observer.NotifyTorCircuitEstablished(result);
+}
+
 ScopedTorLaunchPreventerForTest::ScopedTorLaunchPreventerForTest() {
   g_prevent_tor_launch_for_tests = true;
 }
@@ -11,12 +11,13 @@
 #include "base/observer_list.h"
 #include "brave/common/tor/tor_common.h"
 #include "brave/common/tor/tor_launcher.mojom.h"
+#include "mojo/public/cpp/bindings/binding.h"
 
 namespace tor {
 class TorProfileServiceImpl;
 }
 
-class TorLauncherFactory {
+class TorLauncherFactory : public tor::mojom::TorLauncherObserver {
  public:
   static TorLauncherFactory* GetInstance();
 
@@ -25,6 +26,10 @@ class TorLauncherFactory {
   void KillTorProcess();
   const tor::TorConfig& GetTorConfig() const { return config_; }
   int64_t GetTorPid() const { return tor_pid_; }
+  // Whether the running tor finished bootstrapping and has a circuit.
+  bool IsTorConnected() const {
+    return bootstrap_progress_ == 100 && circuit_established_;
+  }
 
   void AddObserver(tor::TorProfileServiceImpl* serice);
   void RemoveObserver(tor::TorProfileServiceImpl* service);
@@ -32,7 +37,12 @@ class TorLauncherFactory {
   friend struct base::DefaultSingletonTraits<TorLauncherFactory>;
 
   TorLauncherFactory();
-  ~TorLauncherFactory();
+  ~TorLauncherFactory() override;
+
+  // tor::mojom::TorLauncherObserver:
+  void OnTorBootstrapProgress(int32_t progress,
+                              const std::string& summary) override;
+  void OnTorCircuitEstablished(bool result) override;
 
   bool SetConfig(const tor::TorConfig& config);
 
@@ -42,7 +52,11 @@ class TorLauncherFactory {
 
   tor::mojom::TorLauncherPtr tor_launcher_;
 
+  mojo::Binding<tor::mojom::TorLauncherObserver> observer_binding_;
+
   int64_t tor_pid_;
+  int bootstrap_progress_;
+  bool circuit_established_;
 
   tor::TorConfig config_;
 
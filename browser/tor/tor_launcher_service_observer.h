@@ -5,6 +5,8 @@
 #ifndef BRAVE_BROWSER_TOR_TOR_LAUNCHER_SERVICE_OBSERVER_H_
 #define BRAVE_BROWSER_TOR_TOR_LAUNCHER_SERVICE_OBSERVER_H_
 
+#include <string>
+
 namespace tor {
 
 class TorLauncherServiceObserver : public base::CheckedObserver {
@@ -14,6 +16,10 @@ class TorLauncherServiceObserver : public base::CheckedObserver {
   virtual void OnTorLauncherCrashed() {};
   virtual void OnTorCrashed(int64_t pid) {};
   virtual void OnTorLaunched(bool result, int64_t pid) {};
+  // Progress of tor connecting to the Tor network, in percent.
+  virtual void OnTorBootstrapProgress(int progress,
+                                      const std::string& summary) {};
+  virtual void OnTorCircuitEstablished(bool result) {};
 };
 
 }  // namespace tor
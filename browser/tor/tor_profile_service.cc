@@ -4,20 +4,105 @@
 
 #include "brave/browser/tor/tor_profile_service.h"
 
+#include <map>
+#include <utility>
+
+#include "base/bind.h"
+#include "base/memory/ref_counted.h"
+#include "base/task/post_task.h"
 #include "brave/browser/tor/tor_launcher_service_observer.h"
 #include "brave/common/tor/pref_names.h"
 #include "chrome/common/channel_info.h"
 #include "components/prefs/pref_registry_simple.h"
 #include "components/pref_registry/pref_registry_syncable.h"
 #include "components/version_info/channel.h"
+#include "content/public/browser/browser_task_traits.h"
+#include "content/public/browser/browser_thread.h"
+
+using content::BrowserThread;
 
 
 namespace tor {
 
-TorProfileService::TorProfileService() {
+namespace {
+
+// A cold start of tor can take a minute or more before the first circuit.
+constexpr base::TimeDelta kTorConnectTimeout = base::TimeDelta::FromMinutes(2);
+
+}  // namespace
+
+// Whether tor can carry requests, and the requests waiting until it can.
+// Requests still waiting when the profile goes away are dropped with it.
+class TorProfileService::ConnectionState
+    : public base::RefCountedThreadSafe<ConnectionState,
+                                        BrowserThread::DeleteOnIOThread> {
+ public:
+  explicit ConnectionState(bool connected)
+      : connected_(connected), timeout_(kTorConnectTimeout), next_id_(0) {}
+
+  bool Wait(base::OnceCallback<void(bool)> callback) {
+    DCHECK_CURRENTLY_ON(BrowserThread::IO);
+    if (connected_)
+      return true;
+    const int id = next_id_++;
+    callbacks_[id] = std::move(callback);
+    base::PostDelayedTaskWithTraits(
+        FROM_HERE, {BrowserThread::IO},
+        base::BindOnce(&ConnectionState::OnTimeout, this, id), timeout_);
+    return false;
+  }
+
+  void SetConnected(bool connected) {
+    DCHECK_CURRENTLY_ON(BrowserThread::IO);
+    connected_ = connected;
+    if (!connected)
+      return;
+    std::map<int, base::OnceCallback<void(bool)>> callbacks;
+    callbacks.swap(callbacks_);
+    for (auto& callback : callbacks)
+      std::move(callback.second).Run(true);
+  }
+
+  void Shutdown() {
+    DCHECK_CURRENTLY_ON(BrowserThread::IO);
+    callbacks_.clear();
+  }
+
+  void set_timeout(base::TimeDelta timeout) { timeout_ = timeout; }
+
+ private:
+  friend struct BrowserThread::DeleteOnThread<BrowserThread::IO>;
+  friend class base::DeleteHelper<ConnectionState>;
+  ~ConnectionState() {}
+
+  void OnTimeout(int id) {
+    auto it = callbacks_.find(id);
+    if (it == callbacks_.end())
+      return;
+    auto callback = std::move(it->second);
+    callbacks_.erase(it);
+    std::move(callback).Run(false);
+  }
+
+  bool connected_;
+  base::TimeDelta timeout_;
+  int next_id_;
+  std::map<int, base::OnceCallback<void(bool)>> callbacks_;
+
+  DISALLOW_COPY_AND_ASSIGN(ConnectionState);
+};
+
+TorProfileService::TorProfileService() : TorProfileService(false) {
+}
+
+TorProfileService::TorProfileService(bool tor_connected)
+    : connection_state_(new ConnectionState(tor_connected)) {
 }
 
 TorProfileService::~TorProfileService() {
+  base::PostTaskWithTraits(
+      FROM_HERE, {BrowserThread::IO},
+      base::BindOnce(&ConnectionState::Shutdown, connection_state_));
 }
 
 // static
@@ -51,6 +136,23 @@ void TorProfileService::RegisterLocalStatePrefs(PrefRegistrySimple* registry) {
   }
 }
 
+bool TorProfileService::WaitForTorConnected(
+    base::OnceCallback<void(bool)> callback) {
+  return connection_state_->Wait(std::move(callback));
+}
+
+void TorProfileService::SetTorConnectTimeoutForTesting(
+    base::TimeDelta timeout) {
+  connection_state_->set_timeout(timeout);
+}
+
+void TorProfileService::SetTorConnected(bool connected) {
+  base::PostTaskWithTraits(
+      FROM_HERE, {BrowserThread::IO},
+      base::BindOnce(&ConnectionState::SetConnected, connection_state_,
+                     connected));
+}
+
 void TorProfileService::AddObserver(TorLauncherServiceObserver* observer) {
   observers_.AddObserver(observer);
 }
@@ -5,8 +5,11 @@
 #ifndef BRAVE_BROWSER_TOR_TOR_PROFILE_SERVICE_
 #define BRAVE_BROWSER_TOR_TOR_PROFILE_SERVICE_
 
+#include "base/callback.h"
 #include "base/macros.h"
+#include "base/memory/scoped_refptr.h"
 #include "base/observer_list.h"
+#include "base/time/time.h"
 #include "brave/common/tor/tor_common.h"
 #include "components/keyed_service/core/keyed_service.h"
 #include "url/gurl.h"
@@ -39,17 +42,37 @@ class TorProfileService : public KeyedService {
                                 const base::Closure&) = 0;
   virtual const TorConfig& GetTorConfig() = 0;
   virtual int64_t GetTorPid() = 0;
+  // Whether tor finished bootstrapping and can carry requests.
+  virtual bool IsTorConnected() = 0;
 
   virtual void SetProxy(net::ProxyResolutionService*, const GURL& request_url,
                         bool new_circuit) = 0;
 
+  // Returns true if tor can carry requests. Otherwise returns false and runs
+  // |callback| with true once it can, or with false if it still can't after
+  // a while. Only used on the IO thread.
+  bool WaitForTorConnected(base::OnceCallback<void(bool)> callback);
+  void SetTorConnectTimeoutForTesting(base::TimeDelta timeout);
+
   void AddObserver(TorLauncherServiceObserver* observer);
   void RemoveObserver(TorLauncherServiceObserver* observer);
 
  protected:
+  // |tor_connected| is what WaitForTorConnected goes by until the first
+  // SetTorConnected reached the IO thread.
+  explicit TorProfileService(bool tor_connected);
+
+  // Passes a change of IsTorConnected on to the IO thread.
+  void SetTorConnected(bool connected);
+
   base::ObserverList<TorLauncherServiceObserver> observers_;
 
  private:
+  class ConnectionState;
+
+  // Owned by the IO thread, tasks posted there keep it alive.
+  scoped_refptr<ConnectionState> connection_state_;
+
   DISALLOW_COPY_AND_ASSIGN(TorProfileService);
 };
 
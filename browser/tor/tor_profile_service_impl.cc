@@ -22,10 +22,57 @@ using content::SiteInstance;
 
 namespace tor {
 
+TorProfileServiceImpl::IOState::IOState() {
+}
+
+TorProfileServiceImpl::IOState::~IOState() {
+}
+
+void TorProfileServiceImpl::IOState::SetProxy(
+    net::ProxyResolutionService* service,
+    const std::string& tor_proxy,
+    const std::string& new_circuit_host) {
+  DCHECK_CURRENTLY_ON(BrowserThread::IO);
+  // the site's next request picks a new password, which gets a new circuit
+  if (!new_circuit_host.empty())
+    tor_proxy_map_.Erase(new_circuit_host);
+  SetProxyConfig(service, tor_proxy);
+}
+
+void TorProfileServiceImpl::IOState::SetNewTorCircuit(
+    const scoped_refptr<net::URLRequestContextGetter>& getter,
+    const std::string& tor_proxy,
+    const std::string& host) {
+  DCHECK_CURRENTLY_ON(BrowserThread::IO);
+  if (tor_proxy.empty())
+    return;
+  auto* proxy_resolution_service =
+    getter->GetURLRequestContext()->proxy_resolution_service();
+  DCHECK(proxy_resolution_service);
+  SetProxy(proxy_resolution_service, tor_proxy, host);
+}
+
+void TorProfileServiceImpl::IOState::SetProxyConfig(
+    net::ProxyResolutionService* service,
+    const std::string& tor_proxy) {
+  if (tor_proxy != tor_proxy_) {
+    tor_proxy_ = tor_proxy;
+    tor_proxy_rules_.ParseFromString(tor_proxy);
+  }
+  // Only TorSetProxy sets these rules. Until the service fetched its config
+  // the first time there is nothing to compare, so it may be set again.
+  if (service->config() &&
+      service->config()->value().proxy_rules().Equals(tor_proxy_rules_))
+    return;
+  TorProxyConfigService::TorSetProxy(service, tor_proxy, &tor_proxy_map_);
+}
+
 TorProfileServiceImpl::TorProfileServiceImpl(Profile* profile) :
-    profile_(profile) {
+    profile_(profile),
+    io_state_(new IOState) {
   tor_launcher_factory_ = TorLauncherFactory::GetInstance();
   tor_launcher_factory_->AddObserver(this);
+  UpdateTorConnected();
 }
 
 TorProfileServiceImpl::~TorProfileServiceImpl() {
@@ -44,24 +91,10 @@ void TorProfileServiceImpl::ReLaunchTor(const TorConfig& config) {
   tor_launcher_factory_->ReLaunchTorProcess(config);
 }
 
-void TorProfileServiceImpl::SetNewTorCircuitOnIOThread(
-    const scoped_refptr<net::URLRequestContextGetter>& getter,
-    std::string host) {
-  DCHECK_CURRENTLY_ON(BrowserThread::IO);
-  const TorConfig tor_config = tor_launcher_factory_->GetTorConfig();
-  if (tor_config.empty())
-    return;
-  auto* proxy_resolution_service =
-    getter->GetURLRequestContext()->proxy_resolution_service();
-  DCHECK(proxy_resolution_service);
-  TorProxyConfigService::TorSetProxy(proxy_resolution_service,
-                                     tor_config.proxy_string(),
-                                     host,
-                                     &tor_proxy_map_,
-                                     true);
+void TorProfileServiceImpl::UpdateTorConnected() {
+  SetTorConnected(tor_launcher_factory_->IsTorConnected());
 }
 
-
 void TorProfileServiceImpl::SetNewTorCircuit(const GURL& request_url,
                                              const base::Closure& callback) {
   GURL url = SiteInstance::GetSiteForURL(profile_, request_url);
@@ -76,9 +109,9 @@ void TorProfileServiceImpl::SetNewTorCircuit(const GURL& request_url,
 
   base::PostTaskWithTraitsAndReply(
       FROM_HERE, {BrowserThread::IO},
-      base::Bind(&TorProfileServiceImpl::SetNewTorCircuitOnIOThread,
-                 base::Unretained(this),
+      base::Bind(&IOState::SetNewTorCircuit, io_state_,
                  base::WrapRefCounted(url_request_context_getter),
+                 tor_launcher_factory_->GetTorConfig().proxy_string(),
                  url.host()),
     callback);
 
@@ -92,17 +125,24 @@ int64_t TorProfileServiceImpl::GetTorPid() {
   return tor_launcher_factory_->GetTorPid();
 }
 
+bool TorProfileServiceImpl::IsTorConnected() {
+  return tor_launcher_factory_->IsTorConnected();
+}
+
 void TorProfileServiceImpl::SetProxy(net::ProxyResolutionService* service,
                                      const GURL& request_url,bool new_circuit) {
   DCHECK_CURRENTLY_ON(BrowserThread::IO);
   const TorConfig tor_config = tor_launcher_factory_->GetTorConfig();
-  GURL url = SiteInstance::GetSiteForURL(profile_, request_url);
-  if (url.host().empty() || tor_config.empty())
+  if (!service || tor_config.empty())
     return;
-  base::PostTaskWithTraits(FROM_HERE, {BrowserThread::IO},
-      base::Bind(&TorProxyConfigService::TorSetProxy,
-      service, tor_config.proxy_string(),
-      url.host(), &tor_proxy_map_, new_circuit));
+  std::string new_circuit_host;
+  if (new_circuit) {
+    GURL url = SiteInstance::GetSiteForURL(profile_, request_url);
+    new_circuit_host = url.host();
+  }
+  // Runs for every request of the profile: the config is only set once, the
+  // per-site credentials are added when the request is resolved.
+  io_state_->SetProxy(service, tor_config.proxy_string(), new_circuit_host);
 }
 
 void TorProfileServiceImpl::KillTor() {
@@ -112,11 +152,13 @@ void TorProfileServiceImpl::KillTor() {
 void TorProfileServiceImpl::NotifyTorLauncherCrashed() {
   for (auto& observer : observers_)
     observer.OnTorLauncherCrashed();
+  UpdateTorConnected();
 }
 
 void TorProfileServiceImpl::NotifyTorCrashed(int64_t pid) {
   for (auto& observer : observers_)
     observer.OnTorCrashed(pid);
+  UpdateTorConnected();
 }
 
 void TorProfileServiceImpl::NotifyTorLaunched(bool result, int64_t pid) {
@@ -124,5 +166,18 @@ void TorProfileServiceImpl::NotifyTorLaunched(bool result, int64_t pid) {
     observer.OnTorLaunched(result, pid);
 }
 
+void TorProfileServiceImpl::NotifyTorBootstrapProgress(
+    int progress, const std::string& summary) {
+  for (auto& observer : observers_)
+    observer.OnTorBootstrapProgress(progress, summary);
+  UpdateTorConnected();
+}
+
+void TorProfileServiceImpl::NotifyTorCircuitEstablished(bool result) {
+  for (auto& observer : observers_)
+    observer.OnTorCircuitEstablished(result);
+  UpdateTorConnected();
+}
+
 
 }  // namespace tor
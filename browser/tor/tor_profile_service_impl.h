@@ -7,9 +7,12 @@
 
 #include "brave/browser/tor/tor_profile_service.h"
 
-#include "base/memory/scoped_refptr.h"
+#include <string>
+
+#include "base/memory/ref_counted.h"
 #include "brave/browser/tor/tor_launcher_factory.h"
 #include "brave/browser/tor/tor_proxy_config_service.h"
+#include "content/public/browser/browser_thread.h"
 
 class Profile;
 
@@ -34,6 +37,7 @@ class TorProfileServiceImpl : public TorProfileService,
   void SetNewTorCircuit(const GURL& request_url, const base::Closure&) override;
   const TorConfig& GetTorConfig() override;
   int64_t GetTorPid() override;
+  bool IsTorConnected() override;
 
   void SetProxy(net::ProxyResolutionService*, const GURL& request_url,
                 bool new_circuit) override;
@@ -44,14 +48,49 @@ class TorProfileServiceImpl : public TorProfileService,
   void NotifyTorLauncherCrashed();
   void NotifyTorCrashed(int64_t pid);
   void NotifyTorLaunched(bool result, int64_t pid);
+  void NotifyTorBootstrapProgress(int progress, const std::string& summary);
+  void NotifyTorCircuitEstablished(bool result);
  private:
-
-  void SetNewTorCircuitOnIOThread(
-      const scoped_refptr<net::URLRequestContextGetter>&, std::string);
+  // The proxy state used on the IO thread. Tasks posted there keep it alive,
+  // so they may outlive the service.
+  class IOState : public base::RefCountedThreadSafe<
+                      IOState, content::BrowserThread::DeleteOnIOThread> {
+   public:
+    IOState();
+
+    // Sets |tor_proxy| on |service|. If |new_circuit_host| isn't empty, the
+    // site's next request gets a new circuit.
+    void SetProxy(net::ProxyResolutionService* service,
+                  const std::string& tor_proxy,
+                  const std::string& new_circuit_host);
+    void SetNewTorCircuit(const scoped_refptr<net::URLRequestContextGetter>&,
+                          const std::string& tor_proxy,
+                          const std::string& host);
+
+   private:
+    friend struct content::BrowserThread::DeleteOnThread<
+        content::BrowserThread::IO>;
+    friend class base::DeleteHelper<IOState>;
+    ~IOState();
+
+    // Sets the tor config on |service| unless it already uses |tor_proxy|.
+    void SetProxyConfig(net::ProxyResolutionService* service,
+                        const std::string& tor_proxy);
+
+    TorProxyConfigService::TorProxyMap tor_proxy_map_;
+    // The last tor proxy set and its parsed rules.
+    std::string tor_proxy_;
+    net::ProxyConfig::ProxyRules tor_proxy_rules_;
+
+    DISALLOW_COPY_AND_ASSIGN(IOState);
+  };
+
+  // Passes IsTorConnected on to the IO thread.
+  void UpdateTorConnected();
 
   Profile* profile_;  // NOT OWNED
   TorLauncherFactory* tor_launcher_factory_; // Singleton
-  TorProxyConfigService::TorProxyMap tor_proxy_map_;
+  scoped_refptr<IOState> io_state_;
   DISALLOW_COPY_AND_ASSIGN(TorProfileServiceImpl);
 };
 
@@ -10,14 +10,19 @@
 #include <utility>
 #include <vector>
 
+#include "base/no_destructor.h"
 #include "base/time/time.h"
 #include "base/values.h"
 #include "base/strings/string_number_conversions.h"
 #include "base/strings/string_util.h"
 #include "content/public/browser/browser_thread.h"
 #include "crypto/random.h"
+#include "net/base/host_port_pair.h"
+#include "net/base/registry_controlled_domains/registry_controlled_domain.h"
+#include "net/proxy_resolution/proxy_info.h"
 #include "net/proxy_resolution/proxy_resolution_service.h"
 #include "net/url_request/url_request_context.h"
+#include "url/gurl.h"
 #include "url/third_party/mozilla/url_parse.h"
 
 namespace tor {
@@ -26,10 +31,43 @@ using content::BrowserThread;
 const int kTorPasswordLength = 16;
 // Default tor circuit life time is 10 minutes
 constexpr base::TimeDelta kTenMins = base::TimeDelta::FromMinutes(10);
+// How long the first party noted for a request is kept for it to be
+// resolved. Also how often expired ones are dropped.
+constexpr base::TimeDelta kFirstPartyLifetime = base::TimeDelta::FromMinutes(1);
+
+namespace {
+
+// The tor config services set by TorSetProxy, by the service they are set
+// on. Only used on the IO thread.
+std::map<net::ProxyResolutionService*, TorProxyConfigService*>&
+TorProxyConfigServices() {
+  static base::NoDestructor<
+      std::map<net::ProxyResolutionService*, TorProxyConfigService*>>
+      services;
+  return *services;
+}
+
+// Requests are resolved for their URL without the fragment.
+GURL StripRef(const GURL& url) {
+  GURL::Replacements replacements;
+  replacements.ClearRef();
+  return url.ReplaceComponents(replacements);
+}
+
+// A SOCKS username no other request uses, so tor gives the request a
+// circuit of its own.
+std::string GenerateIsolatedUsername() {
+  std::vector<uint8_t> tag(kTorPasswordLength);
+  crypto::RandBytes(tag.data(), tag.size());
+  return base::HexEncode(tag.data(), tag.size());
+}
+
+}  // namespace
 
 TorProxyConfigService::TorProxyConfigService(
-  const std::string& tor_proxy, const std::string& username,
-  TorProxyMap* tor_proxy_map) {
+  const std::string& tor_proxy, TorProxyMap* tor_proxy_map)
+    : tor_proxy_map_(tor_proxy_map),
+      proxy_resolution_service_(nullptr) {
     if (tor_proxy.length()) {
       url::Parsed url;
       url::ParseStandardURL(
@@ -48,35 +86,91 @@ TorProxyConfigService::TorProxyConfigService(
       }
       if (scheme_.empty() || host_.empty() || port_.empty())
         return;
-      std::string proxy_url;
-      if (tor_proxy_map && !username.empty()) {
-        std::string password = tor_proxy_map->Get(username);
-        proxy_url = std::string(scheme_ + "://" + username + ":" + password +
-                                "@" + host_ + ":" + port_);
-      } else {
-        proxy_url = std::string(scheme_ + "://" + host_ + ":" + port_);
-      }
+      std::string proxy_url =
+        std::string(scheme_ + "://" + host_ + ":" + port_);
       config_.proxy_rules().ParseFromString(proxy_url);
+      if (!config_.proxy_rules().single_proxies.IsEmpty())
+        proxy_server_ = config_.proxy_rules().single_proxies.Get();
     }
 }
 
-TorProxyConfigService::~TorProxyConfigService() {}
+TorProxyConfigService::~TorProxyConfigService() {
+  auto it = TorProxyConfigServices().find(proxy_resolution_service_);
+  if (it != TorProxyConfigServices().end() && it->second == this)
+    TorProxyConfigServices().erase(it);
+}
 
 // static
 void TorProxyConfigService::TorSetProxy(
     net::ProxyResolutionService* service,
-    std::string tor_proxy,
-    std::string site_url,
-    TorProxyMap* tor_proxy_map,
-    bool new_password) {
+    const std::string& tor_proxy,
+    TorProxyMap* tor_proxy_map) {
   DCHECK_CURRENTLY_ON(BrowserThread::IO);
   if (!service)
     return;
-  if (new_password && tor_proxy_map)
-    tor_proxy_map->Erase(site_url);
   std::unique_ptr<TorProxyConfigService>
-    config(new TorProxyConfigService(tor_proxy, site_url, tor_proxy_map));
+    config(new TorProxyConfigService(tor_proxy, tor_proxy_map));
+  // The delegate is the config service, which the service owns. The old one
+  // is unset before ResetConfigService destroys it.
+  TorProxyConfigService* tor_config = config.get();
+  tor_config->proxy_resolution_service_ = service;
+  service->SetProxyDelegate(nullptr);
   service->ResetConfigService(std::move(config));
+  service->SetProxyDelegate(tor_config);
+  TorProxyConfigServices()[service] = tor_config;
+}
+
+// static
+void TorProxyConfigService::SetRequestFirstParty(
+    net::ProxyResolutionService* service,
+    const GURL& url,
+    const GURL& first_party) {
+  DCHECK_CURRENTLY_ON(BrowserThread::IO);
+  auto it = TorProxyConfigServices().find(service);
+  if (it != TorProxyConfigServices().end())
+    it->second->SetFirstParty(url, first_party);
+}
+
+// static
+std::string TorProxyConfigService::GetCircuitIsolationKey(const GURL& url) {
+  // the host of SiteInstance::GetSiteForURL, which needs the UI thread
+  std::string site = net::registry_controlled_domains::GetDomainAndRegistry(
+      url, net::registry_controlled_domains::INCLUDE_PRIVATE_REGISTRIES);
+  if (site.empty())
+    return url.host();
+  return site;
+}
+
+void TorProxyConfigService::SetFirstParty(const GURL& url,
+                                          const GURL& first_party) {
+  DCHECK_CURRENTLY_ON(BrowserThread::IO);
+  const std::string isolation_key = GetCircuitIsolationKey(first_party);
+  if (isolation_key.empty())
+    return;
+  const base::TimeTicks now = base::TimeTicks::Now();
+  if (now - first_parties_cleared_ >= kFirstPartyLifetime)
+    ClearExpiredFirstParties();
+
+  auto it = first_parties_.find(StripRef(url));
+  if (it == first_parties_.end() ||
+      now - it->second.time >= kFirstPartyLifetime) {
+    first_parties_[StripRef(url)] = {isolation_key, now, false};
+    return;
+  }
+  if (it->second.isolation_key != isolation_key)
+    it->second.conflicted = true;
+  it->second.time = now;
+}
+
+void TorProxyConfigService::ClearExpiredFirstParties() {
+  const base::TimeTicks now = base::TimeTicks::Now();
+  for (auto it = first_parties_.begin(); it != first_parties_.end();) {
+    if (now - it->second.time >= kFirstPartyLifetime)
+      it = first_parties_.erase(it);
+    else
+      ++it;
+  }
+  first_parties_cleared_ = now;
 }
 
 TorProxyConfigService::ConfigAvailability
@@ -88,6 +182,43 @@ TorProxyConfigService::ConfigAvailability
   return CONFIG_VALID;
 }
 
+void TorProxyConfigService::OnResolveProxy(
+    const GURL& url,
+    const std::string& method,
+    const net::ProxyRetryInfoMap& proxy_retry_info,
+    net::ProxyInfo* result) {
+  DCHECK_CURRENTLY_ON(BrowserThread::IO);
+  if (!tor_proxy_map_ || !proxy_server_.is_valid() || result->is_empty() ||
+      !(result->proxy_server() == proxy_server_))
+    return;
+
+  // The URL's own site, unless the page that requested it was noted.
+  std::string username;
+  std::string password;
+  auto first_party = first_parties_.find(StripRef(url));
+  if (first_party != first_parties_.end() &&
+      base::TimeTicks::Now() - first_party->second.time < kFirstPartyLifetime) {
+    if (first_party->second.conflicted) {
+      // Not known which site this request is for, so link it to neither.
+      username = GenerateIsolatedUsername();
+      password = username;
+    } else {
+      username = first_party->second.isolation_key;
+    }
+  } else {
+    username = GetCircuitIsolationKey(url);
+  }
+  if (username.empty())
+    return;
+  if (password.empty())
+    password = tor_proxy_map_->Get(username);
+
+  const net::HostPortPair& proxy = proxy_server_.host_port_pair();
+  result->UseProxyServer(net::ProxyServer(
+      proxy_server_.scheme(),
+      net::HostPortPair(username, password, proxy.host(), proxy.port())));
+}
+
 TorProxyConfigService::TorProxyMap::TorProxyMap() = default;
 TorProxyConfigService::TorProxyMap::~TorProxyMap() {
   timer_.Stop();
@@ -11,17 +11,18 @@
 #include <utility>
 
 #include "base/compiler_specific.h"
+#include "base/time/time.h"
 #include "base/timer/timer.h"
 #include "net/base/net_errors.h"
 #include "net/base/net_export.h"
+#include "net/base/proxy_delegate.h"
+#include "net/base/proxy_server.h"
 #include "net/proxy_resolution/proxy_config.h"
 #include "net/proxy_resolution/proxy_config_service.h"
-
-namespace base {
-class Time;
-}
+#include "url/gurl.h"
 
 namespace net {
+class ProxyInfo;
 class ProxyResolutionService;
 }
 
@@ -30,7 +31,16 @@ namespace tor {
 const char kSocksProxy[] = "socks5";
 
 // Implementation of ProxyConfigService that returns a tor specific result.
-class TorProxyConfigService : public net::ProxyConfigService {
+// The config itself never changes. The per-site SOCKS credentials that keep
+// sites on separate circuits are picked by the ProxyDelegate as each request
+// is resolved, so loading another site doesn't reset the config. Requests
+// are keyed on the site of the page that made them, their first party, so
+// a third party loaded by two sites is reached over two circuits. The first
+// party is noted by URL; while two sites are loading the same URL it can't
+// be told which request is whose, so those requests get a circuit of their
+// own instead.
+class TorProxyConfigService : public net::ProxyConfigService,
+                              public net::ProxyDelegate {
  public:
   // Used to cache <username, password> of proxies
   class TorProxyMap {
@@ -50,17 +60,32 @@ class TorProxyConfigService : public net::ProxyConfigService {
     DISALLOW_COPY_AND_ASSIGN(TorProxyMap);
   };
 
-  explicit TorProxyConfigService(const std::string& tor_proxy,
-                                 const std::string& username,
-                                 TorProxyMap* map);
+  // Credentials are taken from |map|, none are added without one.
+  TorProxyConfigService(const std::string& tor_proxy, TorProxyMap* map);
   ~TorProxyConfigService() override;
 
+  // Makes |service| use |tor_proxy|, with the config service as its
+  // delegate. Only needed once per service and proxy.
   static void TorSetProxy(
     net::ProxyResolutionService* service,
-    std::string tor_proxy,
-    std::string site_url,
-    TorProxyMap* tor_proxy_map,
-    bool new_password);
+    const std::string& tor_proxy,
+    TorProxyMap* tor_proxy_map);
+
+  // Notes that the latest request to |url| on |service| was made by a page
+  // of |first_party|, if |service| has a tor config. Must be called before
+  // the request is resolved.
+  static void SetRequestFirstParty(net::ProxyResolutionService* service,
+                                   const GURL& url,
+                                   const GURL& first_party);
+
+  // The site of |url|, which keys the circuits of the requests its pages
+  // make and is their SOCKS username.
+  static std::string GetCircuitIsolationKey(const GURL& url);
+
+  // Same as above, on this service. Requests to |url| not noted, or noted
+  // too long ago, are keyed on their own site. If two first parties load
+  // |url| at the same time, its requests are isolated from both.
+  void SetFirstParty(const GURL& url, const GURL& first_party);
 
   // ProxyConfigService methods:
   void AddObserver(Observer* observer) override {}
@@ -68,12 +93,39 @@ class TorProxyConfigService : public net::ProxyConfigService {
   ConfigAvailability GetLatestProxyConfig(
     net::ProxyConfigWithAnnotation* config) override;
 
+  // ProxyDelegate methods:
+  void OnResolveProxy(const GURL& url,
+                      const std::string& method,
+                      const net::ProxyRetryInfoMap& proxy_retry_info,
+                      net::ProxyInfo* result) override;
+  void OnFallback(const net::ProxyServer& bad_proxy, int net_error) override {}
+
  private:
+  struct FirstParty {
+    std::string isolation_key;
+    base::TimeTicks time;
+    // Set when another first party noted the URL before this one expired.
+    bool conflicted;
+  };
+
+  // Drops the first parties noted too long ago.
+  void ClearExpiredFirstParties();
+
   net::ProxyConfig config_;
+  // The proxy of |config_|, without credentials.
+  net::ProxyServer proxy_server_;
+  TorProxyMap* tor_proxy_map_;  // NOT OWNED
+  // The service this config is set on, if set by TorSetProxy.
+  net::ProxyResolutionService* proxy_resolution_service_;  // NOT OWNED
+  // Isolation keys of the first parties by the URLs they requested.
+  std::map<GURL, FirstParty> first_parties_;
+  base::TimeTicks first_parties_cleared_;
 
   std::string scheme_;
   std::string host_;
   std::string port_;
+
+  DISALLOW_COPY_AND_ASSIGN(TorProxyConfigService);
 };
 
 }  // namespace tor
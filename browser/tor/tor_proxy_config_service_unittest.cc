@@ -0,0 +1,176 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/browser/tor/tor_proxy_config_service.h"
+
+#include <memory>
+#include <string>
+
+#include "base/bind_helpers.h"
+#include "brave/common/tor/tor_test_constants.h"
+#include "content/public/test/test_browser_thread_bundle.h"
+#include "net/base/host_port_pair.h"
+#include "net/base/net_errors.h"
+#include "net/log/net_log_with_source.h"
+#include "net/proxy_resolution/proxy_info.h"
+#include "net/proxy_resolution/proxy_resolution_service.h"
+#include "net/proxy_resolution/proxy_retry_info.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "url/gurl.h"
+
+// npm run test -- brave_unit_tests --filter=TorProxyConfigServiceTest.*
+
+namespace tor {
+
+class TorProxyConfigServiceTest : public testing::Test {
+ public:
+  TorProxyConfigServiceTest() {}
+  ~TorProxyConfigServiceTest() override {}
+
+ protected:
+  // Resolves |url| against the config of |service| and lets |service|
+  // adjust the result, like the ProxyResolutionService does.
+  net::ProxyInfo Resolve(TorProxyConfigService* service, const GURL& url) {
+    net::ProxyConfigWithAnnotation config;
+    EXPECT_EQ(net::ProxyConfigService::CONFIG_VALID,
+              service->GetLatestProxyConfig(&config));
+    net::ProxyInfo info;
+    config.value().proxy_rules().Apply(url, &info);
+    service->OnResolveProxy(url, "GET", net::ProxyRetryInfoMap(), &info);
+    return info;
+  }
+
+  TorProxyConfigService::TorProxyMap tor_proxy_map_;
+
+ private:
+  content::TestBrowserThreadBundle thread_bundle_;
+};
+
+TEST_F(TorProxyConfigServiceTest, CircuitIsolationKey) {
+  EXPECT_EQ("example.com", TorProxyConfigService::GetCircuitIsolationKey(
+                               GURL("https://www.example.com/page")));
+  EXPECT_EQ("example.co.uk", TorProxyConfigService::GetCircuitIsolationKey(
+                                 GURL("http://a.b.example.co.uk/")));
+  EXPECT_EQ("127.0.0.1", TorProxyConfigService::GetCircuitIsolationKey(
+                             GURL("http://127.0.0.1:8080/")));
+}
+
+TEST_F(TorProxyConfigServiceTest, CredentialsPerSite) {
+  TorProxyConfigService service(kTestTorProxy, &tor_proxy_map_);
+
+  const net::ProxyInfo first =
+      Resolve(&service, GURL("https://www.example.com/"));
+  EXPECT_EQ(kTestTorPacString, first.ToPacString());
+  const net::HostPortPair& first_proxy =
+      first.proxy_server().host_port_pair();
+  EXPECT_EQ("127.0.0.1", first_proxy.host());
+  EXPECT_EQ(9999, first_proxy.port());
+  EXPECT_EQ("example.com", first_proxy.username());
+  EXPECT_FALSE(first_proxy.password().empty());
+
+  // other hosts of the site share its circuit
+  const net::ProxyInfo same_site =
+      Resolve(&service, GURL("https://static.example.com/script.js"));
+  EXPECT_TRUE(same_site.proxy_server() == first.proxy_server());
+
+  const net::ProxyInfo other_site =
+      Resolve(&service, GURL("https://brave.com/"));
+  EXPECT_EQ("brave.com", other_site.proxy_server().host_port_pair().username());
+  EXPECT_NE(first_proxy.password(),
+            other_site.proxy_server().host_port_pair().password());
+}
+
+TEST_F(TorProxyConfigServiceTest, NewCircuitChangesPassword) {
+  TorProxyConfigService service(kTestTorProxy, &tor_proxy_map_);
+  const GURL url("https://www.example.com/");
+
+  const std::string password =
+      Resolve(&service, url).proxy_server().host_port_pair().password();
+  tor_proxy_map_.Erase("example.com");
+  const net::ProxyInfo info = Resolve(&service, url);
+  EXPECT_EQ("example.com", info.proxy_server().host_port_pair().username());
+  EXPECT_NE(password, info.proxy_server().host_port_pair().password());
+}
+
+TEST_F(TorProxyConfigServiceTest, ThirdPartyIsolatedPerFirstParty) {
+  TorProxyConfigService service(kTestTorProxy, &tor_proxy_map_);
+  const GURL tracker("https://tracker.example.net/pixel.gif");
+
+  service.SetFirstParty(tracker, GURL("https://www.brave.com/"));
+  const net::HostPortPair first =
+      Resolve(&service, tracker).proxy_server().host_port_pair();
+  EXPECT_EQ("brave.com", first.username());
+
+  // noted again by the same site, it stays on that site's circuit
+  service.SetFirstParty(tracker, GURL("https://brave.com/"));
+  EXPECT_EQ(first.password(),
+            Resolve(&service, tracker).proxy_server().host_port_pair()
+                .password());
+
+  // another site loading the same URL can't be told apart from the first,
+  // so its requests go over neither site's circuit
+  service.SetFirstParty(GURL("https://tracker.example.net/pixel.gif#b"),
+                        GURL("https://news.example.org/"));
+  const net::HostPortPair second =
+      Resolve(&service, tracker).proxy_server().host_port_pair();
+  const net::HostPortPair third =
+      Resolve(&service, tracker).proxy_server().host_port_pair();
+  EXPECT_NE("brave.com", second.username());
+  EXPECT_NE("example.org", second.username());
+  EXPECT_NE(second.username(), third.username());
+  EXPECT_NE(first.password(), second.password());
+  EXPECT_NE(Resolve(&service, GURL("https://news.example.org/"))
+                .proxy_server().host_port_pair().password(),
+            second.password());
+
+  // a request nobody noted is keyed on its own site
+  EXPECT_EQ("example.net",
+            Resolve(&service, GURL("https://tracker.example.net/other.js"))
+                .proxy_server().host_port_pair().username());
+}
+
+TEST_F(TorProxyConfigServiceTest, RequestFirstPartyOnProxyService) {
+  std::unique_ptr<net::ProxyResolutionService> proxy_service =
+      net::ProxyResolutionService::CreateDirect();
+  const GURL tracker("https://tracker.example.net/pixel.gif");
+
+  // ignored without a tor config
+  TorProxyConfigService::SetRequestFirstParty(proxy_service.get(), tracker,
+                                              GURL("https://brave.com/"));
+
+  TorProxyConfigService::TorSetProxy(proxy_service.get(), kTestTorProxy,
+                                     &tor_proxy_map_);
+  TorProxyConfigService::SetRequestFirstParty(proxy_service.get(), tracker,
+                                              GURL("https://brave.com/"));
+  net::ProxyInfo info;
+  std::unique_ptr<net::ProxyResolutionService::Request> request;
+  EXPECT_EQ(net::OK, proxy_service->ResolveProxy(
+                         tracker, std::string(), &info, base::DoNothing(),
+                         &request, net::NetLogWithSource()));
+  EXPECT_EQ("brave.com", info.proxy_server().host_port_pair().username());
+}
+
+TEST_F(TorProxyConfigServiceTest, NoCredentialsWithoutMap) {
+  TorProxyConfigService service(kTestTorProxy, nullptr);
+
+  const net::ProxyInfo info = Resolve(&service, GURL("https://example.com/"));
+  EXPECT_EQ(kTestTorPacString, info.ToPacString());
+  EXPECT_TRUE(info.proxy_server().host_port_pair().username().empty());
+}
+
+TEST_F(TorProxyConfigServiceTest, OtherProxiesUnchanged) {
+  TorProxyConfigService service(kTestTorProxy, &tor_proxy_map_);
+  const GURL url("https://example.com/");
+
+  net::ProxyInfo info;
+  info.UseDirect();
+  service.OnResolveProxy(url, "GET", net::ProxyRetryInfoMap(), &info);
+  EXPECT_TRUE(info.is_direct());
+
+  info.UseNamedProxy("socks5://127.0.0.1:1080");
+  service.OnResolveProxy(url, "GET", net::ProxyRetryInfoMap(), &info);
+  EXPECT_TRUE(info.proxy_server().host_port_pair().username().empty());
+}
+
+}  // namespace tor
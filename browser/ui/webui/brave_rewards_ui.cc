@@ -62,7 +62,6 @@ class RewardsDOMHandler : public WebUIMessageHandler,
   void GetReconcileStamp(const base::ListValue* args);
   void GetAddresses(const base::ListValue* args);
   void SaveSetting(const base::ListValue* args);
-  void OnGetContentSiteList(std::unique_ptr<brave_rewards::ContentSiteList>, uint32_t record);
   void GetBalanceReports(const base::ListValue* args);
   void ExcludePublisher(const base::ListValue* args);
   void RestorePublishers(const base::ListValue* args);
@@ -92,7 +91,9 @@ class RewardsDOMHandler : public WebUIMessageHandler,
   void OnGrantFinish(brave_rewards::RewardsService* rewards_service,
                        unsigned int result,
                        brave_rewards::Grant grant) override;
-  void OnContentSiteUpdated(brave_rewards::RewardsService* rewards_service) override;
+  void OnContentSiteListChanged(
+      brave_rewards::RewardsService* rewards_service,
+      const brave_rewards::ContentSiteDiff& diff) override;
   void OnExcludedSitesChanged(brave_rewards::RewardsService* rewards_service) override;
   void OnReconcileComplete(brave_rewards::RewardsService* rewards_service,
                            unsigned int result,
@@ -124,16 +125,24 @@ class RewardsDOMHandler : public WebUIMessageHandler,
           notifications_list) override;
 
   brave_rewards::RewardsService* rewards_service_;  // NOT OWNED
+  // Whether the page asked for the content site list.
+  bool watching_content_sites_;
   base::WeakPtrFactory<RewardsDOMHandler> weak_factory_;
 
   DISALLOW_COPY_AND_ASSIGN(RewardsDOMHandler);
 };
 
-RewardsDOMHandler::RewardsDOMHandler() : weak_factory_(this) {}
+RewardsDOMHandler::RewardsDOMHandler()
+    : rewards_service_(nullptr),
+      watching_content_sites_(false),
+      weak_factory_(this) {}
 
 RewardsDOMHandler::~RewardsDOMHandler() {
-  if (rewards_service_)
+  if (rewards_service_) {
+    if (watching_content_sites_)
+      rewards_service_->StopContentSiteListUpdates();
     rewards_service_->RemoveObserver(this);
+  }
 }
 
 void RewardsDOMHandler::RegisterMessages() {
@@ -433,9 +442,39 @@ void RewardsDOMHandler::GetAddresses(const base::ListValue* args) {
   }
 }
 
-void RewardsDOMHandler::OnContentSiteUpdated(brave_rewards::RewardsService* rewards_service) {
-  rewards_service_->GetContentSiteList(0, 0,
-      base::Bind(&RewardsDOMHandler::OnGetContentSiteList, weak_factory_.GetWeakPtr()));
+void RewardsDOMHandler::OnContentSiteListChanged(
+    brave_rewards::RewardsService* rewards_service,
+    const brave_rewards::ContentSiteDiff& diff) {
+  if (!web_ui()->CanCallJavascript())
+    return;
+
+  auto publishers = std::make_unique<base::ListValue>();
+  for (auto const& item : diff.upserted) {
+    auto publisher = std::make_unique<base::DictionaryValue>();
+    publisher->SetString("id", item.id);
+    publisher->SetDouble("percentage", item.percentage);
+    publisher->SetString("publisherKey", item.id);
+    publisher->SetBoolean("verified", item.verified);
+    publisher->SetInteger("excluded", item.excluded);
+    publisher->SetString("name", item.name);
+    publisher->SetString("provider", item.provider);
+    publisher->SetString("url", item.url);
+    publisher->SetString("favIcon", item.favicon_url);
+    publishers->Append(std::move(publisher));
+  }
+
+  auto removed = std::make_unique<base::ListValue>();
+  for (auto const& id : diff.removed)
+    removed->AppendString(id);
+
+  base::DictionaryValue result;
+  result.SetDouble("version", diff.version);
+  result.SetBoolean("reset", diff.reset);
+  result.SetList("upserted", std::move(publishers));
+  result.SetList("removed", std::move(removed));
+
+  web_ui()->CallJavascriptFunctionUnsafe("brave_rewards.contributeListChanged",
+                                         result);
 }
 
 void RewardsDOMHandler::OnExcludedSitesChanged(brave_rewards::RewardsService* rewards_service) {
@@ -521,28 +560,6 @@ void RewardsDOMHandler::RestorePublishers(const base::ListValue *args) {
   }
 }
 
-void RewardsDOMHandler::OnGetContentSiteList(std::unique_ptr<brave_rewards::ContentSiteList> list, uint32_t record) {
-  if (web_ui()->CanCallJavascript()) {
-    auto publishers = std::make_unique<base::ListValue>();
-    for (auto const& item : *list) {
-      auto publisher = std::make_unique<base::DictionaryValue>();
-      publisher->SetString("id", item.id);
-      publisher->SetDouble("percentage", item.percentage);
-      publisher->SetString("publisherKey", item.id);
-      publisher->SetBoolean("verified", item.verified);
-      publisher->SetInteger("excluded", item.excluded);
-      publisher->SetString("name", item.name);
-      publisher->SetString("provider", item.provider);
-      publisher->SetString("url", item.url);
-      publisher->SetString("favIcon", item.favicon_url);
-      publishers->Append(std::move(publisher));
-    }
-
-    web_ui()->CallJavascriptFunctionUnsafe("brave_rewards.contributeList", *publishers);
-  }
-}
-
-
 void RewardsDOMHandler::GetBalanceReports(const base::ListValue* args) {
   GetAllBalanceReports();
 }
@@ -568,7 +585,8 @@ void RewardsDOMHandler::OnReconcileComplete(brave_rewards::RewardsService* rewar
   const std::string& viewing_id,
   const std::string& probi) {
   GetAllBalanceReports();
-  OnContentSiteUpdated(rewards_service);
+  if (watching_content_sites_)
+    rewards_service_->RefreshContentSiteList();
   GetReconcileStamp(nullptr);
 }
 
@@ -640,7 +658,11 @@ void RewardsDOMHandler::UpdateTipsList(const base::ListValue *args) {
 
 void RewardsDOMHandler::GetContributionList(const base::ListValue *args) {
   if (rewards_service_) {
-    OnContentSiteUpdated(rewards_service_);
+    if (!watching_content_sites_) {
+      watching_content_sites_ = true;
+      rewards_service_->StartContentSiteListUpdates();
+    }
+    rewards_service_->RefreshContentSiteList();
   }
 }
 
@@ -0,0 +1,86 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/common/payload_size.h"
+
+#include "base/strings/string16.h"
+#include "brave/common/extensions/api/brave_sync.h"
+#include "chrome/common/importer/imported_bookmark_entry.h"
+#include "chrome/common/importer/importer_url_row.h"
+#include "components/favicon_base/favicon_usage_data.h"
+#include "net/cookies/canonical_cookie.h"
+
+namespace brave {
+
+namespace {
+
+size_t EstimatePayloadSize(const base::string16& text) {
+  return text.size() * sizeof(base::char16);
+}
+
+size_t EstimatePayloadSize(const extensions::api::brave_sync::Site& site) {
+  return site.location.size() + site.title.size() +
+      site.custom_title.size() + site.favicon.size();
+}
+
+}  // namespace
+
+const size_t kPayloadItemOverheadBytes = 64;
+
+size_t EstimatePayloadSize(const ImporterURLRow& row) {
+  return kPayloadItemOverheadBytes + row.url.spec().size() +
+      EstimatePayloadSize(row.title);
+}
+
+size_t EstimatePayloadSize(const ImportedBookmarkEntry& entry) {
+  size_t size = kPayloadItemOverheadBytes + entry.url.spec().size() +
+      EstimatePayloadSize(entry.title);
+  for (const auto& folder : entry.path)
+    size += EstimatePayloadSize(folder);
+  return size;
+}
+
+size_t EstimatePayloadSize(const favicon_base::FaviconUsageData& favicon) {
+  size_t size = kPayloadItemOverheadBytes + favicon.favicon_url.spec().size() +
+      favicon.png_data.size();
+  for (const auto& url : favicon.urls)
+    size += url.spec().size();
+  return size;
+}
+
+size_t EstimatePayloadSize(const net::CanonicalCookie& cookie) {
+  return kPayloadItemOverheadBytes + cookie.Name().size() +
+      cookie.Value().size() + cookie.Domain().size() + cookie.Path().size();
+}
+
+size_t EstimatePayloadSize(
+    const extensions::api::brave_sync::SyncRecord& record) {
+  // ids are sent as lists of numbers, which take about twice their bytes
+  size_t size = kPayloadItemOverheadBytes + record.object_data.size() +
+      2 * (record.device_id.size() + record.object_id.size());
+  if (record.bookmark) {
+    size += EstimatePayloadSize(record.bookmark->site);
+    if (record.bookmark->parent_folder_object_id)
+      size += 2 * record.bookmark->parent_folder_object_id->size();
+    if (record.bookmark->order)
+      size += record.bookmark->order->size();
+  } else if (record.history_site) {
+    size += EstimatePayloadSize(*record.history_site);
+  } else if (record.site_setting) {
+    size += record.site_setting->host_pattern.size();
+  } else if (record.device) {
+    size += record.device->name.size();
+  }
+  return size;
+}
+
+size_t EstimatePayloadSize(
+    const extensions::api::brave_sync::RecordAndExistingObject& record) {
+  size_t size = EstimatePayloadSize(record.server_record);
+  if (record.local_record)
+    size += EstimatePayloadSize(*record.local_record);
+  return size;
+}
+
+}  // namespace brave
@@ -0,0 +1,75 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_COMMON_PAYLOAD_SIZE_H_
+#define BRAVE_COMMON_PAYLOAD_SIZE_H_
+
+#include <stddef.h>
+
+#include <vector>
+
+struct ImportedBookmarkEntry;
+struct ImporterURLRow;
+
+namespace extensions {
+namespace api {
+namespace brave_sync {
+struct RecordAndExistingObject;
+struct SyncRecord;
+}  // namespace brave_sync
+}  // namespace api
+}  // namespace extensions
+
+namespace favicon_base {
+struct FaviconUsageData;
+}
+
+namespace net {
+class CanonicalCookie;
+}
+
+namespace brave {
+
+// Estimated serialization overhead of an item, on top of its strings.
+extern const size_t kPayloadItemOverheadBytes;
+
+// Rough size of an item once serialized into an IPC or extension event, used
+// to keep the messages carrying many items to a bounded size. Only the
+// variable-length fields are counted, plus kPayloadItemOverheadBytes.
+size_t EstimatePayloadSize(const ImporterURLRow& row);
+size_t EstimatePayloadSize(const ImportedBookmarkEntry& entry);
+size_t EstimatePayloadSize(const favicon_base::FaviconUsageData& favicon);
+size_t EstimatePayloadSize(const net::CanonicalCookie& cookie);
+size_t EstimatePayloadSize(
+    const extensions::api::brave_sync::SyncRecord& record);
+size_t EstimatePayloadSize(
+    const extensions::api::brave_sync::RecordAndExistingObject& record);
+
+// Runs |send_group| for consecutive groups of |items|, each cut before it
+// would go over |max_items| items or |max_bytes| estimated bytes. Every
+// group has at least one item, so an oversized item is sent on its own.
+template <typename T, typename SendGroup>
+void SendInGroups(const std::vector<T>& items,
+                  size_t max_items,
+                  size_t max_bytes,
+                  SendGroup send_group) {
+  auto group_begin = items.begin();
+  while (group_begin != items.end()) {
+    auto group_end = group_begin;
+    size_t group_bytes = 0;
+    do {
+      group_bytes += EstimatePayloadSize(*group_end);
+      ++group_end;
+    } while (group_end != items.end() &&
+             static_cast<size_t>(group_end - group_begin) < max_items &&
+             group_bytes + EstimatePayloadSize(*group_end) <= max_bytes);
+
+    send_group(std::vector<T>(group_begin, group_end));
+    group_begin = group_end;
+  }
+}
+
+}  // namespace brave
+
+#endif  // BRAVE_COMMON_PAYLOAD_SIZE_H_
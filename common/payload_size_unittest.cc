@@ -0,0 +1,91 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/common/payload_size.h"
+
+#include <string>
+#include <vector>
+
+#include "base/time/time.h"
+#include "net/cookies/canonical_cookie.h"
+#include "net/cookies/cookie_constants.h"
+#include "testing/gmock/include/gmock/gmock.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+// npm run test -- brave_unit_tests --filter=PayloadSizeTest.*
+
+using testing::ElementsAre;
+
+namespace brave {
+
+namespace {
+
+// The limits of the importer bridge.
+const size_t kMaxGroupItems = 1000;
+const size_t kMaxGroupBytes = 512 * 1024;
+
+// Estimated size of a cookie is the per-item overhead, its name, domain and
+// path, here 11 bytes, and its value.
+const size_t kCookieFixedBytes = kPayloadItemOverheadBytes + 11;
+
+net::CanonicalCookie Cookie(size_t estimated_size) {
+  return net::CanonicalCookie(
+      "n", std::string(estimated_size - kCookieFixedBytes, 'v'), "brave.com",
+      "/", base::Time(), base::Time(), base::Time(), false, false,
+      net::CookieSameSite::NO_RESTRICTION, net::COOKIE_PRIORITY_DEFAULT);
+}
+
+std::vector<net::CanonicalCookie> Cookies(size_t count,
+                                          size_t estimated_size) {
+  return std::vector<net::CanonicalCookie>(count, Cookie(estimated_size));
+}
+
+// Sizes of the groups |cookies| are sent in.
+std::vector<size_t> GroupSizes(
+    const std::vector<net::CanonicalCookie>& cookies) {
+  std::vector<size_t> sizes;
+  SendInGroups(cookies, kMaxGroupItems, kMaxGroupBytes,
+               [&](const std::vector<net::CanonicalCookie>& group) {
+                 sizes.push_back(group.size());
+               });
+  return sizes;
+}
+
+}  // namespace
+
+TEST(PayloadSizeTest, CookieEstimate) {
+  EXPECT_EQ(100u, EstimatePayloadSize(Cookie(100)));
+}
+
+TEST(PayloadSizeTest, SendInGroupsByItemCount) {
+  EXPECT_THAT(GroupSizes(Cookies(1000, 100)), ElementsAre(1000u));
+  EXPECT_THAT(GroupSizes(Cookies(2001, 100)),
+              ElementsAre(1000u, 1000u, 1u));
+}
+
+TEST(PayloadSizeTest, SendInGroupsBySize) {
+  // exactly full groups
+  EXPECT_THAT(GroupSizes(Cookies(8, kMaxGroupBytes / 4)),
+              ElementsAre(4u, 4u));
+
+  // one byte more and the fourth item starts the next group
+  EXPECT_THAT(GroupSizes(Cookies(4, kMaxGroupBytes / 4 + 1)),
+              ElementsAre(3u, 1u));
+}
+
+TEST(PayloadSizeTest, SendInGroupsOversizedItem) {
+  std::vector<net::CanonicalCookie> cookies;
+  cookies.push_back(Cookie(100));
+  cookies.push_back(Cookie(kMaxGroupBytes + 1));
+  cookies.push_back(Cookie(100));
+  EXPECT_THAT(GroupSizes(cookies), ElementsAre(1u, 1u, 1u));
+
+  EXPECT_THAT(GroupSizes(Cookies(1, 2 * kMaxGroupBytes)), ElementsAre(1u));
+}
+
+TEST(PayloadSizeTest, SendInGroupsNoItems) {
+  EXPECT_TRUE(GroupSizes(std::vector<net::CanonicalCookie>()).empty());
+}
+
+}  // namespace brave
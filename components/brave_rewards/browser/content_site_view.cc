@@ -0,0 +1,121 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_rewards/browser/content_site_view.h"
+
+#include <algorithm>
+#include <set>
+
+namespace brave_rewards {
+
+namespace {
+
+bool IsSameSite(const ContentSite& a, const ContentSite& b) {
+  return a.percentage == b.percentage &&
+         a.verified == b.verified &&
+         a.excluded == b.excluded &&
+         a.name == b.name &&
+         a.favicon_url == b.favicon_url &&
+         a.url == b.url &&
+         a.provider == b.provider &&
+         a.reconcile_stamp == b.reconcile_stamp;
+}
+
+void SortByPercentage(ContentSiteList* list) {
+  std::stable_sort(list->begin(), list->end(),
+      [](const ContentSite& a, const ContentSite& b) {
+        return a.percentage > b.percentage;
+      });
+}
+
+}  // namespace
+
+ContentSiteDiff::ContentSiteDiff() : version(0), reset(false) {}
+
+ContentSiteDiff::ContentSiteDiff(const ContentSiteDiff& diff) = default;
+
+ContentSiteDiff::~ContentSiteDiff() {}
+
+ContentSiteView::ContentSiteView() : version_(0) {}
+
+ContentSiteView::~ContentSiteView() {}
+
+ContentSiteDiff ContentSiteView::Update(const ContentSiteList& list) {
+  ContentSiteDiff diff;
+  std::set<std::string> seen;
+
+  for (const auto& site : list) {
+    if (seen.insert(site.id).second)
+      Upsert(site, &diff);
+  }
+
+  for (auto it = sites_.begin(); it != sites_.end();) {
+    if (seen.count(it->first)) {
+      ++it;
+      continue;
+    }
+    diff.removed.push_back(it->first);
+    it = sites_.erase(it);
+  }
+
+  Finish(&diff);
+  return diff;
+}
+
+ContentSiteDiff ContentSiteView::Apply(
+    const ContentSiteList& upserted,
+    const std::vector<std::string>& removed) {
+  ContentSiteDiff diff;
+  std::set<std::string> seen;
+
+  for (const auto& id : removed) {
+    if (seen.insert(id).second && sites_.erase(id))
+      diff.removed.push_back(id);
+  }
+
+  for (const auto& site : upserted) {
+    if (seen.insert(site.id).second)
+      Upsert(site, &diff);
+  }
+
+  Finish(&diff);
+  return diff;
+}
+
+const ContentSite* ContentSiteView::Find(const std::string& id) const {
+  auto it = sites_.find(id);
+  return it == sites_.end() ? nullptr : &it->second;
+}
+
+ContentSiteDiff ContentSiteView::Snapshot() const {
+  ContentSiteDiff diff;
+  diff.version = version_;
+  diff.reset = true;
+  diff.upserted.reserve(sites_.size());
+  for (const auto& site : sites_)
+    diff.upserted.push_back(site.second);
+  SortByPercentage(&diff.upserted);
+  return diff;
+}
+
+void ContentSiteView::Upsert(const ContentSite& site, ContentSiteDiff* diff) {
+  auto it = sites_.find(site.id);
+  if (it == sites_.end()) {
+    sites_.emplace(site.id, site);
+    diff->upserted.push_back(site);
+  } else if (!IsSameSite(it->second, site)) {
+    it->second = site;
+    diff->upserted.push_back(site);
+  }
+}
+
+void ContentSiteView::Finish(ContentSiteDiff* diff) {
+  if (!diff->empty())
+    version_++;
+
+  SortByPercentage(&diff->upserted);
+  diff->version = version_;
+}
+
+}  // namespace brave_rewards
@@ -0,0 +1,78 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_COMPONENTS_BRAVE_REWARDS_BROWSER_CONTENT_SITE_VIEW_H_
+#define BRAVE_COMPONENTS_BRAVE_REWARDS_BROWSER_CONTENT_SITE_VIEW_H_
+
+#include <stdint.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "base/macros.h"
+#include "brave/components/brave_rewards/browser/content_site.h"
+
+namespace brave_rewards {
+
+// Rows of the content site list that changed between two versions of a
+// ContentSiteView. A |reset| diff carries the whole list and replaces
+// whatever the receiver had.
+struct ContentSiteDiff {
+  ContentSiteDiff();
+  ContentSiteDiff(const ContentSiteDiff& diff);
+  ~ContentSiteDiff();
+
+  bool empty() const { return !reset && upserted.empty() && removed.empty(); }
+
+  uint64_t version;
+  bool reset;
+  // Inserted or updated rows, ordered by percentage.
+  ContentSiteList upserted;
+  // Ids of rows that left the list.
+  std::vector<std::string> removed;
+};
+
+// In-memory copy of the current reconcile period's auto-contribute list.
+//
+// Each Update() or Apply() bumps the version only if a row was inserted,
+// changed or removed, so observers can be sent just the rows that changed
+// and detect a missed diff by a gap in the version.
+class ContentSiteView {
+ public:
+  ContentSiteView();
+  ~ContentSiteView();
+
+  // Replaces the view with |list| and returns the rows that changed.
+  ContentSiteDiff Update(const ContentSiteList& list);
+
+  // Inserts or updates |upserted| and drops |removed|, leaving every other
+  // row alone, and returns the rows that changed.
+  ContentSiteDiff Apply(const ContentSiteList& upserted,
+                        const std::vector<std::string>& removed);
+
+  // Returns the row for |id|, or null if it is not in the list.
+  const ContentSite* Find(const std::string& id) const;
+
+  // Returns the whole list as a reset diff at the current version.
+  ContentSiteDiff Snapshot() const;
+
+  uint64_t version() const { return version_; }
+  size_t size() const { return sites_.size(); }
+
+ private:
+  // Inserts or updates |site|, adding it to |diff| if it changed.
+  void Upsert(const ContentSite& site, ContentSiteDiff* diff);
+  // Bumps the version if |diff| has rows and stamps it.
+  void Finish(ContentSiteDiff* diff);
+
+  std::map<std::string, ContentSite> sites_;
+  uint64_t version_;
+
+  DISALLOW_COPY_AND_ASSIGN(ContentSiteView);
+};
+
+}  // namespace brave_rewards
+
+#endif  // BRAVE_COMPONENTS_BRAVE_REWARDS_BROWSER_CONTENT_SITE_VIEW_H_
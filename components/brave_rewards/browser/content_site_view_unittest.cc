@@ -0,0 +1,140 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_rewards/browser/content_site_view.h"
+
+#include <string>
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+// npm run test -- brave_unit_tests --filter=ContentSiteViewTest.*
+
+namespace brave_rewards {
+
+namespace {
+
+ContentSite MakeSite(const std::string& id, double percentage) {
+  ContentSite site(id);
+  site.percentage = percentage;
+  site.name = id;
+  return site;
+}
+
+}  // namespace
+
+TEST(ContentSiteViewTest, FirstUpdateInsertsEverything) {
+  ContentSiteView view;
+  ContentSiteDiff diff = view.Update({MakeSite("a.com", 30),
+                                      MakeSite("b.com", 70)});
+
+  EXPECT_EQ(1u, diff.version);
+  EXPECT_FALSE(diff.reset);
+  ASSERT_EQ(2u, diff.upserted.size());
+  EXPECT_EQ("b.com", diff.upserted[0].id);
+  EXPECT_EQ("a.com", diff.upserted[1].id);
+  EXPECT_TRUE(diff.removed.empty());
+  EXPECT_EQ(2u, view.size());
+}
+
+TEST(ContentSiteViewTest, UnchangedListKeepsVersion) {
+  ContentSiteView view;
+  view.Update({MakeSite("a.com", 30), MakeSite("b.com", 70)});
+
+  ContentSiteDiff diff = view.Update({MakeSite("b.com", 70),
+                                      MakeSite("a.com", 30)});
+  EXPECT_TRUE(diff.empty());
+  EXPECT_EQ(1u, diff.version);
+  EXPECT_EQ(1u, view.version());
+}
+
+TEST(ContentSiteViewTest, OnlyChangedRowsAreSent) {
+  ContentSiteView view;
+  view.Update({MakeSite("a.com", 30),
+               MakeSite("b.com", 50),
+               MakeSite("c.com", 20)});
+
+  ContentSiteDiff diff = view.Update({MakeSite("a.com", 40),
+                                      MakeSite("b.com", 50),
+                                      MakeSite("d.com", 10)});
+  EXPECT_EQ(2u, diff.version);
+  ASSERT_EQ(2u, diff.upserted.size());
+  EXPECT_EQ("a.com", diff.upserted[0].id);
+  EXPECT_EQ(40, diff.upserted[0].percentage);
+  EXPECT_EQ("d.com", diff.upserted[1].id);
+  ASSERT_EQ(1u, diff.removed.size());
+  EXPECT_EQ("c.com", diff.removed[0]);
+  EXPECT_EQ(3u, view.size());
+}
+
+TEST(ContentSiteViewTest, FieldChangeIsAnUpdate) {
+  ContentSiteView view;
+  view.Update({MakeSite("a.com", 100)});
+
+  ContentSite site = MakeSite("a.com", 100);
+  site.verified = true;
+  ContentSiteDiff diff = view.Update({site});
+  ASSERT_EQ(1u, diff.upserted.size());
+  EXPECT_TRUE(diff.upserted[0].verified);
+  EXPECT_TRUE(diff.removed.empty());
+}
+
+TEST(ContentSiteViewTest, SnapshotIsAResetAtCurrentVersion) {
+  ContentSiteView view;
+  view.Update({MakeSite("a.com", 30)});
+  view.Update({MakeSite("a.com", 20), MakeSite("b.com", 80)});
+
+  ContentSiteDiff snapshot = view.Snapshot();
+  EXPECT_TRUE(snapshot.reset);
+  EXPECT_FALSE(snapshot.empty());
+  EXPECT_EQ(view.version(), snapshot.version);
+  ASSERT_EQ(2u, snapshot.upserted.size());
+  EXPECT_EQ("b.com", snapshot.upserted[0].id);
+  EXPECT_EQ("a.com", snapshot.upserted[1].id);
+  EXPECT_TRUE(snapshot.removed.empty());
+}
+
+TEST(ContentSiteViewTest, ClearingTheListRemovesEverything) {
+  ContentSiteView view;
+  view.Update({MakeSite("a.com", 30), MakeSite("b.com", 70)});
+
+  ContentSiteDiff diff = view.Update(ContentSiteList());
+  EXPECT_TRUE(diff.upserted.empty());
+  EXPECT_EQ(2u, diff.removed.size());
+  EXPECT_EQ(0u, view.size());
+
+  EXPECT_TRUE(view.Snapshot().upserted.empty());
+}
+
+TEST(ContentSiteViewTest, ApplyLeavesOtherRowsAlone) {
+  ContentSiteView view;
+  view.Update({MakeSite("a.com", 30),
+               MakeSite("b.com", 50),
+               MakeSite("c.com", 20)});
+
+  ContentSiteDiff diff = view.Apply({MakeSite("a.com", 40),
+                                     MakeSite("d.com", 10)},
+                                    {"c.com", "e.com"});
+  EXPECT_EQ(2u, diff.version);
+  ASSERT_EQ(2u, diff.upserted.size());
+  EXPECT_EQ("a.com", diff.upserted[0].id);
+  EXPECT_EQ("d.com", diff.upserted[1].id);
+  ASSERT_EQ(1u, diff.removed.size());
+  EXPECT_EQ("c.com", diff.removed[0]);
+
+  EXPECT_EQ(3u, view.size());
+  ASSERT_TRUE(view.Find("b.com"));
+  EXPECT_EQ(50, view.Find("b.com")->percentage);
+  EXPECT_FALSE(view.Find("c.com"));
+}
+
+TEST(ContentSiteViewTest, ApplyWithoutChangesKeepsVersion) {
+  ContentSiteView view;
+  view.Update({MakeSite("a.com", 30)});
+
+  ContentSiteDiff diff = view.Apply({MakeSite("a.com", 30)}, {"b.com"});
+  EXPECT_TRUE(diff.empty());
+  EXPECT_EQ(1u, diff.version);
+}
+
+}  // namespace brave_rewards
@@ -0,0 +1,255 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_rewards/browser/favicon_fetcher.h"
+
+#include <utility>
+
+#include "base/bind.h"
+#include "base/bind_helpers.h"
+#include "brave/components/brave_rewards/browser/rewards_fetcher_service_observer.h"
+#include "chrome/browser/bitmap_fetcher/bitmap_fetcher_service_factory.h"
+#include "chrome/browser/favicon/favicon_service_factory.h"
+#include "chrome/browser/profiles/profile.h"
+#include "components/favicon/core/favicon_service.h"
+#include "net/traffic_annotation/network_traffic_annotation.h"
+#include "third_party/skia/include/core/SkBitmap.h"
+#include "ui/gfx/image/image.h"
+
+namespace brave_rewards {
+
+namespace {
+
+// BitmapFetcherService rejects requests beyond its own in-flight limit, so
+// stay well below it.
+const size_t kMaxConcurrentFetches = 6;
+
+}  // namespace
+
+FaviconFetcher::Waiter::Waiter(const std::string& favicon_key,
+                               ledger::FetchIconCallback callback)
+    : favicon_key(favicon_key),
+      callback(callback),
+      icon_type(favicon_base::IconType::kFavicon) {}
+
+FaviconFetcher::Waiter::Waiter(const std::string& favicon_key,
+                               favicon_base::IconType icon_type)
+    : favicon_key(favicon_key), icon_type(icon_type) {}
+
+FaviconFetcher::Waiter::Waiter(const Waiter& waiter) = default;
+
+FaviconFetcher::Waiter::~Waiter() {}
+
+FaviconFetcher::FaviconFetcher(Profile* profile)
+    : profile_(profile),
+      in_flight_(0),
+      weak_factory_(this) {
+}
+
+FaviconFetcher::~FaviconFetcher() {
+  CancelAll();
+}
+
+void FaviconFetcher::Fetch(const GURL& url,
+                           const std::string& favicon_key,
+                           ledger::FetchIconCallback callback) {
+  if (!url.is_valid())
+    return;
+
+  favicon::FaviconService* favicon_service = GetFaviconService();
+  if (!favicon_service) {
+    Enqueue(url, Waiter(favicon_key, callback));
+    return;
+  }
+
+  favicon_service->GetRawFaviconForPageURL(
+      GURL(favicon_key),
+      {favicon_base::IconType::kFavicon},
+      0,
+      false,
+      base::BindOnce(&FaviconFetcher::OnCacheLookup,
+                     weak_factory_.GetWeakPtr(),
+                     url,
+                     favicon_key,
+                     callback),
+      &task_tracker_);
+}
+
+void FaviconFetcher::CancelAll() {
+  weak_factory_.InvalidateWeakPtrs();
+  task_tracker_.TryCancelAll();
+
+  for (auto request_id : request_ids_)
+    CancelRequest(request_id);
+
+  request_ids_.clear();
+  waiters_.clear();
+  queue_.clear();
+  in_flight_ = 0;
+}
+
+void FaviconFetcher::OnCacheLookup(
+    const GURL& url,
+    const std::string& favicon_key,
+    ledger::FetchIconCallback callback,
+    const favicon_base::FaviconRawBitmapResult& result) {
+  if (!result.is_valid()) {
+    Enqueue(url, Waiter(favicon_key, callback));
+    return;
+  }
+
+  // Keep the on-demand icon from being evicted while the publisher is in use.
+  favicon::FaviconService* favicon_service = GetFaviconService();
+  if (favicon_service)
+    favicon_service->TouchOnDemandFavicon(result.icon_url);
+
+  callback(true, GURL(favicon_key).spec());
+
+  if (result.expired)
+    Enqueue(url, Waiter(favicon_key, result.icon_type));
+}
+
+void FaviconFetcher::Enqueue(const GURL& url, const Waiter& waiter) {
+  std::vector<Waiter>& waiters = waiters_[url.spec()];
+  const bool queued = !waiters.empty();
+  waiters.push_back(waiter);
+  if (queued)
+    return;
+
+  queue_.push_back(url);
+  Pump();
+}
+
+void FaviconFetcher::Pump() {
+  while (in_flight_ < kMaxConcurrentFetches && !queue_.empty()) {
+    const GURL url = queue_.front();
+    queue_.pop_front();
+
+    // The fetch may complete synchronously, so count it first.
+    in_flight_++;
+    BitmapFetcherService::RequestId request_id = RequestImage(url);
+    if (request_id != BitmapFetcherService::REQUEST_ID_INVALID &&
+        waiters_.count(url.spec())) {
+      request_ids_.insert(request_id);
+    }
+  }
+}
+
+favicon::FaviconService* FaviconFetcher::GetFaviconService() {
+  return FaviconServiceFactory::GetForProfile(
+      profile_, ServiceAccessType::EXPLICIT_ACCESS);
+}
+
+BitmapFetcherService::RequestId FaviconFetcher::RequestImage(
+    const GURL& url) {
+  BitmapFetcherService* image_service =
+      BitmapFetcherServiceFactory::GetForBrowserContext(profile_);
+  if (!image_service) {
+    OnFetchComplete(url.spec(), url,
+                    BitmapFetcherService::REQUEST_ID_INVALID, SkBitmap());
+    return BitmapFetcherService::REQUEST_ID_INVALID;
+  }
+
+  net::NetworkTrafficAnnotationTag traffic_annotation =
+    net::DefineNetworkTrafficAnnotation("brave_rewards_favicon_fetcher", R"(
+      semantics {
+        sender:
+          "Brave Rewards Media Fetcher"
+        description:
+          "Fetches favicon for media publishers in Rewards."
+        trigger:
+          "User visits a media publisher content."
+        data: "Favicon for media publisher."
+        destination: WEBSITE
+      }
+      policy {
+        cookies_allowed: NO
+        setting:
+          "This feature cannot be disabled by settings."
+        policy_exception_justification:
+          "Not implemented."
+      })");
+
+  return image_service->RequestImage(
+      url,
+      // Image Service takes ownership of the observer
+      new RewardsFetcherServiceObserver(
+          url.spec(),
+          url,
+          base::Bind(&FaviconFetcher::OnFetchComplete,
+                     weak_factory_.GetWeakPtr())),
+      traffic_annotation);
+}
+
+void FaviconFetcher::CancelRequest(
+    BitmapFetcherService::RequestId request_id) {
+  BitmapFetcherService* image_service =
+      BitmapFetcherServiceFactory::GetForBrowserContext(profile_);
+  if (image_service)
+    image_service->CancelRequest(request_id);
+}
+
+void FaviconFetcher::OnFetchComplete(
+    const std::string& url_spec,
+    const GURL& url,
+    const BitmapFetcherService::RequestId& request_id,
+    const SkBitmap& image) {
+  request_ids_.erase(request_id);
+
+  auto it = waiters_.find(url_spec);
+  if (it == waiters_.end())
+    return;
+
+  std::vector<Waiter> waiters = std::move(it->second);
+  waiters_.erase(it);
+  DCHECK_GT(in_flight_, 0u);
+  in_flight_--;
+
+  favicon::FaviconService* favicon_service = GetFaviconService();
+  if (image.isNull() || !favicon_service) {
+    for (const auto& waiter : waiters) {
+      if (waiter.callback)
+        waiter.callback(false, GURL(waiter.favicon_key).spec());
+    }
+    Pump();
+    return;
+  }
+
+  gfx::Image gfx_image = gfx::Image::CreateFrom1xBitmap(image);
+  for (const auto& waiter : waiters) {
+    const GURL favicon_url(waiter.favicon_key);
+    if (!waiter.callback) {
+      // Background refresh of an expired cache entry. On-demand icons are
+      // only written for pages without one, so drop the stale mapping first
+      // and write the icon back as on-demand with its original type.
+      favicon_service->DeleteFaviconMappings({favicon_url}, waiter.icon_type);
+      favicon_service->SetOnDemandFavicons(favicon_url,
+                                           url,
+                                           waiter.icon_type,
+                                           gfx_image,
+                                           base::DoNothing());
+      continue;
+    }
+
+    favicon_service->SetOnDemandFavicons(
+        favicon_url,
+        url,
+        favicon_base::IconType::kFavicon,
+        gfx_image,
+        base::BindOnce(&FaviconFetcher::OnFaviconSaved,
+                       weak_factory_.GetWeakPtr(),
+                       favicon_url.spec(),
+                       waiter.callback));
+  }
+
+  Pump();
+}
+
+void FaviconFetcher::OnFaviconSaved(const std::string& favicon_key,
+                                    ledger::FetchIconCallback callback,
+                                    bool success) {
+  callback(success, favicon_key);
+}
+
+}  // namespace brave_rewards
@@ -0,0 +1,103 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_COMPONENTS_BRAVE_REWARDS_BROWSER_FAVICON_FETCHER_H_
+#define BRAVE_COMPONENTS_BRAVE_REWARDS_BROWSER_FAVICON_FETCHER_H_
+
+#include <deque>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "base/macros.h"
+#include "base/memory/weak_ptr.h"
+#include "base/task/cancelable_task_tracker.h"
+#include "bat/ledger/ledger_client.h"
+#include "chrome/browser/bitmap_fetcher/bitmap_fetcher_service.h"
+#include "components/favicon_base/favicon_types.h"
+#include "url/gurl.h"
+
+class Profile;
+class SkBitmap;
+
+namespace favicon {
+class FaviconService;
+}
+
+namespace brave_rewards {
+
+// Fetches publisher favicons for the ledger.
+//
+// Favicons are stored as on-demand icons in the profile's favicon database
+// keyed by the publisher's favicon key, which doubles as a persistent cache:
+// a cached icon is reported right away and, once it has expired, refreshed
+// in the background. Network fetches are deduplicated by favicon URL and at
+// most |kMaxConcurrentFetches| run at once so opening the rewards page for
+// hundreds of publishers does not fan out hundreds of fetches.
+class FaviconFetcher {
+ public:
+  explicit FaviconFetcher(Profile* profile);
+  virtual ~FaviconFetcher();
+
+  void Fetch(const GURL& url,
+             const std::string& favicon_key,
+             ledger::FetchIconCallback callback);
+
+  // Cancels outstanding fetches. Pending callbacks are dropped.
+  void CancelAll();
+
+ protected:
+  // Overridden in tests.
+  virtual favicon::FaviconService* GetFaviconService();
+  // Starts a network fetch of |url| that reports to OnFetchComplete.
+  virtual BitmapFetcherService::RequestId RequestImage(const GURL& url);
+  virtual void CancelRequest(BitmapFetcherService::RequestId request_id);
+
+  void OnFetchComplete(const std::string& url_spec,
+                       const GURL& url,
+                       const BitmapFetcherService::RequestId& request_id,
+                       const SkBitmap& image);
+
+ private:
+  friend class FaviconFetcherTest;
+
+  struct Waiter {
+    Waiter(const std::string& favicon_key, ledger::FetchIconCallback callback);
+    Waiter(const std::string& favicon_key, favicon_base::IconType icon_type);
+    Waiter(const Waiter& waiter);
+    ~Waiter();
+
+    std::string favicon_key;
+    // Null for background refreshes.
+    ledger::FetchIconCallback callback;
+    // Type of the cached icon a background refresh replaces.
+    favicon_base::IconType icon_type;
+  };
+
+  void OnCacheLookup(const GURL& url,
+                     const std::string& favicon_key,
+                     ledger::FetchIconCallback callback,
+                     const favicon_base::FaviconRawBitmapResult& result);
+  void Enqueue(const GURL& url, const Waiter& waiter);
+  void Pump();
+  void OnFaviconSaved(const std::string& favicon_key,
+                      ledger::FetchIconCallback callback,
+                      bool success);
+
+  Profile* profile_;  // NOT OWNED
+  std::deque<GURL> queue_;
+  // Waiters for every queued or in-flight favicon URL.
+  std::map<std::string, std::vector<Waiter>> waiters_;
+  std::set<BitmapFetcherService::RequestId> request_ids_;
+  size_t in_flight_;
+  base::CancelableTaskTracker task_tracker_;
+  base::WeakPtrFactory<FaviconFetcher> weak_factory_;
+
+  DISALLOW_COPY_AND_ASSIGN(FaviconFetcher);
+};
+
+}  // namespace brave_rewards
+
+#endif  // BRAVE_COMPONENTS_BRAVE_REWARDS_BROWSER_FAVICON_FETCHER_H_
@@ -0,0 +1,206 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_rewards/browser/favicon_fetcher.h"
+
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/memory/ref_counted_memory.h"
+#include "base/strings/string_number_conversions.h"
+#include "components/favicon/core/test/mock_favicon_service.h"
+#include "testing/gmock/include/gmock/gmock.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "third_party/skia/include/core/SkBitmap.h"
+
+// npm run test -- brave_unit_tests --filter=FaviconFetcherTest.*
+
+using testing::_;
+using testing::NiceMock;
+
+namespace brave_rewards {
+
+namespace {
+
+// Records the fetches instead of going to the network.
+class TestFaviconFetcher : public FaviconFetcher {
+ public:
+  TestFaviconFetcher()
+      : FaviconFetcher(nullptr),
+        favicon_service_(nullptr),
+        next_request_id_(1) {}
+  ~TestFaviconFetcher() override {
+    // the base class can't reach the overrides anymore
+    CancelAll();
+  }
+
+  void set_favicon_service(favicon::FaviconService* favicon_service) {
+    favicon_service_ = favicon_service;
+  }
+
+  void Complete(const GURL& url, const SkBitmap& image) {
+    OnFetchComplete(url.spec(), url, request_ids_[url.spec()], image);
+  }
+
+  const std::vector<GURL>& requested() const { return requested_; }
+  const std::vector<BitmapFetcherService::RequestId>& cancelled() const {
+    return cancelled_;
+  }
+
+ protected:
+  favicon::FaviconService* GetFaviconService() override {
+    return favicon_service_;
+  }
+
+  BitmapFetcherService::RequestId RequestImage(const GURL& url) override {
+    requested_.push_back(url);
+    request_ids_[url.spec()] = next_request_id_;
+    return next_request_id_++;
+  }
+
+  void CancelRequest(BitmapFetcherService::RequestId request_id) override {
+    cancelled_.push_back(request_id);
+  }
+
+ private:
+  favicon::FaviconService* favicon_service_;
+  BitmapFetcherService::RequestId next_request_id_;
+  std::map<std::string, BitmapFetcherService::RequestId> request_ids_;
+  std::vector<GURL> requested_;
+  std::vector<BitmapFetcherService::RequestId> cancelled_;
+
+  DISALLOW_COPY_AND_ASSIGN(TestFaviconFetcher);
+};
+
+GURL IconURL(int i) {
+  return GURL("https://publisher" + base::IntToString(i) +
+              ".example.com/favicon.ico");
+}
+
+std::string FaviconKey(int i) {
+  return "https://brave.com/" + base::IntToString(i);
+}
+
+SkBitmap CreateBitmap() {
+  SkBitmap bitmap;
+  bitmap.allocN32Pixels(16, 16);
+  bitmap.eraseColor(SK_ColorBLUE);
+  return bitmap;
+}
+
+}  // namespace
+
+class FaviconFetcherTest : public testing::Test {
+ public:
+  FaviconFetcherTest() {}
+  ~FaviconFetcherTest() override {}
+
+ protected:
+  // Fetches |url| and records the result under |favicon_key|.
+  void Fetch(const GURL& url, const std::string& favicon_key) {
+    fetcher_.Fetch(url, favicon_key,
+        [this](bool success, const std::string& favicon_key) {
+          results_.push_back(std::make_pair(favicon_key, success));
+        });
+  }
+
+  // Answers the favicon database lookup of a Fetch.
+  void CacheLookup(const GURL& url,
+                   const std::string& favicon_key,
+                   const favicon_base::FaviconRawBitmapResult& result) {
+    fetcher_.OnCacheLookup(url, favicon_key,
+        [this](bool success, const std::string& favicon_key) {
+          results_.push_back(std::make_pair(favicon_key, success));
+        },
+        result);
+  }
+
+  TestFaviconFetcher fetcher_;
+  std::vector<std::pair<std::string, bool>> results_;
+};
+
+TEST_F(FaviconFetcherTest, DeduplicatesFetchesOfOneIcon) {
+  Fetch(IconURL(1), FaviconKey(1));
+  Fetch(IconURL(1), FaviconKey(2));
+  ASSERT_EQ(1u, fetcher_.requested().size());
+  EXPECT_TRUE(results_.empty());
+
+  // without a favicon database the icon can't be stored
+  fetcher_.Complete(IconURL(1), CreateBitmap());
+  ASSERT_EQ(2u, results_.size());
+  EXPECT_EQ(GURL(FaviconKey(1)).spec(), results_[0].first);
+  EXPECT_EQ(GURL(FaviconKey(2)).spec(), results_[1].first);
+
+  // a later fetch goes to the network again
+  Fetch(IconURL(1), FaviconKey(1));
+  EXPECT_EQ(2u, fetcher_.requested().size());
+}
+
+TEST_F(FaviconFetcherTest, CapsConcurrentFetches) {
+  for (int i = 0; i < 10; ++i)
+    Fetch(IconURL(i), FaviconKey(i));
+  ASSERT_EQ(6u, fetcher_.requested().size());
+
+  // every completed fetch starts the next queued one, in order
+  fetcher_.Complete(IconURL(0), SkBitmap());
+  ASSERT_EQ(7u, fetcher_.requested().size());
+  EXPECT_EQ(IconURL(6), fetcher_.requested().back());
+  ASSERT_EQ(1u, results_.size());
+  EXPECT_FALSE(results_[0].second);
+
+  for (int i = 1; i < 10; ++i)
+    fetcher_.Complete(IconURL(i), SkBitmap());
+  EXPECT_EQ(10u, fetcher_.requested().size());
+  EXPECT_EQ(10u, results_.size());
+}
+
+TEST_F(FaviconFetcherTest, CancelAllDropsQueuedAndInFlightFetches) {
+  for (int i = 0; i < 8; ++i)
+    Fetch(IconURL(i), FaviconKey(i));
+  ASSERT_EQ(6u, fetcher_.requested().size());
+
+  fetcher_.CancelAll();
+  EXPECT_EQ(6u, fetcher_.cancelled().size());
+
+  // late completions neither report nor start the queued fetches
+  fetcher_.Complete(IconURL(0), CreateBitmap());
+  EXPECT_TRUE(results_.empty());
+  EXPECT_EQ(6u, fetcher_.requested().size());
+
+  // the cap is free again
+  Fetch(IconURL(10), FaviconKey(10));
+  EXPECT_EQ(7u, fetcher_.requested().size());
+}
+
+TEST_F(FaviconFetcherTest, RefreshKeepsIconOnDemandWithItsType) {
+  NiceMock<favicon::MockFaviconService> favicon_service;
+  fetcher_.set_favicon_service(&favicon_service);
+
+  favicon_base::FaviconRawBitmapResult result;
+  result.bitmap_data = base::MakeRefCounted<base::RefCountedBytes>(
+      std::vector<unsigned char>(4, 1));
+  result.icon_url = IconURL(1);
+  result.icon_type = favicon_base::IconType::kTouchIcon;
+  result.expired = true;
+
+  EXPECT_CALL(favicon_service, TouchOnDemandFavicon(IconURL(1)));
+  CacheLookup(IconURL(1), FaviconKey(1), result);
+  // the cached icon is reported right away and refreshed in the background
+  ASSERT_EQ(1u, results_.size());
+  EXPECT_TRUE(results_[0].second);
+  ASSERT_EQ(1u, fetcher_.requested().size());
+
+  EXPECT_CALL(favicon_service, SetFavicons(_, _, _, _)).Times(0);
+  EXPECT_CALL(favicon_service,
+              DeleteFaviconMappings(_, favicon_base::IconType::kTouchIcon));
+  EXPECT_CALL(favicon_service,
+              SetOnDemandFavicons(GURL(FaviconKey(1)), IconURL(1),
+                                  favicon_base::IconType::kTouchIcon, _, _));
+  fetcher_.Complete(IconURL(1), CreateBitmap());
+  EXPECT_EQ(1u, results_.size());
+}
+
+}  // namespace brave_rewards
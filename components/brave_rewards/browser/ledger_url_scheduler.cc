@@ -0,0 +1,292 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_rewards/browser/ledger_url_scheduler.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "base/bind.h"
+#include "base/strings/string_util.h"
+#include "base/time/default_tick_clock.h"
+#include "base/time/tick_clock.h"
+#include "net/http/http_response_headers.h"
+#include "net/http/http_status_code.h"
+#include "net/url_request/url_request_context_getter.h"
+#include "net/url_request/url_request_status.h"
+
+namespace brave_rewards {
+
+namespace {
+
+const size_t kDefaultMaxRequestsPerHost = 4;
+const int kMaxRetries = 3;
+
+const net::BackoffEntry::Policy kDefaultBackoffPolicy = {
+  // Number of initial errors (in sequence) to ignore before applying
+  // exponential back-off rules.
+  0,
+
+  // Initial delay for exponential back-off in ms.
+  1000,
+
+  // Factor by which the waiting time will be multiplied.
+  2,
+
+  // Fuzzing percentage. ex: 10% will spread requests randomly
+  // between 90%-100% of the calculated time.
+  0.2,
+
+  // Maximum amount of time we are willing to delay our request in ms.
+  10 * 60 * 1000,
+
+  // Time to keep an entry from being discarded even when it
+  // has no significant state, -1 to never discard.
+  -1,
+
+  // Don't use initial delay unless the last request was an error.
+  false,
+};
+
+std::string GetRequestKey(const LedgerURLScheduler::Request& request) {
+  std::string key = request.url.spec();
+  for (const auto& header : request.headers) {
+    key += '\n';
+    key += header;
+  }
+  return key;
+}
+
+bool IsRetriableFailure(const net::URLFetcher* source) {
+  if (!source->GetStatus().is_success())
+    return true;
+  const int response_code = source->GetResponseCode();
+  return response_code >= net::HTTP_INTERNAL_SERVER_ERROR ||
+         response_code == net::HTTP_TOO_MANY_REQUESTS;
+}
+
+}  // namespace
+
+struct LedgerURLScheduler::Job {
+  Request request;
+  std::string key;
+  std::string host;
+  std::vector<FetchCallback> callbacks;
+  std::unique_ptr<net::URLFetcher> fetcher;
+  int retries = 0;
+};
+
+LedgerURLScheduler::Request::Request()
+    : method(net::URLFetcher::GET), priority(BACKGROUND) {}
+
+LedgerURLScheduler::Request::Request(const Request& request) = default;
+
+LedgerURLScheduler::Request::~Request() {}
+
+LedgerURLScheduler::HostState::HostState() : active(0) {}
+
+LedgerURLScheduler::HostState::~HostState() {}
+
+LedgerURLScheduler::LedgerURLScheduler(
+    scoped_refptr<net::URLRequestContextGetter> request_context,
+    const base::TickClock* tick_clock)
+    : request_context_(request_context),
+      tick_clock_(tick_clock ? tick_clock
+                             : base::DefaultTickClock::GetInstance()),
+      backoff_policy_(&kDefaultBackoffPolicy),
+      max_requests_per_host_(kDefaultMaxRequestsPerHost),
+      backoff_timer_(tick_clock_),
+      weak_factory_(this) {
+}
+
+LedgerURLScheduler::~LedgerURLScheduler() {
+  CancelAll();
+}
+
+void LedgerURLScheduler::Schedule(const Request& request,
+                                  const FetchCallback& callback) {
+  if (request.method == net::URLFetcher::GET) {
+    const std::string key = GetRequestKey(request);
+    auto it = pending_gets_.find(key);
+    if (it != pending_gets_.end()) {
+      Job* job = it->second;
+      job->callbacks.push_back(callback);
+      // A user visible caller promotes a queued background duplicate.
+      if (request.priority > job->request.priority && !job->fetcher) {
+        auto& queue = queues_[job->request.priority];
+        for (auto queued = queue.begin(); queued != queue.end(); ++queued) {
+          if (queued->get() != job)
+            continue;
+          std::unique_ptr<Job> promoted = std::move(*queued);
+          queue.erase(queued);
+          promoted->request.priority = request.priority;
+          queues_[request.priority].push_back(std::move(promoted));
+          break;
+        }
+        Pump();
+      }
+      return;
+    }
+  }
+
+  auto job = std::make_unique<Job>();
+  job->request = request;
+  job->host = request.url.host();
+  job->callbacks.push_back(callback);
+  if (request.method == net::URLFetcher::GET) {
+    job->key = GetRequestKey(request);
+    pending_gets_[job->key] = job.get();
+  }
+  queues_[request.priority].push_back(std::move(job));
+  Pump();
+}
+
+void LedgerURLScheduler::CancelAll() {
+  backoff_timer_.Stop();
+  for (auto& queue : queues_)
+    queue.clear();
+  in_flight_.clear();
+  pending_gets_.clear();
+  for (auto& host : hosts_)
+    host.second->active = 0;
+}
+
+void LedgerURLScheduler::SetBackoffPolicyForTesting(
+    const net::BackoffEntry::Policy* policy) {
+  backoff_policy_ = policy;
+  hosts_.clear();
+}
+
+LedgerURLScheduler::HostState* LedgerURLScheduler::GetHostState(
+    const std::string& host) {
+  std::unique_ptr<HostState>& state = hosts_[host];
+  if (!state) {
+    state = std::make_unique<HostState>();
+    state->backoff =
+        std::make_unique<net::BackoffEntry>(backoff_policy_, tick_clock_);
+  }
+  return state.get();
+}
+
+void LedgerURLScheduler::Pump() {
+  base::TimeDelta next_release = base::TimeDelta::Max();
+
+  for (int priority = NUM_PRIORITIES - 1; priority >= 0; --priority) {
+    std::deque<std::unique_ptr<Job>> waiting;
+    auto& queue = queues_[priority];
+    while (!queue.empty()) {
+      std::unique_ptr<Job> job = std::move(queue.front());
+      queue.pop_front();
+
+      HostState* host = GetHostState(job->host);
+      if (host->active >= max_requests_per_host_) {
+        waiting.push_back(std::move(job));
+        continue;
+      }
+      if (job->request.method == net::URLFetcher::GET &&
+          host->backoff->ShouldRejectRequest()) {
+        next_release =
+            std::min(next_release, host->backoff->GetTimeUntilRelease());
+        waiting.push_back(std::move(job));
+        continue;
+      }
+      StartJob(std::move(job));
+    }
+    queue.swap(waiting);
+  }
+
+  if (next_release != base::TimeDelta::Max()) {
+    backoff_timer_.Start(FROM_HERE, next_release,
+        base::BindOnce(&LedgerURLScheduler::Pump, base::Unretained(this)));
+  }
+}
+
+void LedgerURLScheduler::StartJob(std::unique_ptr<Job> job) {
+  const Request& request = job->request;
+  job->fetcher = net::URLFetcher::Create(request.url, request.method, this);
+  job->fetcher->SetRequestContext(request_context_.get());
+
+  for (const auto& header : request.headers)
+    job->fetcher->AddExtraRequestHeader(header);
+
+  if (!request.content.empty())
+    job->fetcher->SetUploadData(request.content_type, request.content);
+
+  GetHostState(job->host)->active++;
+
+  net::URLFetcher* fetcher = job->fetcher.get();
+  in_flight_[fetcher] = std::move(job);
+  fetcher->Start();
+}
+
+void LedgerURLScheduler::OnURLFetchComplete(const net::URLFetcher* source) {
+  auto it = in_flight_.find(source);
+  if (it == in_flight_.end())
+    return;
+
+  std::unique_ptr<Job> job = std::move(it->second);
+  in_flight_.erase(it);
+
+  HostState* host = GetHostState(job->host);
+  DCHECK_GT(host->active, 0u);
+  host->active--;
+
+  // Only GETs are retried, so only they feed and wait on the backoff.
+  const bool failed = IsRetriableFailure(source);
+  const bool is_get = job->request.method == net::URLFetcher::GET;
+  if (is_get)
+    host->backoff->InformOfRequest(!failed);
+
+  if (failed && is_get && job->retries < kMaxRetries) {
+    job->retries++;
+    job->fetcher.reset();
+    queues_[job->request.priority].push_front(std::move(job));
+    Pump();
+    return;
+  }
+
+  int response_code = source->GetResponseCode();
+  std::string body;
+  std::map<std::string, std::string> headers;
+  scoped_refptr<net::HttpResponseHeaders> headersList =
+      source->GetResponseHeaders();
+
+  if (headersList) {
+    size_t iter = 0;
+    std::string key;
+    std::string value;
+    while (headersList->EnumerateHeaderLines(&iter, &key, &value)) {
+      key = base::ToLowerASCII(key);
+      headers[key] = value;
+    }
+  }
+
+  if (response_code != net::URLFetcher::ResponseCode::RESPONSE_CODE_INVALID &&
+      source->GetStatus().is_success()) {
+    source->GetResponseAsString(&body);
+  }
+
+  FinishJob(std::move(job), response_code, body, headers);
+}
+
+void LedgerURLScheduler::FinishJob(
+    std::unique_ptr<Job> job,
+    int response_code,
+    const std::string& body,
+    const std::map<std::string, std::string>& headers) {
+  if (!job->key.empty())
+    pending_gets_.erase(job->key);
+
+  // Callbacks may schedule more requests or tear the scheduler down.
+  base::WeakPtr<LedgerURLScheduler> self = weak_factory_.GetWeakPtr();
+  for (const auto& callback : job->callbacks) {
+    callback.Run(response_code, body, headers);
+    if (!self)
+      return;
+  }
+
+  Pump();
+}
+
+}  // namespace brave_rewards
@@ -0,0 +1,129 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_COMPONENTS_BRAVE_REWARDS_BROWSER_LEDGER_URL_SCHEDULER_H_
+#define BRAVE_COMPONENTS_BRAVE_REWARDS_BROWSER_LEDGER_URL_SCHEDULER_H_
+
+#include <deque>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/callback.h"
+#include "base/macros.h"
+#include "base/memory/ref_counted.h"
+#include "base/memory/weak_ptr.h"
+#include "base/timer/timer.h"
+#include "net/base/backoff_entry.h"
+#include "net/url_request/url_fetcher.h"
+#include "net/url_request/url_fetcher_delegate.h"
+#include "url/gurl.h"
+
+namespace base {
+class TickClock;
+}  // namespace base
+
+namespace net {
+class URLRequestContextGetter;
+}  // namespace net
+
+namespace brave_rewards {
+
+// Issues the ledger's network requests.
+//
+// Identical GETs that are already queued or in flight are coalesced into a
+// single fetch, at most |max_requests_per_host| fetches run against one host
+// at a time, user visible requests are started ahead of background ones,
+// and hosts whose GETs fail have their GETs backed off with jittered
+// exponential delays. Failed GETs are retried; other methods are reported
+// as-is since they are not safe to replay, and are never held back by a
+// backoff they can't clear.
+class LedgerURLScheduler : public net::URLFetcherDelegate {
+ public:
+  enum Priority {
+    BACKGROUND = 0,
+    USER_VISIBLE,
+    NUM_PRIORITIES,
+  };
+
+  struct Request {
+    Request();
+    Request(const Request& request);
+    ~Request();
+
+    GURL url;
+    net::URLFetcher::RequestType method;
+    std::vector<std::string> headers;
+    std::string content;
+    std::string content_type;
+    Priority priority;
+  };
+
+  using FetchCallback = base::Callback<void(
+      int response_code,
+      const std::string& body,
+      const std::map<std::string, std::string>& headers)>;
+
+  // |tick_clock| may be null, in which case the default tick clock is used.
+  LedgerURLScheduler(
+      scoped_refptr<net::URLRequestContextGetter> request_context,
+      const base::TickClock* tick_clock = nullptr);
+  ~LedgerURLScheduler() override;
+
+  void Schedule(const Request& request, const FetchCallback& callback);
+
+  // Drops every queued and in-flight request without running callbacks.
+  void CancelAll();
+
+  void set_max_requests_per_host(size_t max) { max_requests_per_host_ = max; }
+  void SetBackoffPolicyForTesting(const net::BackoffEntry::Policy* policy);
+
+  size_t num_in_flight() const { return in_flight_.size(); }
+
+  base::WeakPtr<LedgerURLScheduler> AsWeakPtr() {
+    return weak_factory_.GetWeakPtr();
+  }
+
+ private:
+  struct Job;
+  struct HostState {
+    HostState();
+    ~HostState();
+
+    size_t active;
+    std::unique_ptr<net::BackoffEntry> backoff;
+  };
+
+  HostState* GetHostState(const std::string& host);
+  void Pump();
+  void StartJob(std::unique_ptr<Job> job);
+  void FinishJob(std::unique_ptr<Job> job,
+                 int response_code,
+                 const std::string& body,
+                 const std::map<std::string, std::string>& headers);
+
+  // net::URLFetcherDelegate:
+  void OnURLFetchComplete(const net::URLFetcher* source) override;
+
+  scoped_refptr<net::URLRequestContextGetter> request_context_;
+  const base::TickClock* tick_clock_;  // NOT OWNED
+  const net::BackoffEntry::Policy* backoff_policy_;
+  size_t max_requests_per_host_;
+
+  std::deque<std::unique_ptr<Job>> queues_[NUM_PRIORITIES];
+  std::map<const net::URLFetcher*, std::unique_ptr<Job>> in_flight_;
+  // Queued or in-flight GETs by request key, for coalescing duplicates.
+  std::map<std::string, Job*> pending_gets_;
+  std::map<std::string, std::unique_ptr<HostState>> hosts_;
+  base::OneShotTimer backoff_timer_;
+
+  base::WeakPtrFactory<LedgerURLScheduler> weak_factory_;
+
+  DISALLOW_COPY_AND_ASSIGN(LedgerURLScheduler);
+};
+
+}  // namespace brave_rewards
+
+#endif  // BRAVE_COMPONENTS_BRAVE_REWARDS_BROWSER_LEDGER_URL_SCHEDULER_H_
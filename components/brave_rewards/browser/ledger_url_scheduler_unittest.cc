@@ -0,0 +1,259 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_rewards/browser/ledger_url_scheduler.h"
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/bind.h"
+#include "base/run_loop.h"
+#include "base/synchronization/lock.h"
+#include "content/public/browser/browser_thread.h"
+#include "content/public/test/test_browser_thread_bundle.h"
+#include "net/http/http_status_code.h"
+#include "net/test/embedded_test_server/embedded_test_server.h"
+#include "net/test/embedded_test_server/http_request.h"
+#include "net/test/embedded_test_server/http_response.h"
+#include "net/url_request/url_request_test_util.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+// npm run test -- brave_unit_tests --filter=LedgerURLSchedulerTest.*
+
+namespace brave_rewards {
+
+namespace {
+
+const net::BackoffEntry::Policy kNoDelayBackoffPolicy = {
+  0,      // num_errors_to_ignore
+  0,      // initial_delay_ms
+  2,      // multiply_factor
+  0,      // jitter_factor
+  0,      // maximum_backoff_ms
+  -1,     // entry_lifetime_ms
+  false,  // always_use_initial_delay
+};
+
+const net::BackoffEntry::Policy kSlowBackoffPolicy = {
+  0,          // num_errors_to_ignore
+  60 * 1000,  // initial_delay_ms
+  2,          // multiply_factor
+  0,          // jitter_factor
+  60 * 1000,  // maximum_backoff_ms
+  -1,         // entry_lifetime_ms
+  false,      // always_use_initial_delay
+};
+
+}  // namespace
+
+// Stands in for the ledger endpoints: /ok answers 200, /error always 503
+// and /flaky 503s its first two hits.
+class LedgerURLSchedulerTest : public testing::Test {
+ public:
+  LedgerURLSchedulerTest()
+      : thread_bundle_(content::TestBrowserThreadBundle::IO_MAINLOOP) {}
+  ~LedgerURLSchedulerTest() override {}
+
+ protected:
+  void SetUp() override {
+    server_.RegisterRequestHandler(base::BindRepeating(
+        &LedgerURLSchedulerTest::HandleRequest, base::Unretained(this)));
+    ASSERT_TRUE(server_.Start());
+
+    context_getter_ = new net::TestURLRequestContextGetter(
+        content::BrowserThread::GetTaskRunnerForThread(
+            content::BrowserThread::IO));
+    scheduler_ = std::make_unique<LedgerURLScheduler>(context_getter_);
+    scheduler_->SetBackoffPolicyForTesting(&kNoDelayBackoffPolicy);
+  }
+
+  void TearDown() override {
+    scheduler_.reset();
+    ASSERT_TRUE(server_.ShutdownAndWaitUntilComplete());
+  }
+
+  std::unique_ptr<net::test_server::HttpResponse> HandleRequest(
+      const net::test_server::HttpRequest& request) {
+    auto response = std::make_unique<net::test_server::BasicHttpResponse>();
+    base::AutoLock lock(lock_);
+    received_.push_back(request.relative_url);
+    const std::string path = request.GetURL().path();
+    int hits = ++hits_[path];
+    if (path == "/error" || (path == "/flaky" && hits <= 2)) {
+      response->set_code(net::HTTP_SERVICE_UNAVAILABLE);
+      return std::move(response);
+    }
+    response->set_code(net::HTTP_OK);
+    response->set_content("ok");
+    return std::move(response);
+  }
+
+  void Schedule(const std::string& relative_url,
+                net::URLFetcher::RequestType method,
+                LedgerURLScheduler::Priority priority) {
+    LedgerURLScheduler::Request request;
+    request.url = server_.GetURL(relative_url);
+    request.method = method;
+    request.priority = priority;
+    if (method != net::URLFetcher::GET) {
+      request.content = "{}";
+      request.content_type = "application/json";
+    }
+    pending_++;
+    scheduler_->Schedule(request,
+        base::Bind(&LedgerURLSchedulerTest::OnFetched,
+                   base::Unretained(this)));
+  }
+
+  void ScheduleGet(const std::string& relative_url) {
+    Schedule(relative_url, net::URLFetcher::GET,
+             LedgerURLScheduler::BACKGROUND);
+  }
+
+  void OnFetched(int response_code,
+                 const std::string& body,
+                 const std::map<std::string, std::string>& headers) {
+    response_codes_.push_back(response_code);
+    bodies_.push_back(body);
+    --pending_;
+    if (run_loop_ && (pending_ == 0 || response_codes_.size() == wait_for_))
+      run_loop_->Quit();
+  }
+
+  void WaitForResponses() {
+    if (pending_ == 0)
+      return;
+    run_loop_ = std::make_unique<base::RunLoop>();
+    run_loop_->Run();
+    run_loop_.reset();
+  }
+
+  // Returns once |count| responses arrived, even if others are pending.
+  void WaitForResponseCount(size_t count) {
+    if (response_codes_.size() >= count)
+      return;
+    wait_for_ = count;
+    WaitForResponses();
+    wait_for_ = 0;
+  }
+
+  int Hits(const std::string& path) {
+    base::AutoLock lock(lock_);
+    return hits_[path];
+  }
+
+  std::vector<std::string> Received() {
+    base::AutoLock lock(lock_);
+    return received_;
+  }
+
+  content::TestBrowserThreadBundle thread_bundle_;
+  net::EmbeddedTestServer server_;
+  scoped_refptr<net::TestURLRequestContextGetter> context_getter_;
+  std::unique_ptr<LedgerURLScheduler> scheduler_;
+  std::unique_ptr<base::RunLoop> run_loop_;
+  int pending_ = 0;
+  size_t wait_for_ = 0;
+  std::vector<int> response_codes_;
+  std::vector<std::string> bodies_;
+
+  base::Lock lock_;
+  std::map<std::string, int> hits_;
+  std::vector<std::string> received_;
+};
+
+TEST_F(LedgerURLSchedulerTest, CoalescesDuplicateGets) {
+  ScheduleGet("/ok?wallet");
+  ScheduleGet("/ok?wallet");
+  EXPECT_EQ(1u, scheduler_->num_in_flight());
+  WaitForResponses();
+
+  EXPECT_EQ(1, Hits("/ok"));
+  ASSERT_EQ(2u, response_codes_.size());
+  EXPECT_EQ(net::HTTP_OK, response_codes_[0]);
+  EXPECT_EQ(net::HTTP_OK, response_codes_[1]);
+  EXPECT_EQ("ok", bodies_[0]);
+  EXPECT_EQ("ok", bodies_[1]);
+}
+
+TEST_F(LedgerURLSchedulerTest, DoesNotCoalescePosts) {
+  Schedule("/ok", net::URLFetcher::POST, LedgerURLScheduler::BACKGROUND);
+  Schedule("/ok", net::URLFetcher::POST, LedgerURLScheduler::BACKGROUND);
+  WaitForResponses();
+
+  EXPECT_EQ(2, Hits("/ok"));
+  EXPECT_EQ(2u, response_codes_.size());
+}
+
+TEST_F(LedgerURLSchedulerTest, LimitsRequestsPerHost) {
+  scheduler_->set_max_requests_per_host(2);
+  ScheduleGet("/ok?a");
+  ScheduleGet("/ok?b");
+  ScheduleGet("/ok?c");
+  EXPECT_EQ(2u, scheduler_->num_in_flight());
+  WaitForResponses();
+
+  EXPECT_EQ(3, Hits("/ok"));
+  EXPECT_EQ(0u, scheduler_->num_in_flight());
+}
+
+TEST_F(LedgerURLSchedulerTest, StartsUserVisibleRequestsFirst) {
+  scheduler_->set_max_requests_per_host(1);
+  ScheduleGet("/ok?publishers");
+  ScheduleGet("/ok?reconcile");
+  Schedule("/ok?banner", net::URLFetcher::GET,
+           LedgerURLScheduler::USER_VISIBLE);
+  WaitForResponses();
+
+  std::vector<std::string> received = Received();
+  ASSERT_EQ(3u, received.size());
+  EXPECT_EQ("/ok?publishers", received[0]);
+  EXPECT_EQ("/ok?banner", received[1]);
+  EXPECT_EQ("/ok?reconcile", received[2]);
+}
+
+TEST_F(LedgerURLSchedulerTest, RetriesFailedGets) {
+  ScheduleGet("/flaky");
+  WaitForResponses();
+
+  EXPECT_EQ(3, Hits("/flaky"));
+  ASSERT_EQ(1u, response_codes_.size());
+  EXPECT_EQ(net::HTTP_OK, response_codes_[0]);
+}
+
+TEST_F(LedgerURLSchedulerTest, DoesNotRetryPosts) {
+  Schedule("/error", net::URLFetcher::POST, LedgerURLScheduler::BACKGROUND);
+  WaitForResponses();
+
+  EXPECT_EQ(1, Hits("/error"));
+  ASSERT_EQ(1u, response_codes_.size());
+  EXPECT_EQ(net::HTTP_SERVICE_UNAVAILABLE, response_codes_[0]);
+}
+
+TEST_F(LedgerURLSchedulerTest, BackoffOnlyHoldsGets) {
+  scheduler_->SetBackoffPolicyForTesting(&kSlowBackoffPolicy);
+  scheduler_->set_max_requests_per_host(1);
+  ScheduleGet("/error");
+  Schedule("/ok", net::URLFetcher::POST, LedgerURLScheduler::BACKGROUND);
+  WaitForResponseCount(1);
+
+  // the failed GET waits out its backoff, the POST queued behind it doesn't
+  EXPECT_EQ(1, Hits("/error"));
+  EXPECT_EQ(1, Hits("/ok"));
+  ASSERT_EQ(1u, response_codes_.size());
+  EXPECT_EQ(net::HTTP_OK, response_codes_[0]);
+}
+
+TEST_F(LedgerURLSchedulerTest, GivesUpAfterMaxRetries) {
+  ScheduleGet("/error");
+  WaitForResponses();
+
+  EXPECT_EQ(4, Hits("/error"));
+  ASSERT_EQ(1u, response_codes_.size());
+  EXPECT_EQ(net::HTTP_SERVICE_UNAVAILABLE, response_codes_[0]);
+}
+
+}  // namespace brave_rewards
@@ -0,0 +1,92 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_rewards/browser/net/media_request_filter.h"
+
+#include "base/memory/singleton.h"
+#include "base/strings/string_util.h"
+#include "url/gurl.h"
+
+namespace brave_rewards {
+
+MediaRequestPredicate::MediaRequestPredicate() {}
+
+MediaRequestPredicate::MediaRequestPredicate(
+    const std::string& host,
+    const std::string& first_party_host,
+    const std::string& path_prefix)
+    : host(host),
+      first_party_host(first_party_host),
+      path_prefix(path_prefix) {}
+
+MediaRequestPredicate::MediaRequestPredicate(
+    const MediaRequestPredicate& predicate) = default;
+
+MediaRequestPredicate::~MediaRequestPredicate() {}
+
+bool MediaRequestPredicate::Matches(const GURL& url,
+                                    const GURL& first_party_url,
+                                    const GURL& referrer) const {
+  if (!host.empty() && !url.DomainIs(host))
+    return false;
+
+  if (!first_party_host.empty() &&
+      !first_party_url.DomainIs(first_party_host) &&
+      !referrer.DomainIs(first_party_host)) {
+    return false;
+  }
+
+  if (!path_prefix.empty() &&
+      !base::StartsWith(url.path_piece(), path_prefix,
+                        base::CompareCase::SENSITIVE)) {
+    return false;
+  }
+
+  return true;
+}
+
+// static
+MediaRequestFilter* MediaRequestFilter::GetInstance() {
+  return base::Singleton<MediaRequestFilter>::get();
+}
+
+MediaRequestFilter::MediaRequestFilter() {
+}
+
+MediaRequestFilter::~MediaRequestFilter() {
+}
+
+void MediaRequestFilter::SetPredicates(
+    const std::vector<MediaRequestPredicate>& predicates) {
+  base::AutoLock lock(lock_);
+  predicates_ = predicates;
+}
+
+bool MediaRequestFilter::Matches(const GURL& url,
+                                 const GURL& first_party_url,
+                                 const GURL& referrer) const {
+  if (!url.SchemeIsHTTPOrHTTPS())
+    return false;
+
+  base::AutoLock lock(lock_);
+  for (const auto& predicate : predicates_) {
+    if (predicate.Matches(url, first_party_url, referrer))
+      return true;
+  }
+  return false;
+}
+
+// static
+std::vector<MediaRequestPredicate> MediaRequestFilter::GetDefaultPredicates() {
+  return {
+    // YouTube reports playback through its watch time stats pings.
+    MediaRequestPredicate("youtube.com", std::string(), "/api/stats/"),
+    // Twitch reports playback events from the player via POST, to hosts that
+    // vary, so only the first party is fixed. Embedded players have the
+    // Twitch player as referrer instead.
+    MediaRequestPredicate(std::string(), "twitch.tv", std::string()),
+  };
+}
+
+}  // namespace brave_rewards
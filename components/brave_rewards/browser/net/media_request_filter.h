@@ -0,0 +1,81 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_COMPONENTS_BRAVE_REWARDS_BROWSER_NET_MEDIA_REQUEST_FILTER_H_
+#define BRAVE_COMPONENTS_BRAVE_REWARDS_BROWSER_NET_MEDIA_REQUEST_FILTER_H_
+
+#include <string>
+#include <vector>
+
+#include "base/macros.h"
+#include "base/synchronization/lock.h"
+
+class GURL;
+
+namespace base {
+template <typename T>
+struct DefaultSingletonTraits;
+}  // namespace base
+
+namespace brave_rewards {
+
+// Describes requests a media provider may report playback through. Empty
+// fields match anything.
+struct MediaRequestPredicate {
+  MediaRequestPredicate();
+  MediaRequestPredicate(const std::string& host,
+                        const std::string& first_party_host,
+                        const std::string& path_prefix);
+  MediaRequestPredicate(const MediaRequestPredicate& predicate);
+  ~MediaRequestPredicate();
+
+  bool Matches(const GURL& url,
+               const GURL& first_party_url,
+               const GURL& referrer) const;
+
+  // Registrable domain the request URL must belong to.
+  std::string host;
+  // Registrable domain the first party URL or the referrer must belong to.
+  // The referrer covers players embedded on other sites.
+  std::string first_party_host;
+  std::string path_prefix;
+};
+
+// Cheap, allocation free prefilter for media XHR and POST capture.
+//
+// Checked on the IO thread before a request's upload body is copied or any
+// task is posted, and on the UI thread before XHR query strings are decoded,
+// so only requests that could belong to a supported media provider reach
+// the ledger. The ledger's own IsMediaLink check still makes the final call.
+class MediaRequestFilter {
+ public:
+  static MediaRequestFilter* GetInstance();
+
+  // Replaces the registered predicates. Nothing matches until the rewards
+  // service registers its providers. Called on the UI thread.
+  void SetPredicates(const std::vector<MediaRequestPredicate>& predicates);
+
+  // May be called from any thread.
+  bool Matches(const GURL& url,
+               const GURL& first_party_url,
+               const GURL& referrer) const;
+
+  // Predicates for the media providers the ledger currently supports.
+  static std::vector<MediaRequestPredicate> GetDefaultPredicates();
+
+ private:
+  friend struct base::DefaultSingletonTraits<MediaRequestFilter>;
+
+  MediaRequestFilter();
+  ~MediaRequestFilter();
+
+  mutable base::Lock lock_;
+  std::vector<MediaRequestPredicate> predicates_;
+
+  DISALLOW_COPY_AND_ASSIGN(MediaRequestFilter);
+};
+
+}  // namespace brave_rewards
+
+#endif  // BRAVE_COMPONENTS_BRAVE_REWARDS_BROWSER_NET_MEDIA_REQUEST_FILTER_H_
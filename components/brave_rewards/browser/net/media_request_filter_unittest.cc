@@ -0,0 +1,97 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_rewards/browser/net/media_request_filter.h"
+
+#include <vector>
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "url/gurl.h"
+
+// npm run test -- brave_unit_tests --filter=MediaRequestFilterTest.*
+
+namespace brave_rewards {
+
+class MediaRequestFilterTest : public testing::Test {
+ public:
+  MediaRequestFilterTest() {}
+  ~MediaRequestFilterTest() override {}
+
+ protected:
+  void SetUp() override {
+    filter()->SetPredicates(MediaRequestFilter::GetDefaultPredicates());
+  }
+
+  void TearDown() override {
+    filter()->SetPredicates(std::vector<MediaRequestPredicate>());
+  }
+
+  MediaRequestFilter* filter() { return MediaRequestFilter::GetInstance(); }
+};
+
+TEST_F(MediaRequestFilterTest, MatchesYouTubeStats) {
+  EXPECT_TRUE(filter()->Matches(
+      GURL("https://www.youtube.com/api/stats/watchtime?docid=abc&st=1"),
+      GURL("https://www.youtube.com/watch?v=abc"), GURL()));
+  EXPECT_TRUE(filter()->Matches(
+      GURL("https://m.youtube.com/api/stats/watchtime?docid=abc"),
+      GURL("https://m.youtube.com/"), GURL()));
+}
+
+TEST_F(MediaRequestFilterTest, RejectsOtherYouTubeRequests) {
+  EXPECT_FALSE(filter()->Matches(
+      GURL("https://www.youtube.com/upload"),
+      GURL("https://www.youtube.com/upload"), GURL()));
+  EXPECT_FALSE(filter()->Matches(
+      GURL("https://notyoutube.com/api/stats/watchtime"),
+      GURL("https://notyoutube.com/"), GURL()));
+}
+
+TEST_F(MediaRequestFilterTest, MatchesTwitchFirstParty) {
+  EXPECT_TRUE(filter()->Matches(
+      GURL("https://spade.twitch.tv/track"),
+      GURL("https://www.twitch.tv/somechannel"), GURL()));
+  EXPECT_FALSE(filter()->Matches(
+      GURL("https://spade.twitch.tv/track"),
+      GURL("https://example.com/"), GURL()));
+}
+
+TEST_F(MediaRequestFilterTest, MatchesTwitchEmbeddedPlayer) {
+  // a Twitch player embedded on another site
+  EXPECT_TRUE(filter()->Matches(
+      GURL("https://spade.twitch.tv/track"),
+      GURL("https://example.com/"),
+      GURL("https://player.twitch.tv/?channel=somechannel")));
+  EXPECT_FALSE(filter()->Matches(
+      GURL("https://spade.twitch.tv/track"),
+      GURL("https://example.com/"),
+      GURL("https://example.com/page")));
+}
+
+TEST_F(MediaRequestFilterTest, RejectsUnrelatedUploads) {
+  EXPECT_FALSE(filter()->Matches(
+      GURL("https://upload.example.com/files"),
+      GURL("https://example.com/"), GURL()));
+  EXPECT_FALSE(filter()->Matches(
+      GURL("chrome://rewards/"),
+      GURL("https://www.twitch.tv/"), GURL()));
+}
+
+TEST_F(MediaRequestFilterTest, NothingMatchesWithoutPredicates) {
+  filter()->SetPredicates(std::vector<MediaRequestPredicate>());
+  EXPECT_FALSE(filter()->Matches(
+      GURL("https://www.youtube.com/api/stats/watchtime?docid=abc"),
+      GURL("https://www.youtube.com/watch?v=abc"), GURL()));
+}
+
+TEST_F(MediaRequestFilterTest, CustomPredicate) {
+  filter()->SetPredicates({
+      MediaRequestPredicate("vimeo.com", std::string(), "/log/")});
+  EXPECT_TRUE(filter()->Matches(GURL("https://player.vimeo.com/log/play"),
+                                GURL("https://vimeo.com/1"), GURL()));
+  EXPECT_FALSE(filter()->Matches(GURL("https://player.vimeo.com/video/1"),
+                                 GURL("https://vimeo.com/1"), GURL()));
+}
+
+}  // namespace brave_rewards
@@ -5,6 +5,7 @@
 #include "brave/components/brave_rewards/browser/net/network_delegate_helper.h"
 
 #include "base/task/post_task.h"
+#include "brave/components/brave_rewards/browser/net/media_request_filter.h"
 #include "brave/components/brave_rewards/browser/rewards_service.h"
 #include "brave/components/brave_rewards/browser/rewards_service_factory.h"
 #include "chrome/browser/profiles/profile.h"
@@ -129,6 +130,14 @@ int OnBeforeURLRequest(
   std::shared_ptr<brave::BraveRequestInfo> ctx) {
   DCHECK_CURRENTLY_ON(content::BrowserThread::IO);
 
+  // Cheap checks first so unrelated uploads never pay for a body copy.
+  if (!ctx->request->has_upload() ||
+      !MediaRequestFilter::GetInstance()->Matches(
+          ctx->request_url, ctx->request->site_for_cookies(),
+          GURL(ctx->request->referrer()))) {
+    return net::OK;
+  }
+
   if (IsMediaLink(ctx->request_url,
                   ctx->request->site_for_cookies(),
                   GURL(ctx->request->referrer()))) {
@@ -11,6 +11,7 @@
 #include "base/bind.h"
 #include "base/command_line.h"
 #include "base/files/file_util.h"
+#include "base/strings/stringprintf.h"
 #include "bat/ledger/media_publisher_info.h"
 #include "build/build_config.h"
 #include "sql/meta_table.h"
@@ -25,6 +26,25 @@ namespace {
 const int kCurrentVersionNumber = 2;
 const int kCompatibleVersionNumber = 1;
 
+// Upper bound on the part of the file reads are served from by mmap.
+const int kMmapSize = 32 * 1024 * 1024;
+
+// Free pages returned to the file system per maintenance run, so a large
+// cleanup is spread over several idle periods.
+const int kIncrementalVacuumPages = 1024;
+
+// Value of PRAGMA auto_vacuum in incremental mode.
+const int kAutoVacuumIncremental = 2;
+
+const char kLastMaintenanceKey[] = "last_maintenance";
+
+constexpr base::TimeDelta kMaintenanceInterval = base::TimeDelta::FromDays(1);
+
+// Months are numbered 1 to 12, as in ledger::PUBLISHER_MONTH.
+int GetPeriod(int month, int year) {
+  return year * 12 + month - 1;
+}
+
 }  // namespace
 
 PublisherInfoDatabase::PublisherInfoDatabase(const base::FilePath& db_path) :
@@ -42,9 +62,25 @@ bool PublisherInfoDatabase::Init() {
   if (initialized_)
     return true;
 
+  // The database is only ever opened by this object, so hold the lock for
+  // the lifetime of the connection. This also lets WAL mode keep its index
+  // in heap memory instead of a shared memory file.
+  db_.set_exclusive_locking();
+
   if (!db_.Open(db_path_))
     return false;
 
+  // Writes go to the write-ahead log so the frequent activity updates don't
+  // rewrite the main file, and reads are served from a bounded mmap window.
+  ignore_result(db_.Execute("PRAGMA journal_mode=WAL"));
+  ignore_result(db_.Execute("PRAGMA synchronous=NORMAL"));
+  ignore_result(db_.Execute(
+      base::StringPrintf("PRAGMA mmap_size=%d", kMmapSize).c_str()));
+
+  // Only takes effect for a new database. Existing ones are converted by
+  // the first RunMaintenance().
+  ignore_result(db_.Execute("PRAGMA auto_vacuum=INCREMENTAL"));
+
   // TODO - add error delegate
   sql::Transaction committer(&db_);
   if (!committer.Begin())
@@ -109,9 +145,15 @@ bool PublisherInfoDatabase::CreateContributionInfoTable() {
 bool PublisherInfoDatabase::CreateContributionInfoIndex() {
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
 
-  return GetDB().Execute(
+  if (!GetDB().Execute(
       "CREATE INDEX IF NOT EXISTS contribution_info_publisher_id_index "
-      "ON contribution_info (publisher_id)");
+      "ON contribution_info (publisher_id)")) {
+    return false;
+  }
+
+  return GetDB().Execute(
+      "CREATE INDEX IF NOT EXISTS contribution_info_period_index "
+      "ON contribution_info (year, month)");
 }
 
 bool PublisherInfoDatabase::CreatePublisherInfoTable() {
@@ -169,9 +211,16 @@ bool PublisherInfoDatabase::CreateActivityInfoTable() {
 bool PublisherInfoDatabase::CreateActivityInfoIndex() {
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
 
-  return GetDB().Execute(
+  if (!GetDB().Execute(
       "CREATE INDEX IF NOT EXISTS activity_info_publisher_id_index "
-      "ON activity_info (publisher_id)");
+      "ON activity_info (publisher_id)")) {
+    return false;
+  }
+
+  // Covers the month, year and reconcile stamp filters used by Find().
+  return GetDB().Execute(
+      "CREATE INDEX IF NOT EXISTS activity_info_period_index "
+      "ON activity_info (year, month, category, reconcile_stamp)");
 }
 
 bool PublisherInfoDatabase::CreateMediaPublisherInfoTable() {
@@ -680,6 +729,152 @@ void PublisherInfoDatabase::Vacuum() {
   ignore_result(db_.Execute("VACUUM"));
 }
 
+bool PublisherInfoDatabase::RunMaintenance(const base::Time& now,
+                                           uint64_t reconcile_stamp,
+                                           int retention_months) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+
+  bool initialized = Init();
+  DCHECK(initialized);
+
+  if (!initialized)
+    return false;
+
+  int64_t last_maintenance = 0;
+  if (meta_table_.GetValue(kLastMaintenanceKey, &last_maintenance)) {
+    base::Time last = base::Time::FromTimeT(last_maintenance);
+    if (last <= now && now - last < kMaintenanceInterval)
+      return true;
+  }
+
+  base::Time::Exploded exploded;
+  now.LocalExplode(&exploded);
+  const int period = GetPeriod(exploded.month, exploded.year);
+
+  if (!RollUpActivityInfo(period, reconcile_stamp))
+    return false;
+
+  if (retention_months > 0 && !DeleteExpiredRows(period - retention_months))
+    return false;
+
+  if (!EnsureIncrementalVacuum())
+    return false;
+
+  IncrementalVacuum();
+
+  return meta_table_.SetValue(kLastMaintenanceKey,
+                              static_cast<int64_t>(now.ToTimeT()));
+}
+
+bool PublisherInfoDatabase::RollUpActivityInfo(int period,
+                                               uint64_t reconcile_stamp) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+
+  sql::Transaction transaction(&GetDB());
+  if (!transaction.Begin())
+    return false;
+
+  if (!GetDB().Execute("DROP TABLE IF EXISTS temp.activity_info_rollup"))
+    return false;
+
+  // Rows of a month before the current one that belong to a finished
+  // reconcile period are merged into one row per publisher and category.
+  // With a single max() aggregate SQLite takes the bare percent and weight
+  // columns from the latest period's row.
+  sql::Statement rollup(GetDB().GetUniqueStatement(
+      "CREATE TEMP TABLE activity_info_rollup AS "
+      "SELECT publisher_id, SUM(duration) AS duration, SUM(score) AS score, "
+      "percent, weight, category, month, year, "
+      "MAX(reconcile_stamp) AS reconcile_stamp "
+      "FROM activity_info "
+      "WHERE (year * 12 + month - 1) < ? AND reconcile_stamp < ? "
+      "GROUP BY publisher_id, category, month, year "
+      "HAVING COUNT(*) > 1"));
+  rollup.BindInt(0, period);
+  rollup.BindInt64(1, reconcile_stamp);
+  if (!rollup.Run())
+    return false;
+
+  sql::Statement remove(GetDB().GetUniqueStatement(
+      "DELETE FROM activity_info "
+      "WHERE reconcile_stamp < ? AND EXISTS ("
+      "SELECT 1 FROM activity_info_rollup AS r "
+      "WHERE r.publisher_id = activity_info.publisher_id "
+      "AND r.category = activity_info.category "
+      "AND r.month = activity_info.month "
+      "AND r.year = activity_info.year)"));
+  remove.BindInt64(0, reconcile_stamp);
+  if (!remove.Run())
+    return false;
+
+  if (!GetDB().Execute(
+      "INSERT INTO activity_info "
+      "(publisher_id, duration, score, percent, "
+      "weight, category, month, year, reconcile_stamp) "
+      "SELECT publisher_id, duration, score, percent, "
+      "weight, category, month, year, reconcile_stamp "
+      "FROM activity_info_rollup")) {
+    return false;
+  }
+
+  if (!GetDB().Execute("DROP TABLE activity_info_rollup"))
+    return false;
+
+  return transaction.Commit();
+}
+
+bool PublisherInfoDatabase::DeleteExpiredRows(int oldest_period) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+
+  sql::Transaction transaction(&GetDB());
+  if (!transaction.Begin())
+    return false;
+
+  // Only browsing activity expires. contribution_info is the user's tip and
+  // contribution history and is never deleted here.
+  sql::Statement activity(GetDB().GetUniqueStatement(
+      "DELETE FROM activity_info WHERE (year * 12 + month - 1) < ?"));
+  activity.BindInt(0, oldest_period);
+  if (!activity.Run())
+    return false;
+
+  return transaction.Commit();
+}
+
+bool PublisherInfoDatabase::EnsureIncrementalVacuum() {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+
+  {
+    sql::Statement auto_vacuum(
+        GetDB().GetUniqueStatement("PRAGMA auto_vacuum"));
+    if (!auto_vacuum.Step())
+      return false;
+    if (auto_vacuum.ColumnInt(0) == kAutoVacuumIncremental)
+      return true;
+  }
+
+  // Switching an existing database takes a full vacuum, once.
+  if (!GetDB().Execute("PRAGMA auto_vacuum=INCREMENTAL"))
+    return false;
+
+  DCHECK_EQ(0, db_.transaction_nesting()) <<
+      "Can not have a transaction when vacuuming.";
+  return GetDB().Execute("VACUUM");
+}
+
+void PublisherInfoDatabase::IncrementalVacuum() {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+
+  // Step until done; the pragma may free its pages over several steps.
+  sql::Statement vacuum(GetDB().GetUniqueStatement(
+      base::StringPrintf("PRAGMA incremental_vacuum(%d)",
+                         kIncrementalVacuumPages).c_str()));
+  while (vacuum.Step()) {}
+
+  // Fold the log back into the main file so it doesn't keep the space.
+  ignore_result(GetDB().Execute("PRAGMA wal_checkpoint(TRUNCATE)"));
+}
+
 void PublisherInfoDatabase::OnMemoryPressure(
     base::MemoryPressureListener::MemoryPressureLevel memory_pressure_level) {
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
@@ -13,6 +13,7 @@
 #include "base/macros.h"
 #include "base/memory/memory_pressure_listener.h"
 #include "base/sequence_checker.h"
+#include "base/time/time.h"
 #include "bat/ledger/publisher_info.h"
 #include "brave/components/brave_rewards/browser/contribution_info.h"
 #include "brave/components/brave_rewards/browser/recurring_donation.h"
@@ -58,6 +59,16 @@ class PublisherInfoDatabase {
   // unused space in the file. It can be VERY SLOW.
   void Vacuum();
 
+  // Keeps the database size bounded. Activity from past reconcile periods
+  // is rolled up into one row per publisher and month, activity older than
+  // |retention_months| whole months is deleted (0 keeps everything) and
+  // a bounded number of free pages are returned to the file system. Does
+  // nothing if it already ran within the last day. Meant to be run while
+  // the user is idle.
+  bool RunMaintenance(const base::Time& now,
+                      uint64_t reconcile_stamp,
+                      int retention_months);
+
   std::string GetDiagnosticInfo(int extended_error, sql::Statement* statement);
 
  private:
@@ -73,6 +84,11 @@ class PublisherInfoDatabase {
   bool CreateRecurringDonationTable();
   bool CreateRecurringDonationIndex();
 
+  bool RollUpActivityInfo(int period, uint64_t reconcile_stamp);
+  bool DeleteExpiredRows(int oldest_period);
+  bool EnsureIncrementalVacuum();
+  void IncrementalVacuum();
+
   std::string BuildClauses(int start,
                            int limit,
                            const ledger::PublisherInfoFilter& filter);
@@ -0,0 +1,170 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_rewards/browser/publisher_info_database.h"
+
+#include <memory>
+#include <string>
+
+#include "base/files/scoped_temp_dir.h"
+#include "base/time/time.h"
+#include "bat/ledger/publisher_info.h"
+#include "brave/components/brave_rewards/browser/contribution_info.h"
+#include "sql/database.h"
+#include "sql/statement.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+// npm run test -- brave_unit_tests --filter=PublisherInfoDatabaseTest.*
+
+namespace brave_rewards {
+
+namespace {
+
+ledger::PublisherInfo MakeActivity(const std::string& id,
+                                   int month,
+                                   int year,
+                                   uint64_t reconcile_stamp,
+                                   uint64_t duration) {
+  ledger::PublisherInfo info(
+      id, static_cast<ledger::PUBLISHER_MONTH>(month), year);
+  info.category = ledger::PUBLISHER_CATEGORY::AUTO_CONTRIBUTE;
+  info.duration = duration;
+  info.score = duration;
+  info.reconcile_stamp = reconcile_stamp;
+  info.name = id;
+  info.url = "https://" + id;
+  info.provider = "";
+  info.favicon_url = "";
+  return info;
+}
+
+base::Time MakeTime(int month, int year) {
+  base::Time::Exploded exploded = {};
+  exploded.year = year;
+  exploded.month = month;
+  exploded.day_of_month = 15;
+  exploded.hour = 12;
+  base::Time time;
+  EXPECT_TRUE(base::Time::FromLocalExploded(exploded, &time));
+  return time;
+}
+
+}  // namespace
+
+class PublisherInfoDatabaseTest : public testing::Test {
+ public:
+  PublisherInfoDatabaseTest() {}
+  ~PublisherInfoDatabaseTest() override {}
+
+ protected:
+  void SetUp() override {
+    ASSERT_TRUE(temp_dir_.CreateUniqueTempDir());
+    database_ = std::make_unique<PublisherInfoDatabase>(
+        temp_dir_.GetPath().AppendASCII("publisher_info_db"));
+  }
+
+  ledger::PublisherInfoList FindMonth(int month, int year) {
+    ledger::PublisherInfoFilter filter;
+    filter.month = static_cast<ledger::PUBLISHER_MONTH>(month);
+    filter.year = year;
+    filter.excluded = ledger::PUBLISHER_EXCLUDE_FILTER::FILTER_ALL;
+    ledger::PublisherInfoList list;
+    EXPECT_TRUE(database_->Find(0, 0, filter, &list));
+    return list;
+  }
+
+  base::ScopedTempDir temp_dir_;
+  std::unique_ptr<PublisherInfoDatabase> database_;
+};
+
+TEST_F(PublisherInfoDatabaseTest, RollsUpFinishedReconcilePeriods) {
+  EXPECT_TRUE(database_->InsertOrUpdatePublisherInfo(
+      MakeActivity("a.com", 1, 2018, 100, 10)));
+  EXPECT_TRUE(database_->InsertOrUpdatePublisherInfo(
+      MakeActivity("a.com", 1, 2018, 200, 20)));
+  EXPECT_TRUE(database_->InsertOrUpdatePublisherInfo(
+      MakeActivity("b.com", 1, 2018, 200, 5)));
+  ASSERT_EQ(3u, FindMonth(1, 2018).size());
+
+  EXPECT_TRUE(database_->RunMaintenance(MakeTime(3, 2018), 300, 0));
+
+  ledger::PublisherInfoList list = FindMonth(1, 2018);
+  ASSERT_EQ(2u, list.size());
+  for (const auto& info : list) {
+    if (info.id == "a.com") {
+      EXPECT_EQ(30u, info.duration);
+      EXPECT_EQ(200u, info.reconcile_stamp);
+    } else {
+      EXPECT_EQ("b.com", info.id);
+      EXPECT_EQ(5u, info.duration);
+    }
+  }
+}
+
+TEST_F(PublisherInfoDatabaseTest, KeepsCurrentReconcilePeriod) {
+  // The current period started last month.
+  EXPECT_TRUE(database_->InsertOrUpdatePublisherInfo(
+      MakeActivity("a.com", 2, 2018, 300, 10)));
+  EXPECT_TRUE(database_->InsertOrUpdatePublisherInfo(
+      MakeActivity("a.com", 2, 2018, 400, 20)));
+
+  EXPECT_TRUE(database_->RunMaintenance(MakeTime(3, 2018), 400, 0));
+
+  ledger::PublisherInfoList list = FindMonth(2, 2018);
+  ASSERT_EQ(2u, list.size());
+}
+
+TEST_F(PublisherInfoDatabaseTest, DeletesRowsPastRetention) {
+  EXPECT_TRUE(database_->InsertOrUpdatePublisherInfo(
+      MakeActivity("a.com", 1, 2016, 100, 10)));
+  EXPECT_TRUE(database_->InsertOrUpdatePublisherInfo(
+      MakeActivity("a.com", 3, 2017, 200, 10)));
+  EXPECT_TRUE(database_->InsertOrUpdatePublisherInfo(
+      MakeActivity("a.com", 2, 2018, 300, 10)));
+
+  EXPECT_TRUE(database_->RunMaintenance(MakeTime(3, 2018), 300, 12));
+
+  EXPECT_TRUE(FindMonth(1, 2016).empty());
+  EXPECT_EQ(1u, FindMonth(3, 2017).size());
+  EXPECT_EQ(1u, FindMonth(2, 2018).size());
+}
+
+TEST_F(PublisherInfoDatabaseTest, KeepsContributionsPastRetention) {
+  ContributionInfo contribution;
+  contribution.probi = "1000000000000000000";
+  contribution.month = 1;
+  contribution.year = 2016;
+  contribution.category = ledger::PUBLISHER_CATEGORY::TIPPING;
+  contribution.publisher_key = "a.com";
+  EXPECT_TRUE(database_->InsertContributionInfo(contribution));
+  EXPECT_TRUE(database_->InsertOrUpdatePublisherInfo(
+      MakeActivity("a.com", 1, 2016, 100, 10)));
+
+  EXPECT_TRUE(database_->RunMaintenance(MakeTime(3, 2018), 300, 12));
+  EXPECT_TRUE(FindMonth(1, 2016).empty());
+  database_.reset();
+
+  sql::Database db;
+  ASSERT_TRUE(db.Open(temp_dir_.GetPath().AppendASCII("publisher_info_db")));
+  sql::Statement count(
+      db.GetUniqueStatement("SELECT COUNT(*) FROM contribution_info"));
+  ASSERT_TRUE(count.Step());
+  EXPECT_EQ(1, count.ColumnInt(0));
+}
+
+TEST_F(PublisherInfoDatabaseTest, RunsAtMostDaily) {
+  EXPECT_TRUE(database_->RunMaintenance(MakeTime(3, 2018), 300, 12));
+
+  EXPECT_TRUE(database_->InsertOrUpdatePublisherInfo(
+      MakeActivity("a.com", 1, 2016, 100, 10)));
+  EXPECT_TRUE(database_->RunMaintenance(
+      MakeTime(3, 2018) + base::TimeDelta::FromHours(1), 300, 12));
+  EXPECT_EQ(1u, FindMonth(1, 2016).size());
+
+  EXPECT_TRUE(database_->RunMaintenance(
+      MakeTime(3, 2018) + base::TimeDelta::FromDays(2), 300, 12));
+  EXPECT_TRUE(FindMonth(1, 2016).empty());
+}
+
+}  // namespace brave_rewards
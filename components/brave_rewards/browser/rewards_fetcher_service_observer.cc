@@ -17,12 +17,21 @@ RewardsFetcherServiceObserver::RewardsFetcherServiceObserver(
   callback_(callback) {
 }
 
-RewardsFetcherServiceObserver::~RewardsFetcherServiceObserver() {}
+RewardsFetcherServiceObserver::~RewardsFetcherServiceObserver() {
+  // BitmapFetcherService drops failed or cancelled requests without
+  // notifying, so report those as an empty image.
+  if (callback_) {
+    callback_.Run(favicon_key_, url_, BitmapFetcherService::REQUEST_ID_INVALID,
+                  SkBitmap());
+  }
+}
 
 void RewardsFetcherServiceObserver::OnImageChanged(BitmapFetcherService::RequestId request_id,
                                                    const SkBitmap& answers_image) {
   if (callback_) {
-    callback_.Run(favicon_key_, url_, request_id, answers_image);
+    OnImageChangedCallback callback = callback_;
+    callback_.Reset();
+    callback.Run(favicon_key_, url_, request_id, answers_image);
   }
 }
 
@@ -41,6 +41,9 @@ void RewardsService::RemoveObserver(RewardsServiceObserver* observer) {
 // static
 void RewardsService::RegisterProfilePrefs(PrefRegistrySimple* registry) {
   registry->RegisterStringPref(kRewardsNotifications, "");
+  // Months of publisher activity kept in the publisher info database.
+  // 0 keeps everything. Contributions and tips are always kept.
+  registry->RegisterIntegerPref(kRewardsPublisherInfoRetentionMonths, 12);
 }
 
 }  // namespace brave_rewards
@@ -47,6 +47,14 @@ class RewardsService : public KeyedService {
   virtual void GetContentSiteList(uint32_t start,
                                   uint32_t limit,
                                 const GetContentSiteListCallback& callback) = 0;
+  // Pages showing the content site list call Start before their first
+  // RefreshContentSiteList and Stop when they go away. The list is only
+  // reloaded and diffed while a page is watching it.
+  virtual void StartContentSiteListUpdates() = 0;
+  virtual void StopContentSiteListUpdates() = 0;
+  // Reloads the content site list and sends the whole of it to observers
+  // as a reset OnContentSiteListChanged. Later changes are sent as diffs.
+  virtual void RefreshContentSiteList() = 0;
   virtual void FetchGrant(const std::string& lang, const std::string& paymentId) = 0;
   virtual void GetGrantCaptcha() = 0;
   virtual void SolveGrantCaptcha(const std::string& solution) const = 0;
@@ -8,6 +8,7 @@
 #include <limits.h>
 #include <vector>
 
+#include "base/auto_reset.h"
 #include "base/bind.h"
 #include "base/command_line.h"
 #include "base/files/file_util.h"
@@ -26,20 +27,18 @@
 #include "bat/ledger/publisher_info.h"
 #include "bat/ledger/wallet_info.h"
 #include "brave/common/brave_switches.h"
+#include "brave/common/pref_names.h"
 #include "brave/components/brave_rewards/browser/balance_report.h"
+#include "brave/components/brave_rewards/browser/net/media_request_filter.h"
 #include "brave/components/brave_rewards/browser/publisher_info_database.h"
-#include "brave/components/brave_rewards/browser/rewards_fetcher_service_observer.h"
 #include "brave/components/brave_rewards/browser/rewards_notification_service.h"
 #include "brave/components/brave_rewards/browser/rewards_notification_service_impl.h"
 #include "brave/components/brave_rewards/browser/rewards_service_factory.h"
 #include "brave/components/brave_rewards/browser/rewards_service_observer.h"
 #include "brave/components/brave_rewards/browser/wallet_properties.h"
-#include "chrome/browser/bitmap_fetcher/bitmap_fetcher_service_factory.h"
 #include "chrome/browser/browser_process_impl.h"
-#include "chrome/browser/favicon/favicon_service_factory.h"
 #include "chrome/browser/profiles/profile.h"
-#include "components/favicon/core/favicon_service.h"
-#include "components/favicon_base/favicon_types.h"
+#include "components/prefs/pref_service.h"
 #include "content/public/browser/browser_task_traits.h"
 #include "content_site.h"
 #include "extensions/buildflags/buildflags.h"
@@ -48,6 +47,7 @@
 #include "net/base/url_util.h"
 #include "net/url_request/url_fetcher.h"
 #include "publisher_banner.h"
+#include "ui/base/idle/idle.h"
 #include "ui/base/resource/resource_bundle.h"
 #include "ui/gfx/image/image.h"
 #include "url/gurl.h"
@@ -73,13 +73,19 @@ namespace {
 
 class LedgerURLLoaderImpl : public ledger::LedgerURLLoader {
  public:
-  LedgerURLLoaderImpl(uint64_t request_id, net::URLFetcher* fetcher) :
+  LedgerURLLoaderImpl(uint64_t request_id,
+                      const LedgerURLScheduler::Request& request,
+                      const LedgerURLScheduler::FetchCallback& callback,
+                      base::WeakPtr<LedgerURLScheduler> scheduler) :
     request_id_(request_id),
-    fetcher_(fetcher) {}
+    request_(request),
+    callback_(callback),
+    scheduler_(scheduler) {}
   ~LedgerURLLoaderImpl() override = default;
 
   void Start() override {
-    fetcher_->Start();
+    if (scheduler_)
+      scheduler_->Schedule(request_, callback_);
   }
 
   uint64_t request_id() override {
@@ -88,7 +94,9 @@ class LedgerURLLoaderImpl : public ledger::LedgerURLLoader {
 
  private:
   uint64_t request_id_;
-  net::URLFetcher* fetcher_;  // NOT OWNED
+  LedgerURLScheduler::Request request_;
+  LedgerURLScheduler::FetchCallback callback_;
+  base::WeakPtr<LedgerURLScheduler> scheduler_;
 };
 
 ledger::PUBLISHER_MONTH GetPublisherMonth(const base::Time& time) {
@@ -201,6 +209,34 @@ void PostWriteCallback(
                               base::Bind(callback, write_success));
 }
 
+void RunPublisherInfoMaintenanceOnFileTaskRunner(
+    base::Time now,
+    uint64_t reconcile_stamp,
+    int retention_months,
+    PublisherInfoDatabase* backend) {
+  if (backend)
+    backend->RunMaintenance(now, reconcile_stamp, retention_months);
+}
+
+// Whether an activity row saved as |info| is in the period and category
+// the content site list was loaded with.
+bool IsInContentSiteListPeriod(const ledger::PublisherInfoFilter& filter,
+                               const ledger::PublisherInfo& info) {
+  return info.category == filter.category &&
+         info.month == filter.month &&
+         info.year == filter.year &&
+         info.reconcile_stamp == filter.reconcile_stamp;
+}
+
+// Whether two content site list filters select the same rows.
+bool IsSameContentSiteListFilter(const ledger::PublisherInfoFilter& a,
+                                 const ledger::PublisherInfoFilter& b) {
+  return a.month == b.month &&
+         a.year == b.year &&
+         a.reconcile_stamp == b.reconcile_stamp &&
+         a.min_duration == b.min_duration;
+}
+
 void GetContentSiteListInternal(
     uint32_t start,
     uint32_t limit,
@@ -221,6 +257,18 @@ time_t GetCurrentTimestamp() {
 
 static uint64_t next_id = 1;
 
+// How long publisher info saves are coalesced before they are applied to the
+// content site list and sent as one diff.
+constexpr base::TimeDelta kContentSiteListRefreshDelay =
+    base::TimeDelta::FromSeconds(1);
+
+// Publisher info database maintenance waits for the user to be idle, but
+// runs anyway if the user has not been idle for a day.
+constexpr base::TimeDelta kMaintenanceCheckInterval =
+    base::TimeDelta::FromMinutes(15);
+constexpr base::TimeDelta kMaxMaintenanceDelay = base::TimeDelta::FromDays(1);
+const int kMaintenanceIdleThresholdInSeconds = 5 * 60;
+
 }  // namespace
 
 bool IsMediaLink(const GURL& url,
@@ -266,6 +314,17 @@ RewardsServiceImpl::RewardsServiceImpl(Profile* profile)
       private_observer_(
           std::make_unique<ExtensionRewardsServiceObserver>(profile_)),
 #endif
+      url_scheduler_(g_browser_process->system_request_context()),
+      user_visible_request_(false),
+      timers_(base::BindRepeating(&RewardsServiceImpl::OnTimer,
+                                  base::Unretained(this))),
+      favicon_fetcher_(profile_),
+      content_site_list_watchers_(0),
+      content_sites_loaded_(false),
+      content_sites_loading_(false),
+      content_sites_stale_(false),
+      content_sites_dirty_(false),
+      content_sites_reset_pending_(false),
       next_timer_id_(0) {
   // Environment
   #if defined(OFFICIAL_BUILD)
@@ -295,7 +354,15 @@ void RewardsServiceImpl::Init() {
   AddObserver(extension_rewards_service_observer_.get());
   private_observers_.AddObserver(private_observer_.get());
 #endif
+  MediaRequestFilter::GetInstance()->SetPredicates(
+      MediaRequestFilter::GetDefaultPredicates());
   ledger_->Initialize();
+
+  last_maintenance_ = base::TimeTicks::Now();
+  maintenance_timer_.Start(FROM_HERE,
+      kMaintenanceCheckInterval,
+      base::Bind(&RewardsServiceImpl::MaybeRunPublisherInfoMaintenance,
+                 base::Unretained(this)));
 }
 
 void RewardsServiceImpl::CreateWallet() {
@@ -311,25 +378,39 @@ void RewardsServiceImpl::CreateWallet() {
 void RewardsServiceImpl::GetContentSiteList(
     uint32_t start, uint32_t limit,
     const GetContentSiteListCallback& callback) {
-  auto now = base::Time::Now();
-  ledger::PublisherInfoFilter filter;
-  filter.category = ledger::PUBLISHER_CATEGORY::AUTO_CONTRIBUTE;
-  filter.month = GetPublisherMonth(now);
-  filter.year = GetPublisherYear(now);
-  filter.min_duration = ledger_->GetPublisherMinVisitTime();
-  filter.order_by.push_back(std::pair<std::string, bool>("ai.percent", false));
-  filter.reconcile_stamp = ledger_->GetReconcileStamp();
-  filter.excluded =
-    ledger::PUBLISHER_EXCLUDE_FILTER::FILTER_ALL_EXCEPT_EXCLUDED;
-
   ledger_->GetPublisherInfoList(start, limit,
-      filter,
+      CreateContentSiteListFilter(),
       std::bind(&GetContentSiteListInternal,
                 start,
                 limit,
                 callback, _1, _2));
 }
 
+void RewardsServiceImpl::StartContentSiteListUpdates() {
+  content_site_list_watchers_++;
+}
+
+void RewardsServiceImpl::StopContentSiteListUpdates() {
+  DCHECK_GT(content_site_list_watchers_, 0);
+  if (--content_site_list_watchers_ > 0)
+    return;
+
+  // Saves are not tracked without a watcher, so the next one starts over
+  // with a full load.
+  content_sites_timer_.Stop();
+  content_sites_loaded_ = false;
+  content_sites_stale_ = false;
+  content_sites_dirty_ = false;
+  content_sites_reset_pending_ = false;
+  pending_content_sites_.clear();
+  pending_removed_content_sites_.clear();
+}
+
+void RewardsServiceImpl::RefreshContentSiteList() {
+  content_sites_reset_pending_ = true;
+  LoadContentSiteList();
+}
+
 void RewardsServiceImpl::OnLoad(SessionID tab_id, const GURL& url) {
   auto origin = url.GetOrigin();
   const std::string baseDomain =
@@ -421,6 +502,10 @@ void RewardsServiceImpl::OnXHRLoad(SessionID tab_id,
                                    const GURL& url,
                                    const GURL& first_party_url,
                                    const GURL& referrer) {
+  if (!MediaRequestFilter::GetInstance()->Matches(url, first_party_url,
+                                                  referrer))
+    return;
+
   std::map<std::string, std::string> parts;
 
   for (net::QueryIterator it(url); !it.IsAtEnd(); it.Advance()) {
@@ -501,18 +586,11 @@ void RewardsServiceImpl::Shutdown() {
   RemoveObserver(extension_rewards_service_observer_.get());
   private_observers_.RemoveObserver(private_observer_.get());
 #endif
-  BitmapFetcherService* image_service =
-      BitmapFetcherServiceFactory::GetForBrowserContext(profile_);
-  if (image_service) {
-    for (auto request_id : request_ids_) {
-      image_service->CancelRequest(request_id);
-    }
-  }
-
-  for (const auto fetcher : fetchers_) {
-    delete fetcher.first;
-  }
-  fetchers_.clear();
+  favicon_fetcher_.CancelAll();
+  content_sites_timer_.Stop();
+  maintenance_timer_.Stop();
+  url_scheduler_.CancelAll();
+  timers_.Clear();
 
   ledger_.reset();
   RewardsService::Shutdown();
@@ -722,6 +800,9 @@ void RewardsServiceImpl::OnPublisherInfoSaved(
     ledger::PublisherInfoCallback callback,
     std::unique_ptr<ledger::PublisherInfo> info,
     bool success) {
+  if (success)
+    QueueContentSiteChange(*info);
+
   callback(success ? ledger::Result::LEDGER_OK
                    : ledger::Result::LEDGER_ERROR, std::move(info));
 
@@ -814,17 +895,15 @@ std::unique_ptr<ledger::LedgerURLLoader> RewardsServiceImpl::LoadURL(
     const std::string& contentType,
     const ledger::URL_METHOD& method,
     ledger::LedgerCallbackHandler* handler) {
-  net::URLFetcher::RequestType request_type = URLMethodToRequestType(method);
-
-  net::URLFetcher* fetcher = net::URLFetcher::Create(
-      GURL(url), request_type, this).release();
-  fetcher->SetRequestContext(g_browser_process->system_request_context());
-
-  for (size_t i = 0; i < headers.size(); i++)
-    fetcher->AddExtraRequestHeader(headers[i]);
-
-  if (!content.empty())
-    fetcher->SetUploadData(contentType, content);
+  LedgerURLScheduler::Request request;
+  request.url = GURL(url);
+  request.method = URLMethodToRequestType(method);
+  request.headers = headers;
+  request.content = content;
+  request.content_type = contentType;
+  request.priority = user_visible_request_
+      ? LedgerURLScheduler::USER_VISIBLE
+      : LedgerURLScheduler::BACKGROUND;
 
   if (VLOG_IS_ON(ledger::LogLevel::LOG_REQUEST)) {
     std::string printMethod;
@@ -850,54 +929,19 @@ std::unique_ptr<ledger::LedgerURLLoader> RewardsServiceImpl::LoadURL(
     VLOG(ledger::LogLevel::LOG_REQUEST) << "[ END REQUEST ]";
   }
 
-  FetchCallback callback = base::Bind(
+  LedgerURLScheduler::FetchCallback callback = base::Bind(
       &ledger::LedgerCallbackHandler::OnURLRequestResponse,
       base::Unretained(handler),
       next_id,
       url);
-  fetchers_[fetcher] = callback;
 
   std::unique_ptr<ledger::LedgerURLLoader> loader(
-      new LedgerURLLoaderImpl(next_id++, fetcher));
+      new LedgerURLLoaderImpl(next_id++, request, callback,
+                              url_scheduler_.AsWeakPtr()));
 
   return loader;
 }
 
-void RewardsServiceImpl::OnURLFetchComplete(
-    const net::URLFetcher* source) {
-  if (fetchers_.find(source) == fetchers_.end()) {
-    delete source;
-    return;
-  }
-
-  auto callback = fetchers_[source];
-  fetchers_.erase(source);
-
-  int response_code = source->GetResponseCode();
-  std::string body;
-  std::map<std::string, std::string> headers;
-  scoped_refptr<net::HttpResponseHeaders> headersList = source->GetResponseHeaders();
-
-  if (headersList) {
-    size_t iter = 0;
-    std::string key;
-    std::string value;
-    while (headersList->EnumerateHeaderLines(&iter, &key, &value)) {
-      key = base::ToLowerASCII(key);
-      headers[key] = value;
-    }
-  }
-
-  if (response_code != net::URLFetcher::ResponseCode::RESPONSE_CODE_INVALID &&
-      source->GetStatus().is_success()) {
-    source->GetResponseAsString(&body);
-  }
-
-  delete source;
-
-  callback.Run(response_code, body, headers);
-}
-
 void RunIOTaskCallback(
     base::WeakPtr<RewardsServiceImpl> rewards_service,
     std::function<void(void)> callback) {
@@ -957,6 +1001,7 @@ void RewardsServiceImpl::TriggerOnWalletProperties(int error_code,
 
 void RewardsServiceImpl::FetchWalletProperties() {
   if (ready().is_signaled()) {
+    base::AutoReset<bool> user_visible(&user_visible_request_, true);
     ledger_->FetchWalletProperties();
   } else {
     ready().Post(FROM_HERE,
@@ -967,6 +1012,7 @@ void RewardsServiceImpl::FetchWalletProperties() {
 
 void RewardsServiceImpl::FetchGrant(const std::string& lang,
     const std::string& payment_id) {
+  base::AutoReset<bool> user_visible(&user_visible_request_, true);
   ledger_->FetchGrant(lang, payment_id);
 }
 
@@ -984,6 +1030,7 @@ void RewardsServiceImpl::TriggerOnGrant(ledger::Result result,
 }
 
 void RewardsServiceImpl::GetGrantCaptcha() {
+  base::AutoReset<bool> user_visible(&user_visible_request_, true);
   ledger_->GetGrantCaptcha();
 }
 
@@ -1087,6 +1134,185 @@ void RewardsServiceImpl::SetAutoContribute(bool enabled) const {
 void RewardsServiceImpl::TriggerOnContentSiteUpdated() {
   for (auto& observer : observers_)
     observer.OnContentSiteUpdated(this);
+
+  // Publisher info is saved on every visit, so coalesce diffs.
+  if (content_site_list_watchers_ == 0 || content_sites_timer_.IsRunning())
+    return;
+
+  content_sites_timer_.Start(FROM_HERE,
+      kContentSiteListRefreshDelay,
+      base::Bind(&RewardsServiceImpl::ApplyContentSiteChanges,
+                 base::Unretained(this)));
+}
+
+void RewardsServiceImpl::MaybeRunPublisherInfoMaintenance() {
+  if (!ready().is_signaled())
+    return;
+
+  const base::TimeTicks now = base::TimeTicks::Now();
+  if (ui::CalculateIdleTime() < kMaintenanceIdleThresholdInSeconds &&
+      now - last_maintenance_ < kMaxMaintenanceDelay) {
+    return;
+  }
+
+  last_maintenance_ = now;
+  file_task_runner_->PostTask(FROM_HERE,
+      base::BindOnce(&RunPublisherInfoMaintenanceOnFileTaskRunner,
+                     base::Time::Now(),
+                     ledger_->GetReconcileStamp(),
+                     profile_->GetPrefs()->GetInteger(
+                         kRewardsPublisherInfoRetentionMonths),
+                     publisher_info_backend_.get()));
+}
+
+ledger::PublisherInfoFilter
+RewardsServiceImpl::CreateContentSiteListFilter() const {
+  auto now = base::Time::Now();
+  ledger::PublisherInfoFilter filter;
+  filter.category = ledger::PUBLISHER_CATEGORY::AUTO_CONTRIBUTE;
+  filter.month = GetPublisherMonth(now);
+  filter.year = GetPublisherYear(now);
+  filter.min_duration = ledger_->GetPublisherMinVisitTime();
+  filter.order_by.push_back(std::pair<std::string, bool>("ai.percent", false));
+  filter.reconcile_stamp = ledger_->GetReconcileStamp();
+  filter.excluded =
+    ledger::PUBLISHER_EXCLUDE_FILTER::FILTER_ALL_EXCEPT_EXCLUDED;
+  return filter;
+}
+
+void RewardsServiceImpl::QueueContentSiteChange(
+    const ledger::PublisherInfo& info) {
+  if (content_site_list_watchers_ == 0 ||
+      (!content_sites_loaded_ && !content_sites_loading_))
+    return;
+
+  const std::string& id = info.id;
+  if (info.excluded == ledger::PUBLISHER_EXCLUDE::EXCLUDED) {
+    pending_content_sites_.erase(id);
+    pending_removed_content_sites_.insert(id);
+    return;
+  }
+
+  if (info.month == ledger::PUBLISHER_MONTH::ANY || info.year == -1) {
+    // Only the publisher columns were saved, so patch them onto the row the
+    // page has. Without one this may be an un-exclude that brings a row
+    // back, which only a full load can tell.
+    const ContentSite* current = nullptr;
+    auto pending = pending_content_sites_.find(id);
+    if (pending != pending_content_sites_.end())
+      current = &pending->second;
+    else if (!pending_removed_content_sites_.count(id))
+      current = content_sites_.Find(id);
+
+    if (!current) {
+      content_sites_stale_ = true;
+      return;
+    }
+
+    ContentSite site = *current;
+    site.verified = info.verified;
+    site.excluded = info.excluded;
+    site.name = info.name;
+    site.url = info.url;
+    site.provider = info.provider;
+    site.favicon_url = info.favicon_url;
+    pending_content_sites_[id] = site;
+    return;
+  }
+
+  if (!IsInContentSiteListPeriod(content_sites_filter_, info))
+    return;
+
+  if (info.duration < content_sites_filter_.min_duration) {
+    pending_content_sites_.erase(id);
+    pending_removed_content_sites_.insert(id);
+    return;
+  }
+
+  pending_removed_content_sites_.erase(id);
+  pending_content_sites_[id] = PublisherInfoToContentSite(info);
+}
+
+void RewardsServiceImpl::ApplyContentSiteChanges() {
+  // the load applies whatever is pending once it finishes
+  if (content_site_list_watchers_ == 0 || content_sites_loading_)
+    return;
+
+  // A new month or reconcile period, or a new minimum visit time, changes
+  // which rows belong in the list at all.
+  if (content_sites_stale_ ||
+      !IsSameContentSiteListFilter(content_sites_filter_,
+                                   CreateContentSiteListFilter())) {
+    LoadContentSiteList();
+    return;
+  }
+
+  if (pending_content_sites_.empty() && pending_removed_content_sites_.empty())
+    return;
+
+  ContentSiteList upserted;
+  for (const auto& site : pending_content_sites_)
+    upserted.push_back(site.second);
+  std::vector<std::string> removed(pending_removed_content_sites_.begin(),
+                                   pending_removed_content_sites_.end());
+  pending_content_sites_.clear();
+  pending_removed_content_sites_.clear();
+
+  ContentSiteDiff diff = content_sites_.Apply(upserted, removed);
+  if (!diff.empty()) {
+    for (auto& observer : observers_)
+      observer.OnContentSiteListChanged(this, diff);
+  }
+}
+
+void RewardsServiceImpl::LoadContentSiteList() {
+  if (content_site_list_watchers_ == 0)
+    return;
+
+  if (content_sites_loading_) {
+    content_sites_dirty_ = true;
+    return;
+  }
+
+  // Everything saved so far is already in the database this query reads.
+  content_sites_loading_ = true;
+  content_sites_stale_ = false;
+  content_sites_filter_ = CreateContentSiteListFilter();
+  pending_content_sites_.clear();
+  pending_removed_content_sites_.clear();
+  GetContentSiteList(0, 0,
+      base::Bind(&RewardsServiceImpl::OnContentSiteListLoaded, AsWeakPtr()));
+}
+
+void RewardsServiceImpl::OnContentSiteListLoaded(
+    std::unique_ptr<ContentSiteList> list,
+    uint32_t next_record) {
+  content_sites_loading_ = false;
+  // the last page went away while loading
+  if (content_site_list_watchers_ == 0)
+    return;
+
+  content_sites_loaded_ = true;
+  ContentSiteDiff diff = content_sites_.Update(*list);
+  if (content_sites_reset_pending_) {
+    content_sites_reset_pending_ = false;
+    diff = content_sites_.Snapshot();
+  }
+
+  if (!diff.empty()) {
+    for (auto& observer : observers_)
+      observer.OnContentSiteListChanged(this, diff);
+  }
+
+  if (content_sites_dirty_) {
+    content_sites_dirty_ = false;
+    LoadContentSiteList();
+    return;
+  }
+
+  // Rows saved while loading may or may not be in |list|; they are at least
+  // as new, so applying them again is safe.
+  ApplyContentSiteChanges();
 }
 
 void RewardsServiceImpl::SavePublishersList(const std::string& publishers_list,
@@ -1121,16 +1347,12 @@ void RewardsServiceImpl::SetTimer(uint64_t time_offset,
 
   timer_id = next_timer_id_;
 
-  timers_[next_timer_id_] = std::make_unique<base::OneShotTimer>();
-  timers_[next_timer_id_]->Start(FROM_HERE,
-      base::TimeDelta::FromSeconds(time_offset),
-      base::BindOnce(
-          &RewardsServiceImpl::OnTimer, AsWeakPtr(), next_timer_id_));
+  timers_.Add(next_timer_id_, base::TimeDelta::FromSeconds(time_offset));
 }
 
 void RewardsServiceImpl::OnTimer(uint32_t timer_id) {
-  ledger_->OnTimer(timer_id);
-  timers_.erase(timer_id);
+  if (ledger_)
+    ledger_->OnTimer(timer_id);
 }
 
 void RewardsServiceImpl::LoadPublisherList(
@@ -1240,89 +1462,11 @@ double RewardsServiceImpl::GetContributionAmount() {
 void RewardsServiceImpl::FetchFavIcon(const std::string& url,
                                       const std::string& favicon_key,
                                       ledger::FetchIconCallback callback) {
-  GURL parsedUrl(url);
-
-  if (!parsedUrl.is_valid()) {
-    return;
-  }
-
-  std::vector<std::string>::iterator it;
-  it = find (current_media_fetchers_.begin(), current_media_fetchers_.end(), url);
-  if (it != current_media_fetchers_.end()) {
-    LOG(WARNING) << "Already fetching favicon: " << url;
-    return;
-  }
-
-  BitmapFetcherService* image_service =
-      BitmapFetcherServiceFactory::GetForBrowserContext(profile_);
-  if (image_service) {
-    net::NetworkTrafficAnnotationTag traffic_annotation =
-      net::DefineNetworkTrafficAnnotation("brave_rewards_favicon_fetcher", R"(
-        semantics {
-          sender:
-            "Brave Rewards Media Fetcher"
-          description:
-            "Fetches favicon for media publishers in Rewards."
-          trigger:
-            "User visits a media publisher content."
-          data: "Favicon for media publisher."
-          destination: WEBSITE
-        }
-        policy {
-          cookies_allowed: NO
-          setting:
-            "This feature cannot be disabled by settings."
-          policy_exception_justification:
-            "Not implemented."
-        })");
-    current_media_fetchers_.emplace_back(url);
-    request_ids_.push_back(image_service->RequestImage(
-          parsedUrl,
-          // Image Service takes ownership of the observer
-          new RewardsFetcherServiceObserver(
-              favicon_key,
-              parsedUrl,
-              base::Bind(&RewardsServiceImpl::OnFetchFavIconCompleted, base::Unretained(this), callback)),
-          traffic_annotation));
-  }
-}
-
-void RewardsServiceImpl::OnFetchFavIconCompleted(ledger::FetchIconCallback callback,
-                                                 const std::string& favicon_key,
-                                                 const GURL& url,
-                                                 const BitmapFetcherService::RequestId& request_id,
-                                                 const SkBitmap& image) {
-  GURL favicon_url(favicon_key);
-  gfx::Image gfx_image = gfx::Image::CreateFrom1xBitmap(image);
-  favicon::FaviconService* favicon_service =
-          FaviconServiceFactory::GetForProfile(profile_, ServiceAccessType::EXPLICIT_ACCESS);
-  favicon_service->SetOnDemandFavicons(
-      favicon_url,
-      url,
-      favicon_base::IconType::kFavicon,
-      gfx_image,
-      base::BindOnce(&RewardsServiceImpl::OnSetOnDemandFaviconComplete, AsWeakPtr(), favicon_url.spec(), callback));
-
-  std::vector<std::string>::iterator it_url;
-  it_url = find(current_media_fetchers_.begin(), current_media_fetchers_.end(), url.spec());
-  if (it_url != current_media_fetchers_.end()) {
-    current_media_fetchers_.erase(it_url);
-  }
-
-  std::vector<BitmapFetcherService::RequestId>::iterator it_ids;
-  it_ids = find(request_ids_.begin(), request_ids_.end(), request_id);
-  if (it_ids != request_ids_.end()) {
-    request_ids_.erase(it_ids);
-  }
-}
-
-void RewardsServiceImpl::OnSetOnDemandFaviconComplete(const std::string& favicon_url,
-                                                      ledger::FetchIconCallback callback,
-                                                      bool success) {
-  callback(success, favicon_url);
+  favicon_fetcher_.Fetch(GURL(url), favicon_key, callback);
 }
 
 void RewardsServiceImpl::GetPublisherBanner(const std::string& publisher_id) {
+  base::AutoReset<bool> user_visible(&user_visible_request_, true);
   ledger_->GetPublisherBanner(publisher_id,
       std::bind(&RewardsServiceImpl::OnPublisherBanner, this, _1));
 }
@@ -8,6 +8,7 @@
 #include <functional>
 #include <map>
 #include <memory>
+#include <set>
 #include <string>
 
 #include "bat/ledger/ledger.h"
@@ -22,12 +23,15 @@
 #include "content/public/browser/browser_thread.h"
 #include "extensions/buildflags/buildflags.h"
 #include "extensions/common/one_shot_event.h"
-#include "net/url_request/url_fetcher_delegate.h"
 #include "brave/components/brave_rewards/browser/balance_report.h"
+#include "brave/components/brave_rewards/browser/content_site_view.h"
 #include "brave/components/brave_rewards/browser/contribution_info.h"
+#include "brave/components/brave_rewards/browser/favicon_fetcher.h"
+#include "brave/components/brave_rewards/browser/ledger_url_scheduler.h"
 #include "ui/gfx/image/image.h"
 #include "brave/components/brave_rewards/browser/publisher_banner.h"
 #include "brave/components/brave_rewards/browser/rewards_service_private_observer.h"
+#include "brave/components/brave_rewards/browser/timer_wheel.h"
 
 #if BUILDFLAG(ENABLE_EXTENSIONS)
 #include "brave/components/brave_rewards/browser/extension_rewards_service_observer.h"
@@ -47,10 +51,6 @@ namespace leveldb {
 class DB;
 }  // namespace leveldb
 
-namespace net {
-class URLFetcher;
-}  // namespace net
-
 class Profile;
 
 namespace brave_rewards {
@@ -60,7 +60,6 @@ class RewardsNotificationService;
 
 class RewardsServiceImpl : public RewardsService,
                             public ledger::LedgerClient,
-                            public net::URLFetcherDelegate,
                             public base::SupportsWeakPtr<RewardsServiceImpl> {
  public:
   RewardsServiceImpl(Profile* profile);
@@ -81,6 +80,9 @@ class RewardsServiceImpl : public RewardsService,
   void GetContentSiteList(uint32_t start,
                           uint32_t limit,
      const GetContentSiteListCallback& callback) override;
+  void StartContentSiteListUpdates() override;
+  void StopContentSiteListUpdates() override;
+  void RefreshContentSiteList() override;
   void OnLoad(SessionID tab_id, const GURL& url) override;
   void OnUnload(SessionID tab_id) override;
   void OnShow(SessionID tab_id) override;
@@ -127,7 +129,6 @@ class RewardsServiceImpl : public RewardsService,
   friend void RunIOTaskCallback(
       base::WeakPtr<RewardsServiceImpl>,
       std::function<void(void)>);
-  typedef base::Callback<void(int, const std::string&, const std::map<std::string, std::string>& headers)> FetchCallback;
 
   const extensions::OneShotEvent& ready() const { return ready_; }
   void OnLedgerStateSaved(ledger::LedgerCallbackHandler* handler,
@@ -164,6 +165,13 @@ class RewardsServiceImpl : public RewardsService,
                              bool success);
   void OnTimer(uint32_t timer_id);
   void TriggerOnContentSiteUpdated();
+  void MaybeRunPublisherInfoMaintenance();
+  ledger::PublisherInfoFilter CreateContentSiteListFilter() const;
+  void QueueContentSiteChange(const ledger::PublisherInfo& info);
+  void ApplyContentSiteChanges();
+  void LoadContentSiteList();
+  void OnContentSiteListLoaded(std::unique_ptr<ContentSiteList> list,
+                               uint32_t next_record);
   void OnPublisherListLoaded(ledger::LedgerCallbackHandler* handler,
                              const std::string& data);
   void OnDonate(const std::string& publisher_key, int amount, bool recurring) override;
@@ -248,14 +256,6 @@ class RewardsServiceImpl : public RewardsService,
   void FetchFavIcon(const std::string& url,
                     const std::string& favicon_key,
                     ledger::FetchIconCallback callback) override;
-  void OnFetchFavIconCompleted(ledger::FetchIconCallback callback,
-                          const std::string& favicon_key,
-                          const GURL& url,
-                          const BitmapFetcherService::RequestId& request_id,
-                          const SkBitmap& image);
-  void OnSetOnDemandFaviconComplete(const std::string& favicon_url,
-                                    ledger::FetchIconCallback callback,
-                                    bool success);
   void SaveContributionInfo(const std::string& probi,
                             const int month,
                             const int year,
@@ -267,9 +267,6 @@ class RewardsServiceImpl : public RewardsService,
 
   void OnIOTaskComplete(std::function<void(void)> callback);
 
-  // URLFetcherDelegate impl
-  void OnURLFetchComplete(const net::URLFetcher* source) override;
-
   Profile* profile_;  // NOT OWNED
   std::unique_ptr<ledger::Ledger> ledger_;
 #if BUILDFLAG(ENABLE_EXTENSIONS)
@@ -289,10 +286,31 @@ class RewardsServiceImpl : public RewardsService,
 #endif
 
   extensions::OneShotEvent ready_;
-  std::map<const net::URLFetcher*, FetchCallback> fetchers_;
-  std::map<uint32_t, std::unique_ptr<base::OneShotTimer>> timers_;
-  std::vector<std::string> current_media_fetchers_;
-  std::vector<BitmapFetcherService::RequestId> request_ids_;
+  LedgerURLScheduler url_scheduler_;
+  // Set while the ledger is driven by a user action so the requests it
+  // issues synchronously are scheduled ahead of background traffic.
+  bool user_visible_request_;
+  TimerWheel timers_;
+  FaviconFetcher favicon_fetcher_;
+  // Kept up to date only once the list has been asked for, so browsing
+  // without the rewards page open never reloads it.
+  ContentSiteView content_sites_;
+  // Filter of the last full load, which saved rows are matched against.
+  ledger::PublisherInfoFilter content_sites_filter_;
+  // Saved rows not yet applied to |content_sites_|, coalesced by the timer.
+  std::map<std::string, ContentSite> pending_content_sites_;
+  std::set<std::string> pending_removed_content_sites_;
+  base::OneShotTimer content_sites_timer_;
+  // Pages watching the content site list.
+  int content_site_list_watchers_;
+  bool content_sites_loaded_;
+  bool content_sites_loading_;
+  // Set when a save could not be applied in place and needs a full load.
+  bool content_sites_stale_;
+  bool content_sites_dirty_;
+  bool content_sites_reset_pending_;
+  base::RepeatingTimer maintenance_timer_;
+  base::TimeTicks last_maintenance_;
 
   uint32_t next_timer_id_;
 
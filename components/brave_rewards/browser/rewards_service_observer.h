@@ -7,6 +7,7 @@
 
 #include "base/observer_list_types.h"
 #include "brave/components/brave_rewards/browser/content_site.h"
+#include "brave/components/brave_rewards/browser/content_site_view.h"
 #include "brave/components/brave_rewards/browser/grant.h"
 #include "brave/components/brave_rewards/browser/publisher_banner.h"
 
@@ -43,6 +44,8 @@ class RewardsServiceObserver : public base::CheckedObserver {
                                  unsigned int result,
                                  brave_rewards::Grant grant) {};
   virtual void OnContentSiteUpdated(RewardsService* rewards_service) {};
+  virtual void OnContentSiteListChanged(RewardsService* rewards_service,
+                                        const ContentSiteDiff& diff) {};
   virtual void OnExcludedSitesChanged(RewardsService* rewards_service) {};
   virtual void OnReconcileComplete(RewardsService* rewards_service,
                                    unsigned int result,
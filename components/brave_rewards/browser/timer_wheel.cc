@@ -0,0 +1,189 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_rewards/browser/timer_wheel.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "base/bind.h"
+#include "base/time/default_tick_clock.h"
+#include "base/time/tick_clock.h"
+
+namespace brave_rewards {
+
+namespace {
+
+// Resolution of the lowest level. Ledger timers are expressed in seconds.
+constexpr base::TimeDelta kTick = base::TimeDelta::FromSeconds(1);
+
+}  // namespace
+
+TimerWheel::TimerWheel(const ExpiredCallback& callback,
+                       const base::TickClock* tick_clock)
+    : callback_(callback),
+      tick_clock_(tick_clock ? tick_clock
+                             : base::DefaultTickClock::GetInstance()),
+      origin_(tick_clock_->NowTicks()),
+      current_tick_(0),
+      size_(0),
+      in_callback_(false),
+      timer_(tick_clock_),
+      armed_tick_(0),
+      weak_factory_(this) {
+}
+
+TimerWheel::~TimerWheel() {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+}
+
+void TimerWheel::Add(uint32_t timer_id, base::TimeDelta delay) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  if (delay < base::TimeDelta())
+    delay = base::TimeDelta();
+
+  // Round up so a timer never fires before the requested delay has elapsed.
+  const base::TimeDelta target = tick_clock_->NowTicks() - origin_ + delay;
+  uint64_t expiry_tick = target.IntDiv(kTick);
+  if (target % kTick > base::TimeDelta())
+    ++expiry_tick;
+  expiry_tick = std::max(expiry_tick, current_tick_ + 1);
+
+  Insert({timer_id, expiry_tick});
+  ++size_;
+  Rearm();
+}
+
+void TimerWheel::Clear() {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  for (auto& level : slots_) {
+    for (auto& slot : level)
+      Slot().swap(slot);
+  }
+  size_ = 0;
+  timer_.Stop();
+}
+
+uint64_t TimerWheel::CurrentTick() const {
+  return (tick_clock_->NowTicks() - origin_).IntDiv(kTick);
+}
+
+void TimerWheel::Insert(const Entry& entry) {
+  DCHECK_GT(entry.expiry_tick, current_tick_);
+  const uint64_t delta = entry.expiry_tick - current_tick_;
+
+  int level = 0;
+  while (level < kLevels - 1 &&
+         delta >= (uint64_t{1} << (kLevelBits * (level + 1)))) {
+    ++level;
+  }
+
+  // Deadlines beyond the range of the top level are parked in its furthest
+  // slot and re-bucketed when that slot is cascaded.
+  uint64_t index_tick = entry.expiry_tick;
+  const uint64_t top_range = uint64_t{1} << (kLevelBits * kLevels);
+  if (delta >= top_range)
+    index_tick = current_tick_ + top_range - 1;
+
+  const int index = (index_tick >> (kLevelBits * level)) & kSlotMask;
+  slots_[level][index].push_back(entry);
+}
+
+bool TimerWheel::NextEventTick(uint64_t* tick) const {
+  bool found = false;
+  for (int level = 0; level < kLevels; ++level) {
+    const int shift = kLevelBits * level;
+    const uint64_t block = current_tick_ >> shift;
+    for (uint64_t step = 1; step <= kSlotsPerLevel; ++step) {
+      if (slots_[level][(block + step) & kSlotMask].empty())
+        continue;
+      const uint64_t candidate = (block + step) << shift;
+      if (!found || candidate < *tick)
+        *tick = candidate;
+      found = true;
+      break;
+    }
+  }
+  return found;
+}
+
+void TimerWheel::ProcessTick(std::vector<uint32_t>* expired) {
+  // Cascade higher levels whose slot boundary is |current_tick_| first so
+  // entries due right now land on the lowest level before it is drained.
+  for (int level = kLevels - 1; level > 0; --level) {
+    const int shift = kLevelBits * level;
+    if (current_tick_ & ((uint64_t{1} << shift) - 1))
+      continue;
+    Slot cascade;
+    cascade.swap(slots_[level][(current_tick_ >> shift) & kSlotMask]);
+    for (const auto& entry : cascade) {
+      if (entry.expiry_tick <= current_tick_) {
+        expired->push_back(entry.timer_id);
+        --size_;
+      } else {
+        Insert(entry);
+      }
+    }
+  }
+
+  Slot due;
+  due.swap(slots_[0][current_tick_ & kSlotMask]);
+  for (const auto& entry : due) {
+    if (entry.expiry_tick <= current_tick_) {
+      expired->push_back(entry.timer_id);
+      --size_;
+    } else {
+      Insert(entry);
+    }
+  }
+}
+
+void TimerWheel::OnWake() {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  const uint64_t now_tick = CurrentTick();
+
+  // Jump straight between non-empty slots; the ones in between are empty so
+  // skipping them is equivalent to stepping through every tick.
+  std::vector<uint32_t> expired;
+  uint64_t next_tick;
+  while (NextEventTick(&next_tick) && next_tick <= now_tick) {
+    current_tick_ = next_tick;
+    ProcessTick(&expired);
+  }
+  current_tick_ = std::max(current_tick_, now_tick);
+
+  base::WeakPtr<TimerWheel> self = weak_factory_.GetWeakPtr();
+  in_callback_ = true;
+  for (uint32_t timer_id : expired) {
+    callback_.Run(timer_id);
+    if (!self)
+      return;
+  }
+  in_callback_ = false;
+
+  Rearm();
+}
+
+void TimerWheel::Rearm() {
+  if (in_callback_)
+    return;
+
+  uint64_t next_tick;
+  if (!NextEventTick(&next_tick)) {
+    timer_.Stop();
+    return;
+  }
+
+  if (timer_.IsRunning() && armed_tick_ == next_tick)
+    return;
+
+  armed_tick_ = next_tick;
+  base::TimeDelta delay =
+      origin_ + kTick * next_tick - tick_clock_->NowTicks();
+  timer_.Start(FROM_HERE,
+               std::max(delay, base::TimeDelta()),
+               base::BindOnce(&TimerWheel::OnWake, base::Unretained(this)));
+}
+
+}  // namespace brave_rewards
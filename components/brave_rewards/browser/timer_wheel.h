@@ -0,0 +1,90 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_COMPONENTS_BRAVE_REWARDS_BROWSER_TIMER_WHEEL_H_
+#define BRAVE_COMPONENTS_BRAVE_REWARDS_BROWSER_TIMER_WHEEL_H_
+
+#include <stdint.h>
+
+#include <vector>
+
+#include "base/callback.h"
+#include "base/macros.h"
+#include "base/memory/weak_ptr.h"
+#include "base/sequence_checker.h"
+#include "base/time/time.h"
+#include "base/timer/timer.h"
+
+namespace base {
+class TickClock;
+}  // namespace base
+
+namespace brave_rewards {
+
+// Hierarchical timer wheel backing the ledger's SetTimer requests.
+//
+// Timers are bucketed into slots of one second resolution on the lowest
+// level; each higher level covers 64 times the range of the one below and
+// is cascaded down as its slot comes due. Adding a timer is O(1) and only a
+// single delayed task is ever outstanding, armed for the next non-empty
+// slot, so the ledger can keep many short and long timers without one
+// task-queue entry per timer. Timers that come due together are delivered
+// as one batch.
+class TimerWheel {
+ public:
+  using ExpiredCallback = base::RepeatingCallback<void(uint32_t timer_id)>;
+
+  // |tick_clock| may be null, in which case the default tick clock is used.
+  TimerWheel(const ExpiredCallback& callback,
+             const base::TickClock* tick_clock = nullptr);
+  ~TimerWheel();
+
+  // Schedules |timer_id| to expire no earlier than |delay| from now.
+  void Add(uint32_t timer_id, base::TimeDelta delay);
+
+  // Drops all pending timers without running them.
+  void Clear();
+
+  size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+
+ private:
+  static constexpr int kLevelBits = 6;
+  static constexpr int kSlotsPerLevel = 1 << kLevelBits;
+  static constexpr int kSlotMask = kSlotsPerLevel - 1;
+  static constexpr int kLevels = 4;
+
+  struct Entry {
+    uint32_t timer_id;
+    uint64_t expiry_tick;
+  };
+  using Slot = std::vector<Entry>;
+
+  uint64_t CurrentTick() const;
+  void Insert(const Entry& entry);
+  // Returns the tick at which the next non-empty slot must be processed.
+  bool NextEventTick(uint64_t* tick) const;
+  void ProcessTick(std::vector<uint32_t>* expired);
+  void OnWake();
+  void Rearm();
+
+  ExpiredCallback callback_;
+  const base::TickClock* tick_clock_;  // NOT OWNED
+  const base::TimeTicks origin_;
+  uint64_t current_tick_;
+  size_t size_;
+  bool in_callback_;
+  Slot slots_[kLevels][kSlotsPerLevel];
+  base::OneShotTimer timer_;
+  uint64_t armed_tick_;
+
+  SEQUENCE_CHECKER(sequence_checker_);
+  base::WeakPtrFactory<TimerWheel> weak_factory_;
+
+  DISALLOW_COPY_AND_ASSIGN(TimerWheel);
+};
+
+}  // namespace brave_rewards
+
+#endif  // BRAVE_COMPONENTS_BRAVE_REWARDS_BROWSER_TIMER_WHEEL_H_
@@ -0,0 +1,128 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_rewards/browser/timer_wheel.h"
+
+#include <vector>
+
+#include "base/bind.h"
+#include "base/test/scoped_task_environment.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+// npm run test -- brave_unit_tests --filter=TimerWheelTest.*
+
+namespace brave_rewards {
+
+class TimerWheelTest : public testing::Test {
+ public:
+  TimerWheelTest()
+      : scoped_task_environment_(
+            base::test::ScopedTaskEnvironment::MainThreadType::MOCK_TIME),
+        wheel_(base::BindRepeating(&TimerWheelTest::OnExpired,
+                                   base::Unretained(this)),
+               scoped_task_environment_.GetMockTickClock()),
+        rearm_on_expiry_(false) {}
+  ~TimerWheelTest() override {}
+
+ protected:
+  void OnExpired(uint32_t timer_id) {
+    expired_.push_back(timer_id);
+    if (rearm_on_expiry_)
+      wheel_.Add(timer_id + 1, base::TimeDelta::FromSeconds(1));
+  }
+
+  void FastForwardBy(base::TimeDelta delta) {
+    scoped_task_environment_.FastForwardBy(delta);
+  }
+
+  base::test::ScopedTaskEnvironment scoped_task_environment_;
+  TimerWheel wheel_;
+  std::vector<uint32_t> expired_;
+  bool rearm_on_expiry_;
+};
+
+TEST_F(TimerWheelTest, FiresAfterDelay) {
+  wheel_.Add(1, base::TimeDelta::FromSeconds(5));
+  EXPECT_EQ(1u, wheel_.size());
+
+  FastForwardBy(base::TimeDelta::FromMilliseconds(4999));
+  EXPECT_TRUE(expired_.empty());
+
+  FastForwardBy(base::TimeDelta::FromMilliseconds(1));
+  ASSERT_EQ(1u, expired_.size());
+  EXPECT_EQ(1u, expired_[0]);
+  EXPECT_TRUE(wheel_.empty());
+}
+
+TEST_F(TimerWheelTest, ZeroDelayFiresOnNextTick) {
+  wheel_.Add(7, base::TimeDelta());
+  FastForwardBy(base::TimeDelta::FromSeconds(1));
+  ASSERT_EQ(1u, expired_.size());
+  EXPECT_EQ(7u, expired_[0]);
+}
+
+TEST_F(TimerWheelTest, BatchesTimersDueTogether) {
+  wheel_.Add(1, base::TimeDelta::FromSeconds(10));
+  wheel_.Add(2, base::TimeDelta::FromSeconds(10));
+  wheel_.Add(3, base::TimeDelta::FromSeconds(20));
+  EXPECT_EQ(1u, scoped_task_environment_.GetPendingMainThreadTaskCount());
+
+  FastForwardBy(base::TimeDelta::FromSeconds(10));
+  ASSERT_EQ(2u, expired_.size());
+  EXPECT_EQ(1u, expired_[0]);
+  EXPECT_EQ(2u, expired_[1]);
+
+  FastForwardBy(base::TimeDelta::FromSeconds(10));
+  ASSERT_EQ(3u, expired_.size());
+  EXPECT_EQ(3u, expired_[2]);
+}
+
+TEST_F(TimerWheelTest, CascadesLongHorizonTimers) {
+  // Spread timers across every level of the wheel, including one past the
+  // range of the top level.
+  const int64_t delays[] = {3, 100, 5000, 300000, 30 * 24 * 60 * 60,
+                            400 * 24 * 60 * 60};
+  uint32_t id = 0;
+  for (int64_t delay : delays)
+    wheel_.Add(++id, base::TimeDelta::FromSeconds(delay));
+
+  int64_t elapsed = 0;
+  id = 0;
+  for (int64_t delay : delays) {
+    FastForwardBy(base::TimeDelta::FromSeconds(delay - elapsed - 1));
+    EXPECT_EQ(id, expired_.size());
+    FastForwardBy(base::TimeDelta::FromSeconds(1));
+    ASSERT_EQ(++id, expired_.size());
+    EXPECT_EQ(id, expired_.back());
+    elapsed = delay;
+  }
+  EXPECT_TRUE(wheel_.empty());
+}
+
+TEST_F(TimerWheelTest, AddFromCallback) {
+  rearm_on_expiry_ = true;
+  wheel_.Add(1, base::TimeDelta::FromSeconds(1));
+
+  FastForwardBy(base::TimeDelta::FromSeconds(1));
+  ASSERT_EQ(1u, expired_.size());
+  EXPECT_EQ(1u, wheel_.size());
+
+  rearm_on_expiry_ = false;
+  FastForwardBy(base::TimeDelta::FromSeconds(1));
+  ASSERT_EQ(2u, expired_.size());
+  EXPECT_EQ(2u, expired_[1]);
+  EXPECT_TRUE(wheel_.empty());
+}
+
+TEST_F(TimerWheelTest, Clear) {
+  wheel_.Add(1, base::TimeDelta::FromSeconds(1));
+  wheel_.Add(2, base::TimeDelta::FromHours(1));
+  wheel_.Clear();
+  EXPECT_TRUE(wheel_.empty());
+
+  FastForwardBy(base::TimeDelta::FromHours(2));
+  EXPECT_TRUE(expired_.empty());
+}
+
+}  // namespace brave_rewards
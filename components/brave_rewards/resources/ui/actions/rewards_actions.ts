@@ -84,8 +84,8 @@ export const onQRGenerated = (type: Rewards.AddressesType, image: string) => act
   image
 })
 
-export const onContributeList = (list: Rewards.Publisher[]) => action(types.ON_CONTRIBUTE_LIST, {
-  list
+export const onContributeListChanged = (diff: Rewards.ContributeListDiff) => action(types.ON_CONTRIBUTE_LIST_CHANGED, {
+  diff
 })
 
 export const onBalanceReports = (reports: Record<string, Rewards.Report>) => action(types.ON_BALANCE_REPORTS, {
@@ -89,8 +89,8 @@ window.cr.define('brave_rewards', function () {
     getActions().onAddresses(addresses)
   }
 
-  function contributeList (list: Rewards.Publisher[]) {
-    getActions().onContributeList(list)
+  function contributeListChanged (diff: Rewards.ContributeListDiff) {
+    getActions().onContributeListChanged(diff)
   }
 
   function numExcludedSites (num: string) {
@@ -129,7 +129,7 @@ window.cr.define('brave_rewards', function () {
     grantFinish,
     reconcileStamp,
     addresses,
-    contributeList,
+    contributeListChanged,
     numExcludedSites,
     balanceReports,
     walletExists,
@@ -9,15 +9,37 @@ import { types } from '../constants/rewards_types'
 
 const publishersReducer: Reducer<Rewards.State | undefined> = (state: Rewards.State, action) => {
   switch (action.type) {
-    case types.ON_CONTRIBUTE_LIST:
-      state = { ...state }
-      if (state.contributeLoad) {
-        state.firstLoad = false
-      } else {
-        state.contributeLoad = true
+    case types.ON_CONTRIBUTE_LIST_CHANGED:
+      {
+        const diff: Rewards.ContributeListDiff = action.payload.diff
+        if (!diff.reset && diff.version !== state.contributeListVersion + 1) {
+          // A change was missed, start over from the whole list
+          chrome.send('brave_rewards.getContributionList', [])
+          break
+        }
+
+        state = { ...state }
+        if (state.contributeLoad) {
+          state.firstLoad = false
+        } else {
+          state.contributeLoad = true
+        }
+
+        if (diff.reset) {
+          state.autoContributeList = diff.upserted
+        } else {
+          const changed = diff.upserted.map((publisher: Rewards.Publisher) => publisher.publisherKey)
+          state.autoContributeList = state.autoContributeList
+            .filter((publisher: Rewards.Publisher) => {
+              return !changed.includes(publisher.publisherKey) &&
+                !diff.removed.includes(publisher.publisherKey)
+            })
+            .concat(diff.upserted)
+            .sort((a: Rewards.Publisher, b: Rewards.Publisher) => b.percentage - a.percentage)
+        }
+        state.contributeListVersion = diff.version
+        break
       }
-      state.autoContributeList = action.payload.list
-      break
     case types.ON_NUM_EXCLUDED_SITES:
       state = { ...state }
       if (action.payload.num != null) {
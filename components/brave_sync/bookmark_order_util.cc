@@ -4,11 +4,83 @@
 
 #include "brave/components/brave_sync/bookmark_order_util.h"
 
+#include <limits>
+
+#include "base/logging.h"
 #include "base/strings/string_number_conversions.h"
 #include "base/strings/string_split.h"
+#include "base/strings/string_util.h"
 
 namespace brave_sync {
 
+namespace {
+
+// Walks the components of an order string the way OrderToIntVect splits
+// it: pieces are separated by dots, trimmed and empty pieces are skipped.
+class OrderStringReader {
+ public:
+  explicit OrderStringReader(base::StringPiece order)
+      : order_(order), pos_(0) {}
+
+  bool Next(int* component) {
+    while (pos_ < order_.size() &&
+           (order_[pos_] == '.' || base::IsAsciiWhitespace(order_[pos_])))
+      ++pos_;
+    if (pos_ == order_.size())
+      return false;
+
+    int64_t value = 0;
+    while (pos_ < order_.size() && base::IsAsciiDigit(order_[pos_])) {
+      value = value * 10 + (order_[pos_++] - '0');
+      CHECK(value <= std::numeric_limits<int>::max());
+    }
+    while (pos_ < order_.size() && base::IsAsciiWhitespace(order_[pos_]))
+      ++pos_;
+    CHECK(pos_ == order_.size() || order_[pos_] == '.');
+
+    *component = static_cast<int>(value);
+    return true;
+  }
+
+ private:
+  base::StringPiece order_;
+  size_t pos_;
+};
+
+class OrderKeyReader {
+ public:
+  explicit OrderKeyReader(const std::vector<int>& components)
+      : components_(components), pos_(0) {}
+
+  bool Next(int* component) {
+    if (pos_ == components_.size())
+      return false;
+    *component = components_[pos_++];
+    return true;
+  }
+
+ private:
+  const std::vector<int>& components_;
+  size_t pos_;
+};
+
+// Lexicographical comparison, a prefix sorts first.
+template <typename LeftReader, typename RightReader>
+int CompareComponents(LeftReader* left, RightReader* right) {
+  int left_component = 0;
+  int right_component = 0;
+  while (true) {
+    const bool has_left = left->Next(&left_component);
+    const bool has_right = right->Next(&right_component);
+    if (!has_left || !has_right)
+      return static_cast<int>(has_left) - static_cast<int>(has_right);
+    if (left_component != right_component)
+      return left_component < right_component ? -1 : 1;
+  }
+}
+
+}  // namespace
+
 std::vector<int> OrderToIntVect(const std::string& s) {
   std::vector<std::string> vec_s = SplitString(
       s,
@@ -29,12 +101,38 @@ std::vector<int> OrderToIntVect(const std::string& s) {
 
 bool CompareOrder(const std::string& left, const std::string& right) {
   // Return: true if left <  right
-  // Split each and use C++ stdlib
-  std::vector<int> vec_left = OrderToIntVect(left);
-  std::vector<int> vec_right = OrderToIntVect(right);
+  return CompareOrderStrings(left, right) < 0;
+}
+
+int CompareOrderStrings(base::StringPiece left, base::StringPiece right) {
+  OrderStringReader left_reader(left);
+  OrderStringReader right_reader(right);
+  return CompareComponents(&left_reader, &right_reader);
+}
+
+OrderKey::OrderKey() {}
+
+OrderKey::OrderKey(base::StringPiece order) {
+  OrderStringReader reader(order);
+  int component = 0;
+  while (reader.Next(&component))
+    components_.push_back(component);
+}
+
+OrderKey::OrderKey(const OrderKey& key) = default;
+
+OrderKey::~OrderKey() {}
+
+int OrderKey::Compare(base::StringPiece order) const {
+  OrderKeyReader key_reader(components_);
+  OrderStringReader order_reader(order);
+  return CompareComponents(&key_reader, &order_reader);
+}
 
-  return std::lexicographical_compare(vec_left.begin(), vec_left.end(),
-    vec_right.begin(), vec_right.end());
+int OrderKey::Compare(const OrderKey& other) const {
+  OrderKeyReader key_reader(components_);
+  OrderKeyReader other_reader(other.components_);
+  return CompareComponents(&key_reader, &other_reader);
 }
 
 } // namespace brave_sync
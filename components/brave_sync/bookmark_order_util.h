@@ -8,11 +8,37 @@
 #include <string>
 #include <vector>
 
+#include "base/strings/string_piece.h"
+
 namespace brave_sync {
 
   std::vector<int> OrderToIntVect(const std::string& s);
   bool CompareOrder(const std::string& left, const std::string& right);
 
+  // Three-way comparison of two order strings without allocating.
+  // Returns a negative value, zero or a positive value if |left| sorts
+  // before, with or after |right|.
+  int CompareOrderStrings(base::StringPiece left, base::StringPiece right);
+
+  // An order string such as "1.0.3.12" parsed once, for comparing one
+  // order against many, e.g. when looking for an insertion position.
+  class OrderKey {
+   public:
+    OrderKey();
+    explicit OrderKey(base::StringPiece order);
+    OrderKey(const OrderKey& key);
+    ~OrderKey();
+
+    // Same result as CompareOrderStrings but only |order| is scanned.
+    int Compare(base::StringPiece order) const;
+    int Compare(const OrderKey& other) const;
+
+    bool empty() const { return components_.empty(); }
+
+   private:
+    std::vector<int> components_;
+  };
+
 } // namespace brave_sync
 
 #endif // BRAVE_COMPONENTS_BRAVE_SYNC_BOOKMARK_ORDER_UTIL_H_
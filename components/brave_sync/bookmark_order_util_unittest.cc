@@ -60,4 +60,30 @@ TEST_F(BookmarkOrderUtilTest, CompareOrder) {
   EXPECT_FALSE(CompareOrder("1.7.0.2", "1.7.0.1"));
 }
 
+TEST_F(BookmarkOrderUtilTest, CompareOrderStrings) {
+  EXPECT_EQ(CompareOrderStrings("", ""), 0);
+  EXPECT_EQ(CompareOrderStrings("1.7.4", "1.7.4"), 0);
+  EXPECT_EQ(CompareOrderStrings(".5.", "5"), 0);
+  EXPECT_LT(CompareOrderStrings("1", "1.1"), 0);
+  EXPECT_LT(CompareOrderStrings("2", "11"), 0);
+  EXPECT_GT(CompareOrderStrings("11", "2"), 0);
+  EXPECT_GT(CompareOrderStrings("1.7.1", "1.7.0.1"), 0);
+}
+
+TEST_F(BookmarkOrderUtilTest, OrderKey) {
+  EXPECT_TRUE(OrderKey().empty());
+  EXPECT_TRUE(OrderKey("..").empty());
+
+  const OrderKey key("1.7.4");
+  EXPECT_EQ(key.Compare("1.7.4"), 0);
+  EXPECT_LT(key.Compare("1.7.4.1"), 0);
+  EXPECT_LT(key.Compare("1.7.10"), 0);
+  EXPECT_GT(key.Compare("1.7"), 0);
+  EXPECT_GT(key.Compare("1.6.9"), 0);
+
+  EXPECT_EQ(key.Compare(OrderKey("1.7.4")), 0);
+  EXPECT_LT(key.Compare(OrderKey("2")), 0);
+  EXPECT_GT(key.Compare(OrderKey()), 0);
+}
+
 } // namespace brave_sync
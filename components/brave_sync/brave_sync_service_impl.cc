@@ -4,7 +4,10 @@
 
 #include "brave/components/brave_sync/brave_sync_service_impl.h"
 
+#include <algorithm>
+
 #include "base/task/post_task.h"
+#include "base/timer/timer.h"
 #include "brave/browser/ui/webui/sync/sync_ui.h"
 #include "brave/components/brave_sync/bookmark_order_util.h"
 #include "brave/components/brave_sync/brave_sync_prefs.h"
@@ -26,6 +29,15 @@ namespace brave_sync {
 
 namespace {
 
+const int64_t kCheckUpdatesIntervalSec = 60;
+// Polling backs off up to this while fetches come back empty
+const int64_t kMaxCheckUpdatesIntervalSec = 10 * 60;
+// Local changes are only sent after a fetch, so fetch soon after one
+const int64_t kLocalChangeFetchDelaySec = 5;
+// Delay between pages of a truncated fetch
+const int64_t kBacklogFetchDelaySec = 1;
+const int64_t kFetchDevicesIntervalSec = 10 * 60;
+
 RecordsListPtr CreateDeviceCreationRecordExtension(
   const std::string& deviceName,
   const std::string& objectId,
@@ -82,8 +94,12 @@ BraveSyncServiceImpl::BraveSyncServiceImpl(Profile* profile) :
         profile,
         sync_client_.get(),
         sync_prefs_.get())),
-    timer_(std::make_unique<base::RepeatingTimer>()),
+    timer_(std::make_unique<base::OneShotTimer>()),
     unsynced_send_interval_(base::TimeDelta::FromMinutes(10)) {
+  bookmark_change_processor_->set_local_change_callback(
+      base::BindRepeating(&BraveSyncServiceImpl::OnLocalBookmarkChange,
+                          // the processor is owned by the service
+                          base::Unretained(this)));
 
   // Moniter syncs prefs required in GetSettingsAndDevices
   profile_pref_change_registrar_.Init(profile->GetPrefs());
@@ -382,8 +398,7 @@ void BraveSyncServiceImpl::OnGetExistingObjects(
     const base::Time &last_record_time_stamp,
     const bool is_truncated) {
   DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
-  // TODO(bridiver) - what do we do with is_truncated ?
-  // It appears to be ignored in b-l
+  const bool has_records = !records->empty();
   if (!tools::IsTimeEmpty(last_record_time_stamp)) {
     sync_prefs_->SetLatestRecordTime(last_record_time_stamp);
   }
@@ -392,14 +407,16 @@ void BraveSyncServiceImpl::OnGetExistingObjects(
     auto records_and_existing_objects =
         std::make_unique<SyncRecordAndExistingList>();
     bookmark_change_processor_->GetAllSyncData(
-        *records.get(), records_and_existing_objects.get());
+        std::move(*records), records_and_existing_objects.get());
     sync_client_->SendResolveSyncRecords(
         category_name, std::move(records_and_existing_objects));
   } else if (category_name == brave_sync::jslib_const::kPreferences) {
-    auto existing_records = PrepareResolvedPreferences(*records.get());
+    auto existing_records = PrepareResolvedPreferences(std::move(*records));
     sync_client_->SendResolveSyncRecords(
         category_name, std::move(existing_records));
   }
+
+  OnFetchCategoryDone(has_records, is_truncated);
 }
 
 void BraveSyncServiceImpl::OnResolvedSyncRecords(
@@ -410,27 +427,42 @@ void BraveSyncServiceImpl::OnResolvedSyncRecords(
   if (category_name == brave_sync::jslib_const::kPreferences) {
     OnResolvedPreferences(*records.get());
   } else if (category_name == brave_sync::jslib_const::kBookmarks) {
-    bookmark_change_processor_->ApplyChangesFromSyncModel(*records.get());
-    bookmark_change_processor_->SendUnsynced(unsynced_send_interval_);
+    // the processor is owned by this, and drops the callback when stopped
+    bookmark_change_processor_->ApplyChangesFromSyncModelInSlices(
+        std::move(records),
+        base::BindOnce(&BraveSyncServiceImpl::OnBookmarkChangesApplied,
+                       base::Unretained(this)));
   } else if (category_name == brave_sync::jslib_const::kHistorySites) {
     NOTIMPLEMENTED();
   }
 
 }
 
+void BraveSyncServiceImpl::OnBookmarkChangesApplied() {
+  bookmark_change_processor_->SendUnsynced(unsynced_send_interval_);
+}
+
+void BraveSyncServiceImpl::OnBookmarkSyncMetadataReady() {
+  // sync may have been reset in the meantime
+  if (!sync_initialized_)
+    return;
+  RequestSyncData();
+}
+
 std::unique_ptr<SyncRecordAndExistingList>
-BraveSyncServiceImpl::PrepareResolvedPreferences(const RecordsList& records) {
+BraveSyncServiceImpl::PrepareResolvedPreferences(RecordsList records) {
   auto sync_devices = sync_prefs_->GetSyncDevices();
 
   auto records_and_existing_objects =
         std::make_unique<SyncRecordAndExistingList>();
+  records_and_existing_objects->reserve(records.size());
 
-  for (const SyncRecordPtr& record : records) {
+  for (SyncRecordPtr& record : records) {
     auto resolved_record = std::make_unique<SyncRecordAndExisting>();
-    resolved_record->first = jslib::SyncRecord::Clone(*record);
     auto* device = sync_devices->GetByObjectId(record->objectId);
     if (device)
       resolved_record->second = PrepareResolvedDevice(device, record->action);
+    resolved_record->first = std::move(record);
     records_and_existing_objects->emplace_back(std::move(resolved_record));
   }
 
@@ -494,6 +526,13 @@ void BraveSyncServiceImpl::OnSyncWordsPrepared(const std::string& words) {
   NotifyHaveSyncWords(words);
 }
 
+void BraveSyncServiceImpl::OnSyncRecordsProgress(size_t records_sent,
+                                                 size_t records_total) {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
+  for (auto& observer : observers_)
+    observer.OnSyncRecordsProgress(this, records_sent, records_total);
+}
+
 // Here we query sync lib for the records after initialization (or again later)
 void BraveSyncServiceImpl::RequestSyncData() {
   DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
@@ -505,6 +544,16 @@ void BraveSyncServiceImpl::RequestSyncData() {
   if (!bookmarks && !history && !preferences)
     return;
 
+  // the bookmarks can't be resolved before their sync metadata is loaded,
+  // and the other categories share the latest record time with them
+  if (bookmarks && !bookmark_change_processor_->IsReady()) {
+    // the processor is owned by this
+    bookmark_change_processor_->set_ready_callback(
+        base::BindOnce(&BraveSyncServiceImpl::OnBookmarkSyncMetadataReady,
+                       base::Unretained(this)));
+    return;
+  }
+
   base::Time last_fetch_time = sync_prefs_->GetLastFetchTime();
 
   if (tools::IsTimeEmpty(last_fetch_time)) {
@@ -514,7 +563,15 @@ void BraveSyncServiceImpl::RequestSyncData() {
   }
 
   FetchSyncRecords(bookmarks, history, preferences, 1000);
-  sync_client_->SendFetchSyncDevices();
+
+  // devices change rarely and also arrive as preferences records
+  const base::TimeTicks now = base::TimeTicks::Now();
+  if (last_devices_fetch_time_.is_null() ||
+      now - last_devices_fetch_time_ >=
+          base::TimeDelta::FromSeconds(kFetchDevicesIntervalSec)) {
+    last_devices_fetch_time_ = now;
+    sync_client_->SendFetchSyncDevices();
+  }
 }
 
 void BraveSyncServiceImpl::FetchSyncRecords(const bool bookmarks,
@@ -539,6 +596,9 @@ void BraveSyncServiceImpl::FetchSyncRecords(const bool bookmarks,
 
   DCHECK(sync_client_);
   sync_prefs_->SetLastFetchTime(base::Time::Now());
+  pending_fetch_categories_ = category_names.size();
+  fetch_has_records_ = false;
+  fetch_is_truncated_ = false;
 
   base::Time start_at_time = sync_prefs_->GetLatestRecordTime();
   sync_client_->SendFetchSyncRecords(
@@ -574,22 +634,76 @@ void BraveSyncServiceImpl::SendDeviceSyncRecord(
       static_cast<jslib::SyncRecord::Action>(action),
       device_id);
   sync_client_->SendSyncRecords(
-      jslib_const::SyncRecordType_PREFERENCES, *records);
+      jslib_const::SyncRecordType_PREFERENCES, std::move(records));
+  // pick up the device list change on the next fetch
+  last_devices_fetch_time_ = base::TimeTicks();
 }
 
-static const int64_t kCheckUpdatesIntervalSec = 60;
-
 void BraveSyncServiceImpl::StartLoop() {
-  timer_->Start(FROM_HERE,
-                  base::TimeDelta::FromSeconds(kCheckUpdatesIntervalSec),
-                  this,
-                  &BraveSyncServiceImpl::LoopProc);
+  loop_started_ = true;
+  fetch_interval_ = base::TimeDelta::FromSeconds(kCheckUpdatesIntervalSec);
+  ScheduleFetch(fetch_interval_);
 }
 
 void BraveSyncServiceImpl::StopLoop() {
+  loop_started_ = false;
   timer_->Stop();
 }
 
+void BraveSyncServiceImpl::ScheduleFetch(base::TimeDelta delay) {
+  if (!loop_started_)
+    return;
+
+  timer_->Start(FROM_HERE,
+                delay,
+                this,
+                &BraveSyncServiceImpl::LoopProc);
+}
+
+void BraveSyncServiceImpl::ScheduleFetchSoon(base::TimeDelta delay) {
+  if (timer_->IsRunning() &&
+      timer_->desired_run_time() <= base::TimeTicks::Now() + delay)
+    return;
+
+  ScheduleFetch(delay);
+}
+
+void BraveSyncServiceImpl::OnFetchCategoryDone(bool has_records,
+                                               bool is_truncated) {
+  // answers to an earlier fetch after the poll timer moved on
+  if (pending_fetch_categories_ == 0)
+    return;
+
+  fetch_has_records_ |= has_records;
+  fetch_is_truncated_ |= is_truncated;
+  if (--pending_fetch_categories_ > 0)
+    return;
+
+  if (fetch_is_truncated_) {
+    // page through the backlog
+    ScheduleFetch(base::TimeDelta::FromSeconds(kBacklogFetchDelaySec));
+    return;
+  }
+
+  if (fetch_has_records_) {
+    fetch_interval_ = base::TimeDelta::FromSeconds(kCheckUpdatesIntervalSec);
+  } else {
+    fetch_interval_ = std::min(
+        fetch_interval_ * 2,
+        base::TimeDelta::FromSeconds(kMaxCheckUpdatesIntervalSec));
+  }
+  ScheduleFetch(fetch_interval_);
+}
+
+void BraveSyncServiceImpl::OnLocalBookmarkChange() {
+  if (!sync_initialized_ || !sync_prefs_->GetSyncBookmarksEnabled())
+    return;
+
+  // other devices are likely to follow up on this one's changes
+  fetch_interval_ = base::TimeDelta::FromSeconds(kCheckUpdatesIntervalSec);
+  ScheduleFetchSoon(base::TimeDelta::FromSeconds(kLocalChangeFetchDelaySec));
+}
+
 void BraveSyncServiceImpl::LoopProc() {
   base::CreateSingleThreadTaskRunnerWithTraits(
     {content::BrowserThread::UI})->PostTask(
@@ -601,6 +715,15 @@ void BraveSyncServiceImpl::LoopProc() {
 
 void BraveSyncServiceImpl::LoopProcThreadAligned() {
   DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
+  if (pending_fetch_categories_ > 0) {
+    // jslib doesn't answer for a category without new records, so the
+    // categories still pending when the next poll is due count as empty
+    pending_fetch_categories_ = 1;
+    OnFetchCategoryDone(false, false);
+  } else {
+    // keeps polling if the fetch is never answered, the answer reschedules
+    ScheduleFetch(fetch_interval_);
+  }
   if (!sync_initialized_) {
     return;
   }
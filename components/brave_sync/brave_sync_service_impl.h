@@ -27,14 +27,18 @@ FORWARD_DECLARE_TEST(BraveSyncServiceTest, OnSyncPrefsChanged);
 FORWARD_DECLARE_TEST(BraveSyncServiceTest, OnSyncDebug);
 FORWARD_DECLARE_TEST(BraveSyncServiceTest, OnSyncReadyAlreadyWithSync);
 FORWARD_DECLARE_TEST(BraveSyncServiceTest, OnSyncReadyNewToSync);
+FORWARD_DECLARE_TEST(BraveSyncServiceTest,
+                     OnSyncReadyWaitsForBookmarkSyncMetadata);
 FORWARD_DECLARE_TEST(BraveSyncServiceTest, OnGetExistingObjects);
 FORWARD_DECLARE_TEST(BraveSyncServiceTest, BackgroundSyncStarted);
 FORWARD_DECLARE_TEST(BraveSyncServiceTest, BackgroundSyncStopped);
+FORWARD_DECLARE_TEST(BraveSyncServiceTest, FetchIntervalAdapts);
+FORWARD_DECLARE_TEST(BraveSyncServiceTest, UnansweredCategoriesBackOff);
 
 class BraveSyncServiceTest;
 
 namespace base {
-class RepeatingTimer;
+class OneShotTimer;
 }
 
 namespace brave_sync {
@@ -96,9 +100,14 @@ class BraveSyncServiceImpl : public BraveSyncService,
   FRIEND_TEST_ALL_PREFIXES(::BraveSyncServiceTest, OnSyncDebug);
   FRIEND_TEST_ALL_PREFIXES(::BraveSyncServiceTest, OnSyncReadyAlreadyWithSync);
   FRIEND_TEST_ALL_PREFIXES(::BraveSyncServiceTest, OnSyncReadyNewToSync);
+  FRIEND_TEST_ALL_PREFIXES(::BraveSyncServiceTest,
+                           OnSyncReadyWaitsForBookmarkSyncMetadata);
   FRIEND_TEST_ALL_PREFIXES(::BraveSyncServiceTest, OnGetExistingObjects);
   FRIEND_TEST_ALL_PREFIXES(::BraveSyncServiceTest, BackgroundSyncStarted);
   FRIEND_TEST_ALL_PREFIXES(::BraveSyncServiceTest, BackgroundSyncStopped);
+  FRIEND_TEST_ALL_PREFIXES(::BraveSyncServiceTest, FetchIntervalAdapts);
+  FRIEND_TEST_ALL_PREFIXES(::BraveSyncServiceTest,
+                           UnansweredCategoriesBackOff);
   friend class ::BraveSyncServiceTest;
 
   // SyncMessageHandler overrides
@@ -120,11 +129,17 @@ class BraveSyncServiceImpl : public BraveSyncService,
   void OnDeleteSyncSiteSettings() override;
   void OnSaveBookmarksBaseOrder(const std::string& order) override;
   void OnSyncWordsPrepared(const std::string& words) override;
+  void OnSyncRecordsProgress(size_t records_sent,
+                             size_t records_total) override;
 
   void OnResolvedHistorySites(const RecordsList &records);
   void OnResolvedPreferences(const RecordsList &records);
+  // Sends the bookmarks changed meanwhile once resolved records are applied.
+  void OnBookmarkChangesApplied();
+  // Fetches the records deferred until the bookmark sync metadata loaded.
+  void OnBookmarkSyncMetadataReady();
   std::unique_ptr<SyncRecordAndExistingList> PrepareResolvedPreferences(
-    const RecordsList& records);
+    RecordsList records);
 
   void OnSyncPrefsChanged(const std::string& pref);
 
@@ -150,6 +165,13 @@ class BraveSyncServiceImpl : public BraveSyncService,
   void StopLoop();
   void LoopProc();
   void LoopProcThreadAligned();
+  // Runs the next fetch after |delay|, replacing the one scheduled.
+  void ScheduleFetch(base::TimeDelta delay);
+  // Runs the next fetch after |delay| unless one is scheduled sooner.
+  void ScheduleFetchSoon(base::TimeDelta delay);
+  // Adapts the fetch interval once every fetched category has answered.
+  void OnFetchCategoryDone(bool has_records, bool is_truncated);
+  void OnLocalBookmarkChange();
 
   void GetExistingHistoryObjects(
     const RecordsList &records,
@@ -184,7 +206,15 @@ class BraveSyncServiceImpl : public BraveSyncService,
   // will be saved on GET_EXISTING_OBJECTS to be sure request was processed
   base::Time last_time_fetch_sent_;
 
-  std::unique_ptr<base::RepeatingTimer> timer_;
+  std::unique_ptr<base::OneShotTimer> timer_;
+  bool loop_started_ = false;
+  // Current delay between polls, grows while fetches come back empty.
+  base::TimeDelta fetch_interval_;
+  // Categories of the last fetch that haven't answered yet.
+  size_t pending_fetch_categories_ = 0;
+  bool fetch_has_records_ = false;
+  bool fetch_is_truncated_ = false;
+  base::TimeTicks last_devices_fetch_time_;
 
   // send unsynced records in batches
   base::TimeDelta unsynced_send_interval_;
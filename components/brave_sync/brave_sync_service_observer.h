@@ -18,6 +18,10 @@ class BraveSyncServiceObserver : public base::CheckedObserver {
   virtual void OnSyncStateChanged(BraveSyncService* sync_service) {}
   virtual void OnHaveSyncWords(BraveSyncService* sync_service,
                                const std::string& sync_words) {}
+  // Large batches of records reach the sync extension in chunks.
+  virtual void OnSyncRecordsProgress(BraveSyncService* sync_service,
+                                     size_t records_sent,
+                                     size_t records_total) {}
 };
 
 } // namespace brave_sync
@@ -73,6 +73,7 @@
 // OnGetInitData             | +
 // OnSaveInitData            | BraveSyncServiceTest.GetSeed
 // OnSyncReady               | +
+// OnBookmarkSyncMetadataReady | +
 // OnGetExistingObjects      | +
 // OnResolvedSyncRecords     | BraveSyncServiceTest.BookmarkAddedImpl
 // OnDeletedSyncUser         | N/A
@@ -142,6 +143,7 @@ class BraveSyncServiceTest : public testing::Test {
   BraveSyncServiceImpl* sync_service() { return sync_service_; }
   MockBraveSyncClient* sync_client() { return sync_client_; }
   MockBraveSyncServiceObserver* observer() { return observer_.get(); }
+  content::TestBrowserThreadBundle* thread_bundle() { return &thread_bundle_; }
 
  private:
   // Need this as a very first member to run tests in UI thread
@@ -330,7 +332,7 @@ bool DevicesContains(SyncDevices* devices, const std::string& id,
 
 MATCHER_P2(ContainsDeviceRecord, action, name,
     "contains device sync record with params") {
-  for (const auto& record : arg) {
+  for (const auto& record : *arg) {
     if (record->has_device()) {
       const auto& device = record->GetDevice();
       if (record->action == action &&
@@ -523,6 +525,27 @@ TEST_F(BraveSyncServiceTest, OnSyncReadyNewToSync) {
   sync_service()->OnSyncReady();
 }
 
+TEST_F(BraveSyncServiceTest, OnSyncReadyWaitsForBookmarkSyncMetadata) {
+  profile()->GetPrefs()->SetString(
+                           brave_sync::prefs::kSyncBookmarksBaseOrder, "1.1.");
+  EXPECT_CALL(*observer(), OnSyncStateChanged);
+  profile()->GetPrefs()->SetBoolean(
+                            brave_sync::prefs::kSyncBookmarksEnabled, true);
+  profile()->GetPrefs()->SetTime(
+                     brave_sync::prefs::kSyncLastFetchTime, base::Time::Now());
+
+  // the processor isn't started, so its sync metadata isn't migrated
+  EXPECT_CALL(*sync_client(), SendFetchSyncRecords).Times(0);
+  sync_service()->OnSyncReady();
+  EXPECT_TRUE(sync_service()->IsSyncInitialized());
+  testing::Mock::VerifyAndClearExpectations(sync_client());
+
+  EXPECT_CALL(*sync_client(), SendFetchSyncRecords).Times(1);
+  sync_service()->bookmark_change_processor_->Start();
+  thread_bundle()->RunUntilIdle();
+  EXPECT_TRUE(sync_service()->bookmark_change_processor_->IsReady());
+}
+
 TEST_F(BraveSyncServiceTest, OnGetExistingObjects) {
   EXPECT_CALL(*sync_client(), SendResolveSyncRecords).Times(1);
 
@@ -542,3 +565,59 @@ TEST_F(BraveSyncServiceTest, BackgroundSyncStopped) {
   sync_service()->BackgroundSyncStopped(false);
   EXPECT_FALSE(sync_service()->timer_->IsRunning());
 }
+
+TEST_F(BraveSyncServiceTest, FetchIntervalAdapts) {
+  sync_service()->BackgroundSyncStarted(false);
+  const base::TimeDelta interval = sync_service()->fetch_interval_;
+
+  // empty fetches back off
+  sync_service()->pending_fetch_categories_ = 2;
+  sync_service()->OnFetchCategoryDone(false, false);
+  EXPECT_EQ(interval, sync_service()->fetch_interval_);
+  sync_service()->OnFetchCategoryDone(false, false);
+  EXPECT_EQ(interval * 2, sync_service()->fetch_interval_);
+  EXPECT_TRUE(sync_service()->timer_->IsRunning());
+
+  // a late answer doesn't count
+  sync_service()->OnFetchCategoryDone(false, false);
+  EXPECT_EQ(interval * 2, sync_service()->fetch_interval_);
+
+  // the next page of a truncated fetch comes right away
+  sync_service()->pending_fetch_categories_ = 1;
+  sync_service()->OnFetchCategoryDone(true, true);
+  EXPECT_EQ(interval * 2, sync_service()->fetch_interval_);
+  EXPECT_LT(sync_service()->timer_->GetCurrentDelay(), interval);
+
+  // records bring the interval back
+  sync_service()->pending_fetch_categories_ = 1;
+  sync_service()->OnFetchCategoryDone(true, false);
+  EXPECT_EQ(interval, sync_service()->fetch_interval_);
+
+  sync_service()->BackgroundSyncStopped(false);
+  EXPECT_FALSE(sync_service()->timer_->IsRunning());
+}
+
+TEST_F(BraveSyncServiceTest, UnansweredCategoriesBackOff) {
+  sync_service()->BackgroundSyncStarted(false);
+  const base::TimeDelta interval = sync_service()->fetch_interval_;
+
+  // jslib answered for the bookmarks only, there was nothing new for the
+  // preferences
+  sync_service()->pending_fetch_categories_ = 2;
+  sync_service()->OnFetchCategoryDone(false, false);
+  EXPECT_EQ(interval, sync_service()->fetch_interval_);
+
+  // the next poll counts the preferences as empty
+  sync_service()->LoopProcThreadAligned();
+  EXPECT_EQ(0u, sync_service()->pending_fetch_categories_);
+  EXPECT_EQ(interval * 2, sync_service()->fetch_interval_);
+  EXPECT_EQ(interval * 2, sync_service()->timer_->GetCurrentDelay());
+
+  // one with records still counts
+  sync_service()->pending_fetch_categories_ = 2;
+  sync_service()->OnFetchCategoryDone(true, false);
+  sync_service()->LoopProcThreadAligned();
+  EXPECT_EQ(interval, sync_service()->fetch_interval_);
+
+  sync_service()->BackgroundSyncStopped(false);
+}
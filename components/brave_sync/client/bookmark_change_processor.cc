@@ -4,7 +4,14 @@
 
 #include "brave/components/brave_sync/client/bookmark_change_processor.h"
 
+#include <algorithm>
+#include <utility>
+
+#include "base/files/file_path.h"
 #include "base/strings/utf_string_conversions.h"
+#include "base/task/post_task.h"
+#include "base/task_runner_util.h"
+#include "base/threading/sequenced_task_runner_handle.h"
 #include "brave/components/brave_sync/bookmark_order_util.h"
 #include "brave/components/brave_sync/jslib_const.h"
 #include "brave/components/brave_sync/jslib_messages.h"
@@ -21,27 +28,23 @@
 using bookmarks::BookmarkNode;
 using bookmarks::BookmarkModel;
 
-namespace {
+namespace brave_sync {
 
 class ScopedPauseObserver {
  public:
-  ScopedPauseObserver(brave_sync::BookmarkChangeProcessor* processor) :
+  ScopedPauseObserver(BookmarkChangeProcessor* processor) :
       processor_(processor) {
     DCHECK_NE(processor_, nullptr);
-    processor_->Stop();
+    processor_->Pause();
   }
   ~ScopedPauseObserver() {
-    processor_->Start();
+    processor_->Resume();
   }
 
  private:
-  brave_sync::BookmarkChangeProcessor* processor_;  // Not owned
+  BookmarkChangeProcessor* processor_;  // Not owned
 };
 
-}  // namespace
-
-namespace brave_sync {
-
 bool IsSyncManagedNode(const bookmarks::BookmarkPermanentNode* node) {
   return node->GetTitledUrlNodeTitle() ==
       base::UTF8ToUTF16("Deleted Bookmarks");
@@ -68,6 +71,12 @@ LoadExtraNodes(bookmarks::LoadExtraCallback callback,
 
 namespace {
 
+const base::FilePath::CharType kSyncMetadataFileName[] =
+    FILE_PATH_LITERAL("brave_sync_bookmarks_metadata");
+
+// Longest a slice of sync changes keeps the UI thread busy.
+const int kApplySliceTimeMs = 10;
+
 void GetOrder(const bookmarks::BookmarkNode* parent,
               int index,
               std::string* prev_order,
@@ -102,8 +111,9 @@ void GetPrevObjectId(const bookmarks::BookmarkNode* parent,
     prev_node->GetMetaInfo("object_id", prev_object_id);
 }
 
-const bookmarks::BookmarkNode* FindByObjectId(bookmarks::BookmarkModel* model,
-                                        const std::string& object_id) {
+const bookmarks::BookmarkNode* FindByObjectIdInTree(
+    bookmarks::BookmarkModel* model,
+    const std::string& object_id) {
   ui::TreeNodeIterator<const bookmarks::BookmarkNode>
       iterator(model->root_node());
   while (iterator.has_next()) {
@@ -117,61 +127,93 @@ const bookmarks::BookmarkNode* FindByObjectId(bookmarks::BookmarkModel* model,
   return nullptr;
 }
 
-uint64_t GetIndex(const bookmarks::BookmarkNode* root_node,
-                  const jslib::Bookmark& record) {
-  uint64_t index = 0;
-  ui::TreeNodeIterator<const bookmarks::BookmarkNode> iterator(root_node);
-  while (iterator.has_next()) {
-    const bookmarks::BookmarkNode* node = iterator.Next();
+// Returns the node's order meta info without copying it, or nullptr if the
+// node has no order.
+const std::string* GetOrderMetaInfo(const bookmarks::BookmarkNode* node) {
+  const bookmarks::BookmarkNode::MetaInfoMap* meta_info =
+      node->GetMetaInfoMap();
+  if (!meta_info)
+    return nullptr;
 
-    if (node->parent() != root_node)
-      return index;
+  auto it = meta_info->find("order");
+  if (it == meta_info->end() || it->second.empty())
+    return nullptr;
 
-    std::string node_order;
-    node->GetMetaInfo("order", &node_order);
-
-    if (!node_order.empty() &&
-        brave_sync::CompareOrder(record.order, node_order))
-      return index;
+  return &it->second;
+}
 
+// Returns the index of the first child at or after |index| that has an
+// order, or the child count if there is none.
+int GetOrderedChildIndex(const bookmarks::BookmarkNode* parent, int index) {
+  while (index < parent->child_count() &&
+         !GetOrderMetaInfo(parent->GetChild(index)))
     ++index;
-  }
   return index;
 }
 
+// Children with an order are kept sorted by it, so binary search for the
+// first one that sorts after |record|. Children without an order are
+// skipped.
+uint64_t GetIndex(const bookmarks::BookmarkNode* root_node,
+                  const jslib::Bookmark& record) {
+  const brave_sync::OrderKey record_order(record.order);
+  int low = 0;
+  int high = root_node->child_count();
+  while (low < high) {
+    const int mid = low + (high - low) / 2;
+    const int ordered = GetOrderedChildIndex(root_node, mid);
+    if (ordered == root_node->child_count() ||
+        record_order.Compare(
+            *GetOrderMetaInfo(root_node->GetChild(ordered))) < 0) {
+      high = mid;
+    } else {
+      low = ordered + 1;
+    }
+  }
+  return GetOrderedChildIndex(root_node, low);
+}
+
+// The title a bookmark record is applied with.
+base::string16 GetRecordTitle(const jslib::Bookmark& bookmark) {
+  return base::UTF8ToUTF16(!bookmark.site.title.empty() ?
+      bookmark.site.title : bookmark.site.customTitle);
+}
+
 // this should only be called for resolved records we get from the server
+// |url| and |title| are the record's, as returned by GURL() and
+// GetRecordTitle().
 void UpdateNode(bookmarks::BookmarkModel* model,
+                BookmarkSyncMetadataStore* sync_metadata,
                 const bookmarks::BookmarkNode* node,
-                const jslib::SyncRecord* record) {
-  auto bookmark = record->GetBookmark();
+                const jslib::SyncRecord* record,
+                const GURL& url,
+                const base::string16& title) {
+  const auto& bookmark = record->GetBookmark();
   if (bookmark.isFolder) {
     // SetDateFolderModified
   } else {
-    model->SetURL(node, GURL(bookmark.site.location));
+    model->SetURL(node, url);
     // TODO, AB: apply these:
     // sync_bookmark.site.customTitle
     // sync_bookmark.site.lastAccessedTime
     // sync_bookmark.site.favicon
   }
 
-  const auto& title = !bookmark.site.title.empty() ?
-      bookmark.site.title : bookmark.site.customTitle;
-  model->SetTitle(node,
-      base::UTF8ToUTF16(title));
+  model->SetTitle(node, title);
   model->SetDateAdded(node, bookmark.site.creationTime);
   model->SetNodeMetaInfo(node, "object_id", record->objectId);
   model->SetNodeMetaInfo(node, "order", bookmark.order);
 
   // updating the sync_timestamp marks this record as synced
-  model->SetNodeMetaInfo(node,
-      "sync_timestamp",
-      std::to_string(record->syncTimestamp.ToJsTime()));
+  sync_metadata->GetMutable(node->id(), record->objectId)->sync_timestamp =
+      record->syncTimestamp;
 }
 
-const bookmarks::BookmarkNode* FindParent(bookmarks::BookmarkModel* model,
-                                          const jslib::Bookmark& bookmark) {
-  auto* parent_node = FindByObjectId(model, bookmark.parentFolderObjectId);
-
+// |parent_node| is the node with the bookmark's parent object id, if any.
+const bookmarks::BookmarkNode* FindParent(
+    bookmarks::BookmarkModel* model,
+    const jslib::Bookmark& bookmark,
+    const bookmarks::BookmarkNode* parent_node) {
   if (!parent_node) {
     if (!bookmark.order.empty() &&
         bookmark.order.at(0) == '2') {
@@ -193,6 +235,37 @@ const bookmarks::BookmarkNode* FindParent(bookmarks::BookmarkModel* model,
   return parent_node;
 }
 
+bool IsUnsynced(const BookmarkSyncMetadata* metadata) {
+  if (!metadata || metadata->sync_timestamp.is_null())
+    return true;
+
+  return !metadata->last_updated_time.is_null() &&
+      metadata->last_updated_time > metadata->sync_timestamp;
+}
+
+// Sets |position| to the root's index in |root_nodes| followed by the
+// child indices down to |node|, so that sorting positions gives the order of
+// a preorder walk of the roots. Returns false if |node| is not below one of
+// |root_nodes|.
+bool GetSendPosition(
+    const std::vector<const bookmarks::BookmarkNode*>& root_nodes,
+    const bookmarks::BookmarkNode* node,
+    std::vector<int>* position) {
+  position->clear();
+  while (node->parent()) {
+    auto root = std::find(root_nodes.begin(), root_nodes.end(), node->parent());
+    if (root != root_nodes.end()) {
+      position->push_back(node->parent()->GetIndexOf(node));
+      position->push_back(root - root_nodes.begin());
+      std::reverse(position->begin(), position->end());
+      return true;
+    }
+    position->push_back(node->parent()->GetIndexOf(node));
+    node = node->parent();
+  }
+  return false;
+}
+
 }  // namespace
 
 // static
@@ -212,10 +285,28 @@ BookmarkChangeProcessor::BookmarkChangeProcessor(
       profile_(profile),
       bookmark_model_(BookmarkModelFactory::GetForBrowserContext(
           Profile::FromBrowserContext(profile))),
-      deleted_node_root_(nullptr) {
+      deleted_node_root_(nullptr),
+      observing_(false),
+      object_id_index_built_(false),
+      unsynced_nodes_built_(false),
+      sync_metadata_(std::make_unique<BookmarkSyncMetadataStore>(
+          profile->GetPath().Append(kSyncMetadataFileName),
+          base::CreateSequencedTaskRunnerWithTraits(
+              {base::MayBlock(), base::TaskPriority::BEST_EFFORT,
+               base::TaskShutdownBehavior::BLOCK_SHUTDOWN}))),
+      legacy_meta_info_migrated_(false),
+      prepare_task_runner_(base::CreateSequencedTaskRunnerWithTraits(
+          {base::TaskPriority::USER_VISIBLE,
+           base::TaskShutdownBehavior::SKIP_ON_SHUTDOWN})),
+      preparing_batches_(0),
+      apply_weak_factory_(this) {
   DCHECK(sync_client_);
   DCHECK(sync_prefs);
   DCHECK(bookmark_model_);
+  // the store is owned by this, so the callback can't outlive it
+  sync_metadata_->Load(
+      base::BindOnce(&BookmarkChangeProcessor::OnSyncMetadataLoaded,
+                     base::Unretained(this)));
 }
 
 BookmarkChangeProcessor::~BookmarkChangeProcessor() {
@@ -224,11 +315,254 @@ BookmarkChangeProcessor::~BookmarkChangeProcessor() {
 
 void BookmarkChangeProcessor::Start() {
   bookmark_model_->AddObserver(this);
+  observing_ = true;
+  MaybeMigrateLegacyMetaInfo();
 }
 
 void BookmarkChangeProcessor::Stop() {
   if (bookmark_model_)
     bookmark_model_->RemoveObserver(this);
+  // The model may change behind our back from now on.
+  observing_ = false;
+  ClearObjectIdIndex();
+  ClearUnsyncedNodes();
+  ClearPendingApplies();
+}
+
+void BookmarkChangeProcessor::Pause() {
+  bookmark_model_->RemoveObserver(this);
+  // Changes made while paused are made by the processor itself, which keeps
+  // the index up to date.
+  observing_ = true;
+}
+
+void BookmarkChangeProcessor::Resume() {
+  bookmark_model_->AddObserver(this);
+}
+
+const bookmarks::BookmarkNode* BookmarkChangeProcessor::FindByObjectId(
+    const std::string& object_id) {
+  if (object_id.empty())
+    return nullptr;
+
+  if (!observing_)
+    return FindByObjectIdInTree(bookmark_model_, object_id);
+
+  if (!object_id_index_built_)
+    BuildObjectIdIndex();
+
+  auto it = object_id_index_.find(object_id);
+  if (it == object_id_index_.end())
+    return nullptr;
+
+  // Drop entries whose node had its object id changed or removed.
+  std::string node_object_id;
+  it->second->GetMetaInfo("object_id", &node_object_id);
+  if (node_object_id != object_id) {
+    object_id_index_.erase(it);
+    return nullptr;
+  }
+
+  return it->second;
+}
+
+void BookmarkChangeProcessor::BuildObjectIdIndex() {
+  object_id_index_.clear();
+  ui::TreeNodeIterator<const bookmarks::BookmarkNode>
+      iterator(bookmark_model_->root_node());
+  while (iterator.has_next()) {
+    const bookmarks::BookmarkNode* node = iterator.Next();
+    std::string object_id;
+    node->GetMetaInfo("object_id", &object_id);
+    // the first node in tree order wins, as with a tree scan
+    if (!object_id.empty())
+      object_id_index_.emplace(object_id, node);
+  }
+  object_id_index_built_ = true;
+}
+
+void BookmarkChangeProcessor::IndexNode(const bookmarks::BookmarkNode* node) {
+  if (!object_id_index_built_)
+    return;
+
+  std::string object_id;
+  node->GetMetaInfo("object_id", &object_id);
+  if (!object_id.empty())
+    object_id_index_[object_id] = node;
+}
+
+void BookmarkChangeProcessor::IndexSubtree(
+    const bookmarks::BookmarkNode* node) {
+  if (!object_id_index_built_)
+    return;
+
+  IndexNode(node);
+  ui::TreeNodeIterator<const bookmarks::BookmarkNode> iterator(node);
+  while (iterator.has_next())
+    IndexNode(iterator.Next());
+}
+
+void BookmarkChangeProcessor::UnindexSubtree(
+    const bookmarks::BookmarkNode* node) {
+  if (!object_id_index_built_)
+    return;
+
+  std::vector<const bookmarks::BookmarkNode*> nodes = {node};
+  ui::TreeNodeIterator<const bookmarks::BookmarkNode> iterator(node);
+  while (iterator.has_next())
+    nodes.push_back(iterator.Next());
+
+  for (const auto* removed_node : nodes) {
+    std::string object_id;
+    removed_node->GetMetaInfo("object_id", &object_id);
+    auto it = object_id_index_.find(object_id);
+    if (it != object_id_index_.end() && it->second == removed_node)
+      object_id_index_.erase(it);
+  }
+}
+
+void BookmarkChangeProcessor::ClearObjectIdIndex() {
+  object_id_index_.clear();
+  object_id_index_built_ = false;
+}
+
+void BookmarkChangeProcessor::BuildUnsyncedNodes() {
+  ClearUnsyncedNodes();
+  std::vector<const bookmarks::BookmarkNode*> root_nodes = {
+    bookmark_model_->other_node(),
+    bookmark_model_->bookmark_bar_node(),
+    GetDeletedNodeRoot()
+  };
+  for (const auto* root_node : root_nodes) {
+    ui::TreeNodeIterator<const bookmarks::BookmarkNode> iterator(root_node);
+    while (iterator.has_next()) {
+      const bookmarks::BookmarkNode* node = iterator.Next();
+      if (IsUnsynced(GetSyncMetadata(node)))
+        changed_nodes_.insert(node);
+    }
+  }
+  unsynced_nodes_built_ = true;
+}
+
+void BookmarkChangeProcessor::MarkUnsynced(
+    const bookmarks::BookmarkNode* node) {
+  if (!unsynced_nodes_built_)
+    return;
+
+  // a pending resend is superseded, SendUnsynced looks at the node again
+  sent_nodes_.erase(node);
+  changed_nodes_.insert(node);
+}
+
+void BookmarkChangeProcessor::MarkUnsyncedSubtree(
+    const bookmarks::BookmarkNode* node) {
+  if (!unsynced_nodes_built_)
+    return;
+
+  MarkUnsynced(node);
+  ui::TreeNodeIterator<const bookmarks::BookmarkNode> iterator(node);
+  while (iterator.has_next())
+    MarkUnsynced(iterator.Next());
+}
+
+void BookmarkChangeProcessor::ClearUnsyncedNodes() {
+  changed_nodes_.clear();
+  sent_nodes_.clear();
+  resend_queue_ = decltype(resend_queue_)();
+  unsynced_nodes_built_ = false;
+}
+
+void BookmarkChangeProcessor::ForgetSubtree(
+    const bookmarks::BookmarkNode* node) {
+  UnindexSubtree(node);
+
+  std::vector<const bookmarks::BookmarkNode*> nodes = {node};
+  ui::TreeNodeIterator<const bookmarks::BookmarkNode> iterator(node);
+  while (iterator.has_next())
+    nodes.push_back(iterator.Next());
+
+  for (const auto* removed_node : nodes) {
+    sync_metadata_->Remove(removed_node->id());
+    if (unsynced_nodes_built_) {
+      changed_nodes_.erase(removed_node);
+      sent_nodes_.erase(removed_node);
+    }
+  }
+}
+
+const BookmarkSyncMetadata* BookmarkChangeProcessor::GetSyncMetadata(
+    const bookmarks::BookmarkNode* node) {
+  std::string object_id;
+  node->GetMetaInfo("object_id", &object_id);
+  return sync_metadata_->Get(node->id(), object_id);
+}
+
+BookmarkSyncMetadata* BookmarkChangeProcessor::GetMutableSyncMetadata(
+    const bookmarks::BookmarkNode* node) {
+  std::string object_id;
+  node->GetMetaInfo("object_id", &object_id);
+  return sync_metadata_->GetMutable(node->id(), object_id);
+}
+
+void BookmarkChangeProcessor::OnSyncMetadataLoaded() {
+  MaybeMigrateLegacyMetaInfo();
+}
+
+void BookmarkChangeProcessor::MaybeMigrateLegacyMetaInfo() {
+  if (legacy_meta_info_migrated_ || !observing_ ||
+      !sync_metadata_->loaded() || !bookmark_model_->loaded())
+    return;
+  legacy_meta_info_migrated_ = true;
+
+  ScopedPauseObserver pause(this);
+  std::set<int64_t> ids;
+  ui::TreeNodeIterator<const bookmarks::BookmarkNode>
+      iterator(bookmark_model_->root_node());
+  while (iterator.has_next()) {
+    const bookmarks::BookmarkNode* node = iterator.Next();
+    ids.insert(node->id());
+
+    std::string sync_timestamp;
+    std::string last_send_time;
+    std::string last_updated_time;
+    node->GetMetaInfo("sync_timestamp", &sync_timestamp);
+    node->GetMetaInfo("last_send_time", &last_send_time);
+    node->GetMetaInfo("last_updated_time", &last_updated_time);
+    if (sync_timestamp.empty() && last_send_time.empty() &&
+        last_updated_time.empty())
+      continue;
+
+    // an entry in the store was written after the meta info
+    if (!GetSyncMetadata(node)) {
+      BookmarkSyncMetadata* metadata = GetMutableSyncMetadata(node);
+      if (!sync_timestamp.empty())
+        metadata->sync_timestamp =
+            base::Time::FromJsTime(std::stod(sync_timestamp));
+      if (!last_send_time.empty())
+        metadata->last_send_time =
+            base::Time::FromJsTime(std::stod(last_send_time));
+      if (!last_updated_time.empty())
+        metadata->last_updated_time =
+            base::Time::FromJsTime(std::stod(last_updated_time));
+    }
+
+    bookmark_model_->DeleteNodeMetaInfo(node, "sync_timestamp");
+    bookmark_model_->DeleteNodeMetaInfo(node, "last_send_time");
+    bookmark_model_->DeleteNodeMetaInfo(node, "last_updated_time");
+  }
+
+  // drop entries of nodes deleted while the processor wasn't running
+  sync_metadata_->RetainOnly(ids);
+
+  // batches resolved in the meantime
+  if (!apply_batches_.empty()) {
+    base::SequencedTaskRunnerHandle::Get()->PostTask(FROM_HERE,
+        base::BindOnce(&BookmarkChangeProcessor::ApplyNextSlice,
+                       apply_weak_factory_.GetWeakPtr()));
+  }
+
+  if (ready_callback_)
+    std::move(ready_callback_).Run();
 }
 
 void BookmarkChangeProcessor::BookmarkModelLoaded(BookmarkModel* model,
@@ -238,12 +572,19 @@ void BookmarkChangeProcessor::BookmarkModelLoaded(BookmarkModel* model,
 
 void BookmarkChangeProcessor::BookmarkModelBeingDeleted(bookmarks::BookmarkModel* model) {
   NOTREACHED();
+  ClearObjectIdIndex();
+  ClearUnsyncedNodes();
+  ClearPendingApplies();
   bookmark_model_ = nullptr;
 }
 
 void BookmarkChangeProcessor::BookmarkNodeAdded(BookmarkModel* model,
                                                 const BookmarkNode* parent,
                                                 int index) {
+  // nodes restored by undo come back with their meta info
+  IndexSubtree(parent->GetChild(index));
+  MarkUnsyncedSubtree(parent->GetChild(index));
+  NotifyLocalChange();
 }
 
 void BookmarkChangeProcessor::OnWillRemoveBookmarks(BookmarkModel* model,
@@ -272,14 +613,14 @@ void BookmarkChangeProcessor::CloneBookmarkNodeForDeleteImpl(
   }
   cloned_node->SetTitle(element.title);
 
-  // clear sync timestsamp so this sends in unsynced records
-  bookmarks::BookmarkNode::MetaInfoMap meta_info_map = element.meta_info_map;
-  meta_info_map.erase("sync_timestamp");
-  cloned_node->SetMetaInfoMap(meta_info_map);
+  cloned_node->SetMetaInfoMap(element.meta_info_map);
 
   auto* cloned_node_ptr = cloned_node.get();
   parent->Add(std::move(cloned_node), index);
-  // we call `Changed` here because we don't want to update the order
+  // the clone now stands in for the removed node
+  IndexNode(cloned_node_ptr);
+  // we call `Changed` here because we don't want to update the order. This
+  // also clears the sync timestamp so the clone is sent as unsynced.
   BookmarkNodeChanged(bookmark_model_, cloned_node_ptr);
 }
 
@@ -299,6 +640,8 @@ void BookmarkChangeProcessor::BookmarkNodeRemoved(
     int old_index,
     const BookmarkNode* node,
     const std::set<GURL>& no_longer_bookmarked) {
+  ForgetSubtree(node);
+
   // TODO(bridiver) - should this be in OnWillRemoveBookmarks?
   // copy into the deleted node tree without firing any events
   auto* deleted_node = GetDeletedNodeRoot();
@@ -306,6 +649,7 @@ void BookmarkChangeProcessor::BookmarkNodeRemoved(
   bookmarks::BookmarkNodeData data(node);
   CloneBookmarkNodeForDelete(
       data.elements, deleted_node, deleted_node->child_count());
+  NotifyLocalChange();
 }
 
 void BookmarkChangeProcessor::BookmarkAllUserNodesRemoved(
@@ -313,23 +657,25 @@ void BookmarkChangeProcessor::BookmarkAllUserNodesRemoved(
     const std::set<GURL>& removed_urls) {
   // this only happens on profile deletion and we don't want
   // to wipe out the remote store when that happens
+  ClearObjectIdIndex();
+  ClearUnsyncedNodes();
 }
 
 void BookmarkChangeProcessor::BookmarkNodeChanged(BookmarkModel* model,
                                                   const BookmarkNode* node) {
-  ScopedPauseObserver pause(this);
+  BookmarkSyncMetadata* metadata = GetMutableSyncMetadata(node);
   // clearing the sync_timestamp will put the record back in the `Unsynced` list
-  model->DeleteNodeMetaInfo(node, "sync_timestamp");
+  metadata->sync_timestamp = base::Time();
   // also clear the last send time because this is a new change
-  model->DeleteNodeMetaInfo(node, "last_send_time");
-
-  model->SetNodeMetaInfo(node,
-      "last_updated_time",
-      std::to_string(base::Time::Now().ToJsTime()));
+  metadata->last_send_time = base::Time();
+  metadata->last_updated_time = base::Time::Now();
+  MarkUnsynced(node);
+  NotifyLocalChange();
 }
 
 void BookmarkChangeProcessor::BookmarkMetaInfoChanged(
     BookmarkModel* model, const BookmarkNode* node) {
+  IndexNode(node);
   BookmarkNodeChanged(model, node);
 }
 
@@ -337,6 +683,7 @@ void BookmarkChangeProcessor::BookmarkNodeMoved(BookmarkModel* model,
       const BookmarkNode* old_parent, int old_index,
       const BookmarkNode* new_parent, int new_index) {
   auto* node = new_parent->GetChild(new_index);
+  MarkUnsynced(node);
   model->DeleteNodeMetaInfo(node, "order");
   // TODO(darkdh): handle old_parent == new_parent to avoid duplicate order
   // clearing. Also https://github.com/brave/sync/issues/231 blocks update to
@@ -349,6 +696,12 @@ void BookmarkChangeProcessor::BookmarkNodeMoved(BookmarkModel* model,
     auto* shifted_node = new_parent->GetChild(i);
     model->DeleteNodeMetaInfo(shifted_node, "order");
   }
+  NotifyLocalChange();
+}
+
+void BookmarkChangeProcessor::NotifyLocalChange() {
+  if (local_change_callback_)
+    local_change_callback_.Run();
 }
 
 void BookmarkChangeProcessor::BookmarkNodeFaviconChanged(
@@ -375,15 +728,16 @@ void BookmarkChangeProcessor::Reset() {
       const bookmarks::BookmarkNode* node = iterator.Next();
       bookmark_model_->DeleteNodeMetaInfo(node, "object_id");
       bookmark_model_->DeleteNodeMetaInfo(node, "order");
-      bookmark_model_->DeleteNodeMetaInfo(node, "sync_timestamp");
-      bookmark_model_->DeleteNodeMetaInfo(node, "last_send_time");
-      bookmark_model_->DeleteNodeMetaInfo(node, "last_updated_time");
     }
   }
+  sync_metadata_->Clear();
 
   auto* deleted_node = GetDeletedNodeRoot();
   CHECK(deleted_node);
   deleted_node->DeleteAll();
+  ClearObjectIdIndex();
+  ClearUnsyncedNodes();
+  ClearPendingApplies();
   bookmark_model_->EndExtensiveChanges();
 }
 
@@ -402,77 +756,199 @@ void BookmarkChangeProcessor::DeleteSelfAndChildren(
 
 void BookmarkChangeProcessor::ApplyChangesFromSyncModel(
     const RecordsList &records) {
+  // records resolved before then were resolved without the sync timestamps
+  DCHECK(IsReady());
   ScopedPauseObserver pause(this);
   bookmark_model_->BeginExtensiveChanges();
   for (const auto& sync_record : records) {
+    const auto& bookmark_record = sync_record->GetBookmark();
+    ApplySyncRecord(sync_record.get(),
+                    GURL(bookmark_record.site.location),
+                    GetRecordTitle(bookmark_record));
+  }
+  bookmark_model_->EndExtensiveChanges();
+}
+
+void BookmarkChangeProcessor::ApplyChangesFromSyncModelInSlices(
+    std::unique_ptr<RecordsList> records,
+    base::OnceClosure callback) {
+  // nothing to wait for
+  if (records->empty() && preparing_batches_ == 0 && apply_batches_.empty()) {
+    std::move(callback).Run();
+    return;
+  }
+
+  ++preparing_batches_;
+  // replies come back in the order the batches were posted
+  base::PostTaskAndReplyWithResult(prepare_task_runner_.get(), FROM_HERE,
+      base::BindOnce(&BookmarkChangeProcessor::PrepareBatch,
+                     std::move(records)),
+      base::BindOnce(&BookmarkChangeProcessor::OnBatchPrepared,
+                     apply_weak_factory_.GetWeakPtr(),
+                     std::move(callback)));
+}
+
+BookmarkChangeProcessor::PreparedRecord::PreparedRecord() {}
+
+BookmarkChangeProcessor::PreparedRecord::PreparedRecord(
+    PreparedRecord&& record) = default;
+
+BookmarkChangeProcessor::PreparedRecord::~PreparedRecord() {}
+
+BookmarkChangeProcessor::ApplyBatch::ApplyBatch() : next_record(0) {}
+
+BookmarkChangeProcessor::ApplyBatch::~ApplyBatch() {}
+
+// static
+std::unique_ptr<BookmarkChangeProcessor::ApplyBatch>
+BookmarkChangeProcessor::PrepareBatch(std::unique_ptr<RecordsList> records) {
+  auto batch = std::make_unique<ApplyBatch>();
+  batch->records.reserve(records->size());
+  for (auto& sync_record : *records) {
     DCHECK(sync_record->has_bookmark());
-    DCHECK(!sync_record->objectId.empty());
+    PreparedRecord prepared;
+    const auto& bookmark_record = sync_record->GetBookmark();
+    prepared.url = GURL(bookmark_record.site.location);
+    prepared.title = GetRecordTitle(bookmark_record);
+    prepared.record = std::move(sync_record);
+    batch->records.push_back(std::move(prepared));
+  }
+  return batch;
+}
 
-    auto* node = FindByObjectId(bookmark_model_, sync_record->objectId);
-    auto bookmark_record = sync_record->GetBookmark();
+void BookmarkChangeProcessor::OnBatchPrepared(
+    base::OnceClosure callback,
+    std::unique_ptr<ApplyBatch> batch) {
+  DCHECK_GT(preparing_batches_, 0u);
+  --preparing_batches_;
+  batch->callback = std::move(callback);
+  apply_batches_.push_back(std::move(batch));
+  // otherwise a slice is already posted, or posted once ready
+  if (apply_batches_.size() == 1 && IsReady())
+    ApplyNextSlice();
+}
 
-    if (node && sync_record->action == jslib::SyncRecord::Action::A_UPDATE) {
-      int64_t old_parent_local_id = node->parent()->id();
-      const bookmarks::BookmarkNode* old_parent_node =
-          bookmarks::GetBookmarkNodeByID(bookmark_model_, old_parent_local_id);
+void BookmarkChangeProcessor::ApplyNextSlice() {
+  DCHECK(!apply_batches_.empty());
+  ApplyBatch* batch = apply_batches_.front().get();
 
-      std::string old_parent_object_id;
-      if (old_parent_node) {
-        old_parent_node->GetMetaInfo("object_id", &old_parent_object_id);
-      }
+  const base::TimeTicks deadline = base::TimeTicks::Now() +
+      base::TimeDelta::FromMilliseconds(kApplySliceTimeMs);
+  {
+    ScopedPauseObserver pause(this);
+    bookmark_model_->BeginExtensiveChanges();
+    while (batch->next_record < batch->records.size()) {
+      const PreparedRecord& prepared = batch->records[batch->next_record++];
+      ApplySyncRecord(prepared.record.get(), prepared.url, prepared.title);
+      if (base::TimeTicks::Now() >= deadline)
+        break;
+    }
+    bookmark_model_->EndExtensiveChanges();
+  }
 
-      const bookmarks::BookmarkNode* new_parent_node = nullptr;
-      if (bookmark_record.parentFolderObjectId != old_parent_object_id) {
-        new_parent_node = FindParent(bookmark_model_, bookmark_record);
-      }
+  base::OnceClosure callback;
+  if (batch->next_record == batch->records.size()) {
+    callback = std::move(batch->callback);
+    apply_batches_.pop_front();
+  }
 
-      if (new_parent_node) {
-        DCHECK(!bookmark_record.order.empty());
-        int64_t index = GetIndex(new_parent_node, bookmark_record);
-        bookmark_model_->Move(node, new_parent_node, index);
-      }
-      UpdateNode(bookmark_model_, node, sync_record.get());
-    } else if (node &&
-               sync_record->action == jslib::SyncRecord::Action::A_DELETE) {
-      if (node->parent() == GetDeletedNodeRoot()) {
-        // this is a deleted node so remove without firing events
-        int index = GetDeletedNodeRoot()->GetIndexOf(node);
-        GetDeletedNodeRoot()->Remove(index);
+  // let input and paint run before the next slice
+  if (!apply_batches_.empty()) {
+    base::SequencedTaskRunnerHandle::Get()->PostTask(FROM_HERE,
+        base::BindOnce(&BookmarkChangeProcessor::ApplyNextSlice,
+                       apply_weak_factory_.GetWeakPtr()));
+  }
+
+  if (callback)
+    std::move(callback).Run();
+}
+
+void BookmarkChangeProcessor::ClearPendingApplies() {
+  apply_weak_factory_.InvalidateWeakPtrs();
+  preparing_batches_ = 0;
+  apply_batches_.clear();
+}
+
+void BookmarkChangeProcessor::ApplySyncRecord(
+    const jslib::SyncRecord* sync_record,
+    const GURL& url,
+    const base::string16& title) {
+  DCHECK(sync_record->has_bookmark());
+  DCHECK(!sync_record->objectId.empty());
+
+  auto* node = FindByObjectId(sync_record->objectId);
+  const auto& bookmark_record = sync_record->GetBookmark();
+
+  if (node && sync_record->action == jslib::SyncRecord::Action::A_UPDATE) {
+    int64_t old_parent_local_id = node->parent()->id();
+    const bookmarks::BookmarkNode* old_parent_node =
+        bookmarks::GetBookmarkNodeByID(bookmark_model_, old_parent_local_id);
+
+    std::string old_parent_object_id;
+    if (old_parent_node) {
+      old_parent_node->GetMetaInfo("object_id", &old_parent_object_id);
+    }
+
+    const bookmarks::BookmarkNode* new_parent_node = nullptr;
+    if (bookmark_record.parentFolderObjectId != old_parent_object_id) {
+      new_parent_node = FindParent(
+          bookmark_model_, bookmark_record,
+          FindByObjectId(bookmark_record.parentFolderObjectId));
+    }
+
+    if (new_parent_node) {
+      DCHECK(!bookmark_record.order.empty());
+      int64_t index = GetIndex(new_parent_node, bookmark_record);
+      bookmark_model_->Move(node, new_parent_node, index);
+    }
+    UpdateNode(bookmark_model_, sync_metadata_.get(), node,
+               sync_record, url, title);
+    IndexNode(node);
+    MarkUnsynced(node);
+  } else if (node &&
+             sync_record->action == jslib::SyncRecord::Action::A_DELETE) {
+    ForgetSubtree(node);
+    if (node->parent() == GetDeletedNodeRoot()) {
+      // this is a deleted node so remove without firing events
+      int index = GetDeletedNodeRoot()->GetIndexOf(node);
+      GetDeletedNodeRoot()->Remove(index);
+    } else {
+      // normal remove
+      if (node->is_folder()) {
+        DeleteSelfAndChildren(node);
       } else {
-        // normal remove
-        if (node->is_folder()) {
-          DeleteSelfAndChildren(node);
-        } else {
-          bookmark_model_->Remove(node);
-        }
+        bookmark_model_->Remove(node);
       }
-    } else if (sync_record->action == jslib::SyncRecord::Action::A_CREATE) {
-      if (!node) {
-        // TODO(bridiver) make sure there isn't an existing record for objectId
-        const bookmarks::BookmarkNode* parent_node =
-            FindParent(bookmark_model_, bookmark_record);
-
-        const BookmarkNode* bookmark_bar = bookmark_model_->bookmark_bar_node();
-        bool bookmark_bar_was_empty = bookmark_bar->empty();
-        if (bookmark_record.isFolder) {
-          node = bookmark_model_->AddFolder(
-                          parent_node,
-                          GetIndex(parent_node, bookmark_record),
-                          base::UTF8ToUTF16(bookmark_record.site.title));
-        } else {
-          node = bookmark_model_->AddURL(parent_node,
-                          GetIndex(parent_node, bookmark_record),
-                          base::UTF8ToUTF16(bookmark_record.site.title),
-                          GURL(bookmark_record.site.location));
-        }
-        if (bookmark_bar_was_empty)
-          profile_->GetPrefs()->SetBoolean(bookmarks::prefs::kShowBookmarkBar,
-                                          true);
+    }
+  } else if (sync_record->action == jslib::SyncRecord::Action::A_CREATE) {
+    if (!node) {
+      // TODO(bridiver) make sure there isn't an existing record for objectId
+      const bookmarks::BookmarkNode* parent_node =
+          FindParent(bookmark_model_, bookmark_record,
+                     FindByObjectId(bookmark_record.parentFolderObjectId));
+
+      const BookmarkNode* bookmark_bar = bookmark_model_->bookmark_bar_node();
+      bool bookmark_bar_was_empty = bookmark_bar->empty();
+      if (bookmark_record.isFolder) {
+        node = bookmark_model_->AddFolder(
+                        parent_node,
+                        GetIndex(parent_node, bookmark_record),
+                        title);
+      } else {
+        node = bookmark_model_->AddURL(parent_node,
+                        GetIndex(parent_node, bookmark_record),
+                        title,
+                        url);
       }
-      UpdateNode(bookmark_model_, node, sync_record.get());
+      if (bookmark_bar_was_empty)
+        profile_->GetPrefs()->SetBoolean(bookmarks::prefs::kShowBookmarkBar,
+                                        true);
     }
+    UpdateNode(bookmark_model_, sync_metadata_.get(), node,
+               sync_record, url, title);
+    IndexNode(node);
+    MarkUnsynced(node);
   }
-  bookmark_model_->EndExtensiveChanges();
 }
 
 std::unique_ptr<jslib::SyncRecord>
@@ -524,11 +1000,9 @@ BookmarkChangeProcessor::BookmarkNodeToSyncBookmark(
 
   auto* deleted_node = GetDeletedNodeRoot();
   CHECK(deleted_node);
-  std::string sync_timestamp;
-  node->GetMetaInfo("sync_timestamp", &sync_timestamp);
-
-  if (!sync_timestamp.empty()) {
-    record->syncTimestamp = base::Time::FromJsTime(std::stod(sync_timestamp));
+  const BookmarkSyncMetadata* metadata = GetSyncMetadata(node);
+  if (metadata && !metadata->sync_timestamp.is_null()) {
+    record->syncTimestamp = metadata->sync_timestamp;
   } else {
     record->syncTimestamp = base::Time::Now();
   }
@@ -538,6 +1012,8 @@ BookmarkChangeProcessor::BookmarkNodeToSyncBookmark(
     record->objectId = tools::GenerateObjectId();
     record->action = jslib::SyncRecord::Action::A_CREATE;
     bookmark_model_->SetNodeMetaInfo(node, "object_id", record->objectId);
+    sync_metadata_->SetObjectId(node->id(), record->objectId);
+    IndexNode(node);
   } else if (node->HasAncestor(deleted_node)) {
     record->action = jslib::SyncRecord::Action::A_DELETE;
   } else {
@@ -550,39 +1026,28 @@ BookmarkChangeProcessor::BookmarkNodeToSyncBookmark(
   return record;
 }
 
-bool IsUnsynced(const bookmarks::BookmarkNode* node) {
-  std::string sync_timestamp;
-  node->GetMetaInfo("sync_timestamp", &sync_timestamp);
-
-  if (sync_timestamp.empty())
-    return true;
-
-  std::string last_updated_time;
-  node->GetMetaInfo("last_updated_time", &last_updated_time);
-
-  return !last_updated_time.empty() &&
-      base::Time::FromJsTime(std::stod(last_updated_time)) >
-      base::Time::FromJsTime(std::stod(sync_timestamp));
-}
-
 void BookmarkChangeProcessor::GetAllSyncData(
-    const std::vector<std::unique_ptr<jslib::SyncRecord>>& records,
+    RecordsList records,
     SyncRecordAndExistingList* records_and_existing_objects) {
-  for (const auto& record : records) {
+  records_and_existing_objects->reserve(
+      records_and_existing_objects->size() + records.size());
+  // the service doesn't fetch before then; without the sync timestamps
+  // every node would be paired and overwrite the other clients' changes
+  for (auto& record : records) {
     auto resolved_record = std::make_unique<SyncRecordAndExisting>();
-    resolved_record->first = jslib::SyncRecord::Clone(*record);
-    auto* node = FindByObjectId(bookmark_model_, record->objectId);
+    auto* node = IsReady() ? FindByObjectId(record->objectId) : nullptr;
     if (node) {
       // only match unsynced nodes so we don't accidentally overwrite
       // changes from another client with our local changes
       // TODO(darkdh): remove this hack once sync library can diffenrentiate
       // records by syncTimstamp
-      if (IsUnsynced(node) ||
+      if (IsUnsynced(GetSyncMetadata(node)) ||
           record->action != jslib::SyncRecord::Action::A_UPDATE) {
       resolved_record->second = BookmarkNodeToSyncBookmark(node);
       }
     }
 
+    resolved_record->first = std::move(record);
     records_and_existing_objects->push_back(std::move(resolved_record));
   }
 }
@@ -607,7 +1072,12 @@ bookmarks::BookmarkNode* BookmarkChangeProcessor::GetDeletedNodeRoot() {
 
 void BookmarkChangeProcessor::SendUnsynced(
     base::TimeDelta unsynced_send_interval) {
-  std::vector<std::unique_ptr<jslib::SyncRecord>> records;
+  // every node would look unsynced, the next send picks them up
+  if (!IsReady())
+    return;
+
+  if (!unsynced_nodes_built_)
+    BuildUnsyncedNodes();
 
   auto* deleted_node = GetDeletedNodeRoot();
   CHECK(deleted_node);
@@ -617,46 +1087,74 @@ void BookmarkChangeProcessor::SendUnsynced(
     deleted_node
   };
 
-  for (const auto* root_node : root_nodes) {
-    ui::TreeNodeIterator<const bookmarks::BookmarkNode>
-        iterator(root_node);
-    while (iterator.has_next()) {
-      const bookmarks::BookmarkNode* node = iterator.Next();
-
-      // only send unsynced records
-      if (!IsUnsynced(node))
+  const base::Time now = base::Time::Now();
+  std::vector<std::pair<std::vector<int>, const bookmarks::BookmarkNode*>>
+      nodes_to_send;
+  std::vector<int> position;
+
+  for (const auto* node : changed_nodes_) {
+    // only send unsynced records
+    const BookmarkSyncMetadata* metadata = GetSyncMetadata(node);
+    if (!GetSendPosition(root_nodes, node, &position) || !IsUnsynced(metadata))
+      continue;
+
+    if (metadata && !metadata->last_send_time.is_null()) {
+      const base::Time send_time = metadata->last_send_time;
+      // don't send more often than unsynced_send_interval_
+      if (now - send_time < unsynced_send_interval) {
+        sent_nodes_[node] = send_time;
+        resend_queue_.push(std::make_pair(send_time, node));
         continue;
+      }
+    }
+    nodes_to_send.push_back(std::make_pair(position, node));
+  }
+  changed_nodes_.clear();
+
+  // resend nodes the server hasn't echoed back in time
+  while (!resend_queue_.empty() &&
+         now - resend_queue_.top().first >= unsynced_send_interval) {
+    const SendTimeEntry entry = resend_queue_.top();
+    resend_queue_.pop();
+
+    auto it = sent_nodes_.find(entry.second);
+    if (it == sent_nodes_.end() || it->second != entry.first)
+      continue;
+    sent_nodes_.erase(it);
+
+    if (GetSendPosition(root_nodes, entry.second, &position) &&
+        IsUnsynced(GetSyncMetadata(entry.second)))
+      nodes_to_send.push_back(std::make_pair(position, entry.second));
+  }
 
-      std::string last_send_time;
-      node->GetMetaInfo("last_send_time", &last_send_time);
-      if (!last_send_time.empty() &&
-          // don't send more often than unsynced_send_interval_
-          (base::Time::Now() -
-              base::Time::FromJsTime(std::stod(last_send_time))) <
-          unsynced_send_interval)
-        continue;
+  // parents and previous siblings must get their object ids first
+  std::sort(nodes_to_send.begin(), nodes_to_send.end());
 
-      {
-        ScopedPauseObserver pause(this);
-        bookmark_model_->SetNodeMetaInfo(node,
-            "last_send_time", std::to_string(base::Time::Now().ToJsTime()));
-      }
-      auto record = BookmarkNodeToSyncBookmark(node);
-      if (record)
-        records.push_back(std::move(record));
-
-      if (records.size() == 1000) {
-        sync_client_->SendSyncRecords(
-            jslib_const::SyncRecordType_BOOKMARKS, records);
-        records.clear();
-      }
+  auto records = std::make_unique<RecordsList>();
+  for (const auto& node_to_send : nodes_to_send) {
+    const bookmarks::BookmarkNode* node = node_to_send.second;
+    GetMutableSyncMetadata(node)->last_send_time = now;
+    sent_nodes_[node] = now;
+    resend_queue_.push(std::make_pair(now, node));
+
+    auto record = BookmarkNodeToSyncBookmark(node);
+    if (record)
+      records->push_back(std::move(record));
+
+    if (records->size() == 1000) {
+      sync_client_->SendSyncRecords(
+          jslib_const::SyncRecordType_BOOKMARKS, std::move(records));
+      records = std::make_unique<RecordsList>();
     }
   }
-  if (!records.empty()) {
+  if (!records->empty()) {
     sync_client_->SendSyncRecords(
-      jslib_const::SyncRecordType_BOOKMARKS, records);
-    records.clear();
+      jslib_const::SyncRecordType_BOOKMARKS, std::move(records));
   }
+
+  // without observing the model there is no way to tell what changes next
+  if (!observing_)
+    ClearUnsyncedNodes();
 }
 
 void BookmarkChangeProcessor::InitialSync() {}
@@ -5,20 +5,38 @@
 #ifndef BRAVE_COMPONENTS_BRAVE_SYNC_CLIENT_BOOKMARKS_BOOKMARK_CHANGE_PROCESSOR_H_
 #define BRAVE_COMPONENTS_BRAVE_SYNC_CLIENT_BOOKMARKS_BOOKMARK_CHANGE_PROCESSOR_H_
 
+#include <deque>
+#include <functional>
+#include <memory>
+#include <queue>
 #include <set>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
 
+#include "base/callback.h"
 #include "base/compiler_specific.h"
 #include "base/macros.h"
+#include "base/memory/scoped_refptr.h"
+#include "base/memory/weak_ptr.h"
+#include "base/sequenced_task_runner.h"
+#include "base/strings/string16.h"
 #include "base/time/time.h"
 #include "brave/components/brave_sync/brave_sync_prefs.h"
+#include "brave/components/brave_sync/client/bookmark_sync_metadata_store.h"
 #include "brave/components/brave_sync/client/brave_sync_client.h"
 #include "brave/components/brave_sync/model/change_processor.h"
 #include "components/bookmarks/browser/bookmark_model_observer.h"
 #include "components/bookmarks/browser/bookmark_node.h"
 #include "components/bookmarks/browser/bookmark_node_data.h"
+#include "url/gurl.h"
 
 namespace brave_sync {
 
+class ScopedPauseObserver;
+
 class BookmarkChangeProcessor : public ChangeProcessor,
                                        bookmarks::BookmarkModelObserver  {
  public:
@@ -34,16 +52,73 @@ class BookmarkChangeProcessor : public ChangeProcessor,
   void Reset() override;
   void ApplyChangesFromSyncModel(const RecordsList &records) override;
   void GetAllSyncData(
-      const std::vector<std::unique_ptr<jslib::SyncRecord>>& records,
+      RecordsList records,
       SyncRecordAndExistingList* records_and_existing_objects) override;
   void SendUnsynced(base::TimeDelta unsynced_send_interval) override;
   void InitialSync() override;
 
+  // Like ApplyChangesFromSyncModel(), but converts the records in the
+  // background and applies them in short slices so that a large batch
+  // doesn't block the UI thread. Batches are applied in the order they were
+  // passed in, and |callback| runs once all of |records| is applied. Pending
+  // batches are dropped by Stop() and Reset().
+  void ApplyChangesFromSyncModelInSlices(std::unique_ptr<RecordsList> records,
+                                         base::OnceClosure callback);
+
+  // Whether the sync metadata is loaded and the legacy meta info migrated.
+  // Until then every node looks unsynced, so nothing is sent, resolved
+  // against local nodes or applied.
+  bool IsReady() const { return legacy_meta_info_migrated_; }
+  // Runs |callback| once IsReady(), replacing an earlier callback.
+  void set_ready_callback(base::OnceClosure callback) {
+    ready_callback_ = std::move(callback);
+  }
+
+  // Runs |callback| whenever the user changes a bookmark.
+  void set_local_change_callback(const base::RepeatingClosure& callback) {
+    local_change_callback_ = callback;
+  }
+
+  const BookmarkSyncMetadata* GetSyncMetadataForTesting(
+      const bookmarks::BookmarkNode* node) {
+    return GetSyncMetadata(node);
+  }
+
  private:
+  friend class ScopedPauseObserver;
+
+  // A bookmark record with the parts that don't depend on the model
+  // converted ahead of applying it.
+  struct PreparedRecord {
+    PreparedRecord();
+    PreparedRecord(PreparedRecord&& record);
+    ~PreparedRecord();
+
+    std::unique_ptr<jslib::SyncRecord> record;
+    GURL url;
+    base::string16 title;
+  };
+
+  // Records passed to one ApplyChangesFromSyncModelInSlices() call.
+  struct ApplyBatch {
+    ApplyBatch();
+    ~ApplyBatch();
+
+    std::vector<PreparedRecord> records;
+    // Index of the first record not applied yet.
+    size_t next_record;
+    base::OnceClosure callback;
+  };
+
   BookmarkChangeProcessor(Profile* profile,
                           BraveSyncClient* sync_client,
                           prefs::Prefs* sync_prefs);
 
+  // Stops observing the model while the processor changes it itself. The
+  // processor observes the model again once resumed.
+  void Pause();
+  void Resume();
+
   // bookmarks::BookmarkModelObserver:
   void BookmarkModelLoaded(bookmarks::BookmarkModel* model,
                            bool ids_reassigned) override;
@@ -77,6 +152,20 @@ class BookmarkChangeProcessor : public ChangeProcessor,
       bookmarks::BookmarkModel* model,
       const bookmarks::BookmarkNode* node) override;
 
+  // Runs on |prepare_task_runner_|.
+  static std::unique_ptr<ApplyBatch> PrepareBatch(
+      std::unique_ptr<RecordsList> records);
+  void OnBatchPrepared(base::OnceClosure callback,
+                       std::unique_ptr<ApplyBatch> batch);
+  // Applies records of the first pending batch until the slice's time is
+  // up, then posts the next slice.
+  void ApplyNextSlice();
+  void ClearPendingApplies();
+  // Applies one resolved record; |url| and |title| are the record's.
+  void ApplySyncRecord(const jslib::SyncRecord* sync_record,
+                       const GURL& url,
+                       const base::string16& title);
+
   std::unique_ptr<jslib::SyncRecord> BookmarkNodeToSyncBookmark(
       const bookmarks::BookmarkNode* node);
   bookmarks::BookmarkNode* GetDeletedNodeRoot();
@@ -92,6 +181,41 @@ class BookmarkChangeProcessor : public ChangeProcessor,
   // "Other Bookmarks" so we need to explicitly delete children
   void DeleteSelfAndChildren(const bookmarks::BookmarkNode* node);
 
+  const bookmarks::BookmarkNode* FindByObjectId(const std::string& object_id);
+  void BuildObjectIdIndex();
+  // Adds |node| to the object id index if it has an object id.
+  void IndexNode(const bookmarks::BookmarkNode* node);
+  void IndexSubtree(const bookmarks::BookmarkNode* node);
+  // Must be called before |node| and its children are deleted while the
+  // processor is paused.
+  void UnindexSubtree(const bookmarks::BookmarkNode* node);
+  void ClearObjectIdIndex();
+
+  // Collects every unsynced node when SendUnsynced first runs; after that
+  // the observer methods report the nodes that may need sending.
+  void BuildUnsyncedNodes();
+  void MarkUnsynced(const bookmarks::BookmarkNode* node);
+  void MarkUnsyncedSubtree(const bookmarks::BookmarkNode* node);
+  void ClearUnsyncedNodes();
+
+  // Drops |node| and its children from the object id index, the unsynced
+  // node tracking and the sync metadata store. Must be called before they
+  // are deleted while the processor is paused.
+  void ForgetSubtree(const bookmarks::BookmarkNode* node);
+
+  // Sync timestamps of |node|, nullptr if it has none.
+  const BookmarkSyncMetadata* GetSyncMetadata(
+      const bookmarks::BookmarkNode* node);
+  BookmarkSyncMetadata* GetMutableSyncMetadata(
+      const bookmarks::BookmarkNode* node);
+  void OnSyncMetadataLoaded();
+  // Moves the timestamps older versions kept in the bookmark meta info into
+  // the sync metadata store, once the store is loaded and the processor has
+  // started.
+  void MaybeMigrateLegacyMetaInfo();
+
+  void NotifyLocalChange();
+
   BraveSyncClient* sync_client_;  // not owned
   prefs::Prefs* sync_prefs_;  // not owned
   Profile* profile_; // not owned
@@ -99,6 +223,44 @@ class BookmarkChangeProcessor : public ChangeProcessor,
 
   bookmarks::BookmarkNode* deleted_node_root_;
 
+  // Whether the processor sees every change to the model, either through
+  // its observer methods or because it made the change itself. The object
+  // id index is only kept while this is true.
+  bool observing_;
+  // Maps "object_id" meta info to nodes, built on first use.
+  bool object_id_index_built_;
+  std::unordered_map<std::string, const bookmarks::BookmarkNode*>
+      object_id_index_;
+
+  // Unsynced node tracking, also only kept while |observing_|.
+  using SendTimeEntry = std::pair<base::Time, const bookmarks::BookmarkNode*>;
+  bool unsynced_nodes_built_;
+  // Nodes changed since SendUnsynced last looked at them.
+  std::unordered_set<const bookmarks::BookmarkNode*> changed_nodes_;
+  // Sent nodes waiting for the server to echo them back, with the time they
+  // were last sent.
+  std::unordered_map<const bookmarks::BookmarkNode*, base::Time> sent_nodes_;
+  // Entries of |sent_nodes_|, oldest send first. An entry whose time no
+  // longer matches |sent_nodes_| is stale and skipped.
+  std::priority_queue<SendTimeEntry,
+                      std::vector<SendTimeEntry>,
+                      std::greater<SendTimeEntry>> resend_queue_;
+
+  std::unique_ptr<BookmarkSyncMetadataStore> sync_metadata_;
+  bool legacy_meta_info_migrated_;
+
+  base::OnceClosure ready_callback_;
+  base::RepeatingClosure local_change_callback_;
+
+  scoped_refptr<base::SequencedTaskRunner> prepare_task_runner_;
+  // Batches posted to |prepare_task_runner_| whose reply hasn't come back.
+  size_t preparing_batches_;
+  // Prepared batches, applied front first. A slice is posted while this
+  // isn't empty and the processor IsReady().
+  std::deque<std::unique_ptr<ApplyBatch>> apply_batches_;
+  // Invalidated to drop pending batches.
+  base::WeakPtrFactory<BookmarkChangeProcessor> apply_weak_factory_;
+
   DISALLOW_COPY_AND_ASSIGN(BookmarkChangeProcessor);
 };
 
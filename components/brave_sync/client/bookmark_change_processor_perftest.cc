@@ -0,0 +1,275 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <string>
+#include <utility>
+
+#include "base/files/scoped_temp_dir.h"
+#include "base/run_loop.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/utf_string_conversions.h"
+#include "base/time/time.h"
+#include "brave/components/brave_sync/brave_sync_prefs.h"
+#include "brave/components/brave_sync/client/bookmark_change_processor.h"
+#include "brave/components/brave_sync/jslib_messages.h"
+#include "brave/components/brave_sync/test_util.h"
+#include "chrome/browser/bookmarks/bookmark_model_factory.h"
+#include "chrome/browser/profiles/profile.h"
+#include "components/bookmarks/browser/bookmark_model.h"
+#include "content/public/test/test_browser_thread_bundle.h"
+#include "testing/gmock/include/gmock/gmock.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_test.h"
+
+// npm run test -- brave_perftests --filter=BraveSyncBookmarkPerfTest.*
+
+using testing::NiceMock;
+
+namespace brave_sync {
+
+namespace {
+
+// Shape of a synthetic bookmark tree: every folder down to |depth| has
+// |folders| subfolders, and every folder holds |urls| bookmarks.
+struct TreeShape {
+  const char* name;
+  int depth;
+  int folders;
+  int urls;
+};
+
+const TreeShape kTreeShapes[] = {
+  // 100 folders with 100 bookmarks each, ~10k nodes
+  {"wide_10k", 1, 100, 100},
+  // ~100k nodes
+  {"wide_100k", 1, 1000, 100},
+  // 6 levels of 3 folders with 10 bookmarks each, ~12k nodes
+  {"deep_10k", 6, 3, 10},
+  // ~108k nodes
+  {"deep_100k", 8, 3, 10},
+};
+
+// Bookmarks inserted into one folder in random order, which makes every
+// insert look its position up by order.
+const int kShuffledBookmarks = 10000;
+
+// Share of the nodes changed locally before an incremental SendUnsynced.
+const int kLocalChangePercent = 1;
+
+// Appends create records for the folders and bookmarks below the folder
+// with |parent_object_id| and |parent_order|, parents first.
+void AddTreeRecords(const TreeShape& shape,
+                    int level,
+                    const std::string& parent_object_id,
+                    const std::string& parent_order,
+                    RecordsList* records) {
+  int index = 1;
+  if (level > 0) {
+    for (int i = 0; i < shape.urls; ++i, ++index) {
+      const std::string order = parent_order + "." + base::IntToString(index);
+      records->push_back(SimpleBookmarkSyncRecord(
+          jslib::SyncRecord::Action::A_CREATE,
+          "",
+          "https://" + order + ".example.com/",
+          order,
+          order,
+          parent_object_id));
+    }
+  }
+
+  if (level == shape.depth)
+    return;
+
+  for (int i = 0; i < shape.folders; ++i, ++index) {
+    const std::string order = parent_order + "." + base::IntToString(index);
+    records->push_back(SimpleFolderSyncRecord(
+        jslib::SyncRecord::Action::A_CREATE,
+        order,
+        order,
+        parent_object_id,
+        true,
+        ""));
+    const std::string object_id = records->back()->objectId;
+    AddTreeRecords(shape, level + 1, object_id, order, records);
+  }
+}
+
+// Copies of |records| with |action|.
+RecordsList CloneRecords(const RecordsList& records, int action) {
+  RecordsList clones;
+  clones.reserve(records.size());
+  for (const auto& record : records) {
+    clones.push_back(jslib::SyncRecord::Clone(*record));
+    clones.back()->action = static_cast<jslib::SyncRecord::Action>(action);
+  }
+  return clones;
+}
+
+}  // namespace
+
+class BraveSyncBookmarkPerfTest : public testing::Test {
+ public:
+  BraveSyncBookmarkPerfTest() {}
+  ~BraveSyncBookmarkPerfTest() override {}
+
+ protected:
+  void SetUp() override {
+    ASSERT_TRUE(temp_dir_.CreateUniqueTempDir());
+  }
+
+  void TearDown() override {
+    DestroyProfile();
+  }
+
+  // Creates a profile with an empty bookmark model and a started processor
+  // whose sync metadata is loaded.
+  // Each profile of a test needs its own |name|.
+  void CreateProfile(const std::string& name) {
+    profile_ = CreateBraveSyncProfile(temp_dir_.GetPath().AppendASCII(name));
+    ASSERT_TRUE(profile_);
+
+    sync_client_ = std::make_unique<NiceMock<MockBraveSyncClient>>();
+
+    BookmarkModelFactory::GetInstance()->SetTestingFactory(
+        profile_.get(), &BuildFakeBookmarkModelForTests);
+    model_ = BookmarkModelFactory::GetForBrowserContext(profile_.get());
+
+    sync_prefs_ = std::make_unique<prefs::Prefs>(profile_->GetPrefs());
+    sync_prefs_->SetThisDeviceId("1");
+
+    change_processor_.reset(BookmarkChangeProcessor::Create(
+        profile_.get(), sync_client_.get(), sync_prefs_.get()));
+    change_processor_->Start();
+    // the processor neither sends nor applies before its sync metadata is
+    // loaded
+    if (!change_processor_->IsReady()) {
+      base::RunLoop run_loop;
+      change_processor_->set_ready_callback(run_loop.QuitClosure());
+      run_loop.Run();
+    }
+    ASSERT_TRUE(change_processor_->IsReady());
+  }
+
+  void DestroyProfile() {
+    if (change_processor_)
+      change_processor_->Stop();
+    change_processor_.reset();
+    sync_prefs_.reset();
+    sync_client_.reset();
+    profile_.reset();
+  }
+
+  bookmarks::BookmarkModel* model() { return model_; }
+  BookmarkChangeProcessor* change_processor() {
+    return change_processor_.get();
+  }
+
+  // Prints the time |closure| takes as |measurement| of |trace|.
+  template <typename Closure>
+  void Measure(const std::string& measurement,
+               const std::string& trace,
+               size_t records,
+               Closure closure) {
+    const base::TimeTicks start = base::TimeTicks::Now();
+    closure();
+    const base::TimeDelta elapsed = base::TimeTicks::Now() - start;
+    perf_test::PrintResult(measurement, "", trace,
+                           elapsed.InMillisecondsF(), "ms", true);
+    if (records > 0) {
+      perf_test::PrintResult(measurement + "_per_record", "", trace,
+                             elapsed.InMicrosecondsF() / records, "us", false);
+    }
+  }
+
+ private:
+  content::TestBrowserThreadBundle thread_bundle_;
+
+  base::ScopedTempDir temp_dir_;
+  std::unique_ptr<Profile> profile_;
+  std::unique_ptr<NiceMock<MockBraveSyncClient>> sync_client_;
+  bookmarks::BookmarkModel* model_;  // not owned
+  std::unique_ptr<prefs::Prefs> sync_prefs_;
+  std::unique_ptr<BookmarkChangeProcessor> change_processor_;
+};
+
+TEST_F(BraveSyncBookmarkPerfTest, SyncLargeTrees) {
+  for (const TreeShape& shape : kTreeShapes) {
+    const std::string trace = shape.name;
+    CreateProfile(trace);
+
+    RecordsList creates;
+    AddTreeRecords(shape, 0, "", "1.1.1", &creates);
+    perf_test::PrintResult("nodes", "", trace, creates.size(), "count", false);
+
+    // the initial sync of a profile with no bookmarks
+    Measure("apply_creates", trace, creates.size(), [&]() {
+      change_processor()->ApplyChangesFromSyncModel(creates);
+    });
+    ASSERT_EQ(static_cast<size_t>(model()->other_node()->child_count()),
+              static_cast<size_t>(shape.folders));
+
+    // records fetched again, resolved against the existing nodes
+    RecordsList fetched =
+        CloneRecords(creates, jslib::SyncRecord::Action::A_UPDATE);
+    SyncRecordAndExistingList resolved;
+    Measure("get_all_sync_data", trace, fetched.size(), [&]() {
+      change_processor()->GetAllSyncData(std::move(fetched), &resolved);
+    });
+    ASSERT_EQ(resolved.size(), creates.size());
+
+    RecordsList updates =
+        CloneRecords(creates, jslib::SyncRecord::Action::A_UPDATE);
+    Measure("apply_updates", trace, updates.size(), [&]() {
+      change_processor()->ApplyChangesFromSyncModel(updates);
+    });
+
+    // the first call looks at every node
+    Measure("send_unsynced_first", trace, creates.size(), [&]() {
+      change_processor()->SendUnsynced(base::TimeDelta::FromMinutes(10));
+    });
+
+    // a few local edits between two sends
+    const size_t changes = creates.size() * kLocalChangePercent / 100;
+    const bookmarks::BookmarkNode* folder = model()->other_node()->GetChild(0);
+    for (size_t i = 0; i < changes; ++i) {
+      model()->AddURL(folder, 0,
+                      base::ASCIIToUTF16("local"),
+                      GURL("https://local" + base::NumberToString(i) +
+                           ".example.com/"));
+    }
+    Measure("send_unsynced_incremental", trace, changes, [&]() {
+      change_processor()->SendUnsynced(base::TimeDelta::FromMinutes(10));
+    });
+
+    DestroyProfile();
+  }
+}
+
+TEST_F(BraveSyncBookmarkPerfTest, ShuffledCreatesIntoOneFolder) {
+  CreateProfile("one_folder");
+
+  RecordsList creates;
+  for (int i = 0; i < kShuffledBookmarks; ++i) {
+    const std::string order = "1.1.1." + base::IntToString(i + 1);
+    creates.push_back(SimpleBookmarkSyncRecord(
+        jslib::SyncRecord::Action::A_CREATE,
+        "",
+        "https://" + order + ".example.com/",
+        order,
+        order,
+        ""));
+  }
+  // a fixed seed keeps runs comparable
+  std::shuffle(creates.begin(), creates.end(), std::mt19937(42));
+
+  Measure("apply_shuffled_creates", "one_folder", creates.size(), [&]() {
+    change_processor()->ApplyChangesFromSyncModel(creates);
+  });
+  EXPECT_EQ(model()->other_node()->child_count(), kShuffledBookmarks);
+}
+
+}  // namespace brave_sync
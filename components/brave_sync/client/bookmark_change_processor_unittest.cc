@@ -2,6 +2,7 @@
  * License, v. 2.0. If a copy of the MPL was not distributed with this file,
  * You can obtain one at http://mozilla.org/MPL/2.0/. */
 
+#include "base/bind.h"
 #include "base/files/scoped_temp_dir.h"
 #include "base/strings/utf_string_conversions.h"
 #include "brave/components/brave_sync/client/bookmark_change_processor.h"
@@ -34,8 +35,10 @@
 // Stop                        | +
 // Reset                       | +
 // ApplyChangesFromSyncModel   | +
+// ApplyChangesFromSyncModelInSlices | +
 // GetAllSyncData              | +
 // SendUnsynced                | +
+// IsReady                     | +
 // InitialSync                 | N/A
 
 // bookmarks::BookmarkModelObserver overrides:
@@ -58,7 +61,7 @@ using namespace bookmarks;
 
 MATCHER_P2(ContainsRecord, action, location,
     "contains sync record with params") {
-  for (const auto& record : arg) {
+  for (const auto& record : *arg) {
     if (record->has_bookmark()) {
       const auto& bookmark = record->GetBookmark();
       if (record->action == action &&
@@ -72,16 +75,16 @@ MATCHER_P2(ContainsRecord, action, location,
 
 MATCHER_P(RecordsNumber, expected_number,
     "contains specified sync record number") {
-  return static_cast<int>(arg.size()) == static_cast<int>(expected_number);
+  return static_cast<int>(arg->size()) == static_cast<int>(expected_number);
 }
 
 MATCHER_P(AllRecordsHaveAction, expected_action,
     "all records have expected action") {
-  if (arg.empty()) {
+  if (arg->empty()) {
     return false;
   }
 
-  for (const auto& record : arg) {
+  for (const auto& record : *arg) {
     if (record->action != expected_action) {
       return false;
     }
@@ -116,6 +119,8 @@ class BraveBookmarkChangeProcessorTest : public testing::Test {
         sync_client(),
         sync_prefs_.get()
     ));
+    // the sync metadata loads in the background
+    thread_bundle_.RunUntilIdle();
 
     EXPECT_NE(sync_client(), nullptr);
     EXPECT_NE(bookmark_client(), nullptr);
@@ -135,10 +140,23 @@ class BraveBookmarkChangeProcessorTest : public testing::Test {
   brave_sync::BookmarkChangeProcessor* change_processor() {
     return change_processor_.get();
   }
+  content::TestBrowserThreadBundle* thread_bundle() { return &thread_bundle_; }
+
+  // Replaces the processor by a new one whose sync metadata isn't loaded
+  // yet, as after a restart.
+  void RecreateChangeProcessor() {
+    change_processor_->Stop();
+    change_processor_.reset();
+    // the old store writes its entries in the background
+    thread_bundle_.RunUntilIdle();
+    change_processor_.reset(BookmarkChangeProcessor::Create(
+        profile_.get(), sync_client(), sync_prefs_.get()));
+  }
 
   void BookmarkAddedImpl();
   void BookmarkCreatedFromSyncImpl();
   bool HasAnySyncMetaInfo(const BookmarkNode* node);
+  base::Time GetLastUpdatedTime(const BookmarkNode* node);
   void AddSimpleHierarchy(
       const BookmarkNode** folder1, const BookmarkNode** node_a,
       const BookmarkNode** node_b, const BookmarkNode** node_c);
@@ -158,14 +176,12 @@ class BraveBookmarkChangeProcessorTest : public testing::Test {
 };
 
 TEST_F(BraveBookmarkChangeProcessorTest, StartObserver) {
-  // The mark of observer processed: metainfo "last_updated_time" is set
+  // The mark of observer processed: "last_updated_time" is set
   const auto* node_a = model()->AddURL(model()->other_node(), 0,
                                        base::ASCIIToUTF16("A.com - title"),
                                        GURL("https://a.com/"));
   model()->SetTitle(node_a, base::ASCIIToUTF16("A.com - title - upated"));
-  std::string last_updated_time_a;
-  node_a->GetMetaInfo("last_updated_time", &last_updated_time_a);
-  EXPECT_TRUE(last_updated_time_a.empty());
+  EXPECT_TRUE(GetLastUpdatedTime(node_a).is_null());
 
   change_processor()->Start();
 
@@ -173,21 +189,20 @@ TEST_F(BraveBookmarkChangeProcessorTest, StartObserver) {
                                        base::ASCIIToUTF16("B.com - title"),
                                        GURL("https://b.com/"));
   model()->SetTitle(node_b, base::ASCIIToUTF16("B.com - title - upated"));
+  EXPECT_FALSE(GetLastUpdatedTime(node_b).is_null());
+  // sync bookkeeping stays out of the bookmark meta info
   std::string last_updated_time_b;
-  node_b->GetMetaInfo("last_updated_time", &last_updated_time_b);
-  EXPECT_TRUE(!last_updated_time_b.empty());
+  EXPECT_FALSE(node_b->GetMetaInfo("last_updated_time", &last_updated_time_b));
 }
 
 TEST_F(BraveBookmarkChangeProcessorTest, StopObserver) {
-  // The mark of observer processed: metainfo "last_updated_time" is set
+  // The mark of observer processed: "last_updated_time" is set
   change_processor()->Start();
   const auto* node_a = model()->AddURL(model()->other_node(), 0,
                                        base::ASCIIToUTF16("A.com - title"),
                                        GURL("https://a.com/"));
   model()->SetTitle(node_a, base::ASCIIToUTF16("A.com - title - upated"));
-  std::string last_updated_time_a;
-  node_a->GetMetaInfo("last_updated_time", &last_updated_time_a);
-  EXPECT_TRUE(!last_updated_time_a.empty());
+  EXPECT_FALSE(GetLastUpdatedTime(node_a).is_null());
 
   change_processor()->Stop();
 
@@ -195,23 +210,27 @@ TEST_F(BraveBookmarkChangeProcessorTest, StopObserver) {
                                        base::ASCIIToUTF16("B.com - title"),
                                        GURL("https://b.com/"));
   model()->SetTitle(node_b, base::ASCIIToUTF16("B.com - title - upated"));
-  std::string last_updated_time_b;
-  node_b->GetMetaInfo("last_updated_time", &last_updated_time_b);
-  EXPECT_TRUE(last_updated_time_b.empty());
+  EXPECT_TRUE(GetLastUpdatedTime(node_b).is_null());
 }
 
 bool BraveBookmarkChangeProcessorTest::HasAnySyncMetaInfo(
                                                     const BookmarkNode* node) {
   DCHECK(node);
-  const std::vector<std::string> keys = {"object_id", "order", "sync_timestamp", "last_send_time",
-                     "last_updated_time"};
+  const std::vector<std::string> keys = {"object_id", "order"};
   for (const auto& key : keys ) {
     std::string value;
     if (node->GetMetaInfo(key, &value) && !value.empty()) {
       return true;
     }
   }
-  return false;
+  return change_processor()->GetSyncMetadataForTesting(node) != nullptr;
+}
+
+base::Time BraveBookmarkChangeProcessorTest::GetLastUpdatedTime(
+    const BookmarkNode* node) {
+  const BookmarkSyncMetadata* metadata =
+      change_processor()->GetSyncMetadataForTesting(node);
+  return metadata ? metadata->last_updated_time : base::Time();
 }
 
 void BraveBookmarkChangeProcessorTest::AddSimpleHierarchy(
@@ -414,6 +433,37 @@ TEST_F(BraveBookmarkChangeProcessorTest, DeleteFolderWithNodes) {
   change_processor()->SendUnsynced(base::TimeDelta::FromMinutes(10));
 }
 
+TEST_F(BraveBookmarkChangeProcessorTest, SendUnsyncedOnlySendsChanges) {
+  change_processor()->Start();
+
+  const BookmarkNode* folder1;
+  const BookmarkNode* node_a;
+  const BookmarkNode* node_b;
+  const BookmarkNode* node_c;
+  AddSimpleHierarchy(&folder1, &node_a, &node_b, &node_c);
+
+  EXPECT_CALL(*sync_client(), SendSyncRecords("BOOKMARKS",
+      RecordsNumber(4))).Times(1);
+  change_processor()->SendUnsynced(base::TimeDelta::FromMinutes(10));
+
+  // nothing changed and nothing is due for a resend
+  EXPECT_CALL(*sync_client(), SendSyncRecords("BOOKMARKS", _)).Times(0);
+  change_processor()->SendUnsynced(base::TimeDelta::FromMinutes(10));
+
+  model()->SetTitle(node_b, base::ASCIIToUTF16("B.com - modified"));
+  using brave_sync::jslib::SyncRecord;
+  EXPECT_CALL(*sync_client(), SendSyncRecords("BOOKMARKS",
+      ContainsRecord(SyncRecord::Action::A_UPDATE, "https://b.com/")))
+      .Times(1);
+  change_processor()->SendUnsynced(base::TimeDelta::FromMinutes(10));
+
+  // everything sent is still unsynced, so it all goes again once the
+  // interval has passed
+  EXPECT_CALL(*sync_client(), SendSyncRecords("BOOKMARKS",
+      RecordsNumber(4))).Times(1);
+  change_processor()->SendUnsynced(base::TimeDelta::FromMinutes(0));
+}
+
 // Another type of tests with `change_processor()->ApplyChangesFromSyncModel`
 // Without any mocks
 // May ignore order, because it will be moved into background.js
@@ -562,6 +612,68 @@ TEST_F(BraveBookmarkChangeProcessorTest, NestedFoldersCreatedFromSync) {
   EXPECT_EQ(node_b->url().spec(), "https://b.com/");
 }
 
+TEST_F(BraveBookmarkChangeProcessorTest, ObjectIdLookupsFollowSyncChanges) {
+  // Create a.com in Folder1 from sync, move it to Folder2 from sync and then
+  // remove it from sync; each step must find the nodes created before it
+  change_processor()->Start();
+
+  RecordsList records;
+  records.push_back(SimpleFolderSyncRecord(
+      jslib::SyncRecord::Action::A_CREATE,
+      "Folder1",
+      "1.1.1.1",
+      "", true, ""));
+  records.push_back(SimpleFolderSyncRecord(
+      jslib::SyncRecord::Action::A_CREATE,
+      "Folder2",
+      "1.1.1.2",
+      "", true, ""));
+  records.push_back(SimpleBookmarkSyncRecord(
+      jslib::SyncRecord::Action::A_CREATE,
+      "",
+      "https://a.com/",
+      "A.com - title",
+      "1.1.1.1.1",
+      records.at(0)->objectId));
+  const std::string folder2_object_id = records.at(1)->objectId;
+  const std::string a_object_id = records.at(2)->objectId;
+  change_processor()->ApplyChangesFromSyncModel(records);
+
+  ASSERT_EQ(model()->other_node()->child_count(), 2);
+  const auto* folder1 = model()->other_node()->GetChild(0);
+  const auto* folder2 = model()->other_node()->GetChild(1);
+  ASSERT_EQ(folder1->child_count(), 1);
+
+  records.clear();
+  records.push_back(SimpleBookmarkSyncRecord(
+      jslib::SyncRecord::Action::A_UPDATE,
+      a_object_id,
+      "https://a.com/",
+      "A.com - title",
+      "1.1.1.2.1",
+      folder2_object_id));
+  change_processor()->ApplyChangesFromSyncModel(records);
+
+  EXPECT_EQ(folder1->child_count(), 0);
+  ASSERT_EQ(folder2->child_count(), 1);
+  EXPECT_EQ(folder2->GetChild(0)->url().spec(), "https://a.com/");
+
+  records.clear();
+  records.push_back(SimpleBookmarkSyncRecord(
+      jslib::SyncRecord::Action::A_DELETE,
+      a_object_id,
+      "https://a.com/",
+      "A.com - title",
+      "1.1.1.2.1",
+      folder2_object_id));
+  change_processor()->ApplyChangesFromSyncModel(records);
+
+  EXPECT_EQ(folder2->child_count(), 0);
+  std::vector<const BookmarkNode*> nodes;
+  model()->GetNodesByURL(GURL("https://a.com/"), &nodes);
+  EXPECT_TRUE(nodes.empty());
+}
+
 TEST_F(BraveBookmarkChangeProcessorTest, ChildrenOfPermanentNodesFromSync) {
   // Record with 1.x.y order, with hideInToolbar=false and empty
   //      parent_object_id should go to toolbar node
@@ -720,9 +832,13 @@ TEST_F(BraveBookmarkChangeProcessorTest, GetAllSyncData) {
       "D.com - title",
       "1.1.1.4", ""));
 
+  RecordsList records_to_send;
+  for (const auto& record : records_to_resolve)
+    records_to_send.push_back(jslib::SyncRecord::Clone(*record));
+
   SyncRecordAndExistingList records_and_existing_objects;
-  change_processor()->GetAllSyncData(records_to_resolve,
-                                                &records_and_existing_objects);
+  change_processor()->GetAllSyncData(std::move(records_to_send),
+                                     &records_and_existing_objects);
   ASSERT_EQ(records_and_existing_objects.size(), 3u);
 
   const auto& pair_at_0 = records_and_existing_objects.at(0);
@@ -744,6 +860,73 @@ TEST_F(BraveBookmarkChangeProcessorTest, GetAllSyncData) {
   EXPECT_EQ(pair_at_2->second.get(), nullptr);
 }
 
+TEST_F(BraveBookmarkChangeProcessorTest, WaitsForSyncMetadata) {
+  change_processor()->Start();
+
+  RecordsList records;
+  records.push_back(SimpleBookmarkSyncRecord(
+      jslib::SyncRecord::Action::A_CREATE,
+      "111, 111, 37, 61, 199, 11, 166, 234, 214, 197, 45, 215, 241, 206, 219, 130",
+      "https://a.com/",
+      "A.com - title",
+      "1.1.1.1", ""));
+  change_processor()->ApplyChangesFromSyncModel(records);
+  std::vector<const BookmarkNode*> nodes;
+  model()->GetNodesByURL(GURL("https://a.com/"), &nodes);
+  ASSERT_EQ(nodes.size(), 1u);
+  const auto* node_a = nodes.at(0);
+
+  RecreateChangeProcessor();
+  bool ready = false;
+  change_processor()->set_ready_callback(
+      base::BindOnce([](bool* ready) { *ready = true; }, &ready));
+  change_processor()->Start();
+  EXPECT_FALSE(change_processor()->IsReady());
+
+  // until the metadata is loaded node_a would look unsynced
+  EXPECT_CALL(*sync_client(), SendSyncRecords("BOOKMARKS", _)).Times(0);
+  change_processor()->SendUnsynced(base::TimeDelta::FromMinutes(0));
+
+  RecordsList records_to_resolve;
+  records_to_resolve.push_back(SimpleBookmarkSyncRecord(
+      jslib::SyncRecord::Action::A_UPDATE,
+      "111, 111, 37, 61, 199, 11, 166, 234, 214, 197, 45, 215, 241, 206, 219, 130",
+      "https://a.com/",
+      "A.com - title - modified",
+      "1.1.1.1", ""));
+  SyncRecordAndExistingList records_and_existing_objects;
+  change_processor()->GetAllSyncData(std::move(records_to_resolve),
+                                     &records_and_existing_objects);
+  ASSERT_EQ(records_and_existing_objects.size(), 1u);
+  EXPECT_EQ(records_and_existing_objects.at(0)->second.get(), nullptr);
+
+  auto updates = std::make_unique<RecordsList>();
+  updates->push_back(SimpleBookmarkSyncRecord(
+      jslib::SyncRecord::Action::A_UPDATE,
+      "111, 111, 37, 61, 199, 11, 166, 234, 214, 197, 45, 215, 241, 206, 219, 130",
+      "https://a.com/",
+      "A.com - title - modified",
+      "1.1.1.1", ""));
+  bool applied = false;
+  change_processor()->ApplyChangesFromSyncModelInSlices(
+      std::move(updates),
+      base::BindOnce([](bool* applied) { *applied = true; }, &applied));
+
+  thread_bundle()->RunUntilIdle();
+  EXPECT_TRUE(ready);
+  EXPECT_TRUE(change_processor()->IsReady());
+  // the update is applied once the metadata is there
+  EXPECT_TRUE(applied);
+  EXPECT_EQ(base::UTF16ToUTF8(node_a->GetTitle()), "A.com - title - modified");
+
+  // and node_a kept its sync timestamp
+  const BookmarkSyncMetadata* metadata =
+      change_processor()->GetSyncMetadataForTesting(node_a);
+  ASSERT_NE(metadata, nullptr);
+  EXPECT_FALSE(metadata->sync_timestamp.is_null());
+  change_processor()->SendUnsynced(base::TimeDelta::FromMinutes(0));
+}
+
 TEST_F(BraveBookmarkChangeProcessorTest, TitleCustomTitle) {
   // Should be able to create folder when title = "" and customTitle != ""
   // Create these:
@@ -780,3 +963,76 @@ TEST_F(BraveBookmarkChangeProcessorTest, TitleCustomTitle) {
   const auto* folder2 = folder1->GetChild(0);
   EXPECT_EQ(base::UTF16ToUTF8(folder2->GetTitle()), "Folder2");
 }
+
+TEST_F(BraveBookmarkChangeProcessorTest, ApplyChangesInSlices) {
+  change_processor()->Start();
+
+  auto folder_records = std::make_unique<RecordsList>();
+  folder_records->push_back(SimpleFolderSyncRecord(
+      jslib::SyncRecord::Action::A_CREATE,
+      "Folder1",
+      "1.1.1.1",
+      "", true, ""));
+  const std::string folder_object_id = folder_records->at(0)->objectId;
+
+  // a batch can depend on the one before it
+  auto bookmark_records = std::make_unique<RecordsList>();
+  for (int i = 0; i < 3; ++i) {
+    bookmark_records->push_back(SimpleBookmarkSyncRecord(
+        jslib::SyncRecord::Action::A_CREATE,
+        "",
+        "https://" + std::to_string(i) + ".com/",
+        std::to_string(i) + ".com - title",
+        "1.1.1.1." + std::to_string(i + 1),
+        folder_object_id));
+  }
+
+  std::vector<int> applied;
+  change_processor()->ApplyChangesFromSyncModelInSlices(
+      std::move(folder_records),
+      base::BindOnce([](std::vector<int>* applied) { applied->push_back(1); },
+                     &applied));
+  change_processor()->ApplyChangesFromSyncModelInSlices(
+      std::move(bookmark_records),
+      base::BindOnce([](std::vector<int>* applied) { applied->push_back(2); },
+                     &applied));
+  // nothing is applied before the records are prepared
+  EXPECT_TRUE(applied.empty());
+  EXPECT_EQ(model()->other_node()->child_count(), 0);
+
+  thread_bundle()->RunUntilIdle();
+
+  EXPECT_THAT(applied, testing::ElementsAre(1, 2));
+  ASSERT_EQ(model()->other_node()->child_count(), 1);
+  const auto* folder = model()->other_node()->GetChild(0);
+  EXPECT_EQ(base::UTF16ToUTF8(folder->GetTitle()), "Folder1");
+  ASSERT_EQ(folder->child_count(), 3);
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_EQ(folder->GetChild(i)->url().spec(),
+              "https://" + std::to_string(i) + ".com/");
+  }
+}
+
+TEST_F(BraveBookmarkChangeProcessorTest, StopDropsPendingSlices) {
+  change_processor()->Start();
+
+  auto records = std::make_unique<RecordsList>();
+  records->push_back(SimpleBookmarkSyncRecord(
+      jslib::SyncRecord::Action::A_CREATE,
+      "",
+      "https://a.com/",
+      "A.com - title",
+      "1.1.1.1", ""));
+
+  bool applied = false;
+  change_processor()->ApplyChangesFromSyncModelInSlices(
+      std::move(records),
+      base::BindOnce([](bool* applied) { *applied = true; }, &applied));
+  change_processor()->Stop();
+  thread_bundle()->RunUntilIdle();
+
+  EXPECT_FALSE(applied);
+  std::vector<const BookmarkNode*> nodes;
+  model()->GetNodesByURL(GURL("https://a.com/"), &nodes);
+  EXPECT_EQ(nodes.size(), 0u);
+}
@@ -0,0 +1,224 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_sync/client/bookmark_sync_metadata_store.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "base/bind.h"
+#include "base/files/file_util.h"
+#include "base/json/json_reader.h"
+#include "base/json/json_writer.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/task_runner_util.h"
+#include "base/values.h"
+
+namespace brave_sync {
+
+namespace {
+
+const int kVersion = 1;
+const char kVersionKey[] = "version";
+const char kNodesKey[] = "nodes";
+
+// Each node is stored as
+// [id, object_id, sync_timestamp, last_send_time, last_updated_time]
+// with the times as JS times, 0 for a null time.
+enum NodeField {
+  FIELD_ID = 0,
+  FIELD_OBJECT_ID,
+  FIELD_SYNC_TIMESTAMP,
+  FIELD_LAST_SEND_TIME,
+  FIELD_LAST_UPDATED_TIME,
+  FIELD_COUNT
+};
+
+double TimeToValue(const base::Time& time) {
+  return time.is_null() ? 0 : time.ToJsTime();
+}
+
+base::Time ValueToTime(const base::Value& value) {
+  if (!value.is_double() && !value.is_int())
+    return base::Time();
+  const double js_time = value.GetDouble();
+  return js_time == 0 ? base::Time() : base::Time::FromJsTime(js_time);
+}
+
+std::unique_ptr<base::Value> ReadOnFileTaskRunner(const base::FilePath& path) {
+  std::string json;
+  if (!base::ReadFileToString(path, &json))
+    return nullptr;
+  return base::JSONReader::Read(json);
+}
+
+}  // namespace
+
+BookmarkSyncMetadata::BookmarkSyncMetadata() {}
+
+BookmarkSyncMetadata::BookmarkSyncMetadata(
+    const BookmarkSyncMetadata& metadata) = default;
+
+BookmarkSyncMetadata::~BookmarkSyncMetadata() {}
+
+BookmarkSyncMetadataStore::BookmarkSyncMetadataStore(
+    const base::FilePath& path,
+    scoped_refptr<base::SequencedTaskRunner> task_runner)
+    : loaded_(false),
+      writer_(path, task_runner),
+      task_runner_(task_runner),
+      weak_factory_(this) {
+}
+
+BookmarkSyncMetadataStore::~BookmarkSyncMetadataStore() {
+  SaveNow();
+}
+
+void BookmarkSyncMetadataStore::Load(base::OnceClosure callback) {
+  base::PostTaskAndReplyWithResult(task_runner_.get(), FROM_HERE,
+      base::BindOnce(&ReadOnFileTaskRunner, writer_.path()),
+      base::BindOnce(&BookmarkSyncMetadataStore::OnLoaded,
+                     weak_factory_.GetWeakPtr(),
+                     std::move(callback)));
+}
+
+void BookmarkSyncMetadataStore::OnLoaded(base::OnceClosure callback,
+                                         std::unique_ptr<base::Value> value) {
+  loaded_ = true;
+  const bool changed_before_load = !metadata_.empty();
+
+  const base::Value* version =
+      value && value->is_dict() ? value->FindKey(kVersionKey) : nullptr;
+  const base::Value* nodes =
+      value && value->is_dict() ? value->FindKey(kNodesKey) : nullptr;
+  if (version && version->is_int() && version->GetInt() == kVersion &&
+      nodes && nodes->is_list()) {
+    for (const auto& node : nodes->GetList()) {
+      if (!node.is_list() || node.GetList().size() != FIELD_COUNT)
+        continue;
+      const auto& fields = node.GetList();
+
+      int64_t id = 0;
+      if (!fields[FIELD_ID].is_string() ||
+          !base::StringToInt64(fields[FIELD_ID].GetString(), &id) ||
+          !fields[FIELD_OBJECT_ID].is_string())
+        continue;
+
+      BookmarkSyncMetadata metadata;
+      metadata.object_id = fields[FIELD_OBJECT_ID].GetString();
+      metadata.sync_timestamp = ValueToTime(fields[FIELD_SYNC_TIMESTAMP]);
+      metadata.last_send_time = ValueToTime(fields[FIELD_LAST_SEND_TIME]);
+      metadata.last_updated_time =
+          ValueToTime(fields[FIELD_LAST_UPDATED_TIME]);
+      auto it = metadata_.find(id);
+      if (it == metadata_.end()) {
+        metadata_.emplace(id, std::move(metadata));
+        continue;
+      }
+      // an entry written before the load finished is for the node's current
+      // object id; for the same one keep the later of each time, so that a
+      // local change doesn't lose the node's last sync
+      if (it->second.object_id != metadata.object_id)
+        continue;
+      it->second.sync_timestamp =
+          std::max(it->second.sync_timestamp, metadata.sync_timestamp);
+      it->second.last_send_time =
+          std::max(it->second.last_send_time, metadata.last_send_time);
+      it->second.last_updated_time =
+          std::max(it->second.last_updated_time, metadata.last_updated_time);
+    }
+  }
+
+  if (changed_before_load)
+    ScheduleSave();
+
+  std::move(callback).Run();
+}
+
+const BookmarkSyncMetadata* BookmarkSyncMetadataStore::Get(
+    int64_t id,
+    const std::string& object_id) const {
+  auto it = metadata_.find(id);
+  if (it == metadata_.end() || it->second.object_id != object_id)
+    return nullptr;
+  return &it->second;
+}
+
+BookmarkSyncMetadata* BookmarkSyncMetadataStore::GetMutable(
+    int64_t id,
+    const std::string& object_id) {
+  BookmarkSyncMetadata& metadata = metadata_[id];
+  if (metadata.object_id != object_id) {
+    metadata = BookmarkSyncMetadata();
+    metadata.object_id = object_id;
+  }
+  ScheduleSave();
+  return &metadata;
+}
+
+void BookmarkSyncMetadataStore::SetObjectId(int64_t id,
+                                            const std::string& object_id) {
+  auto it = metadata_.find(id);
+  if (it == metadata_.end() || it->second.object_id == object_id)
+    return;
+  it->second.object_id = object_id;
+  ScheduleSave();
+}
+
+void BookmarkSyncMetadataStore::Remove(int64_t id) {
+  if (metadata_.erase(id))
+    ScheduleSave();
+}
+
+void BookmarkSyncMetadataStore::RetainOnly(const std::set<int64_t>& ids) {
+  bool removed = false;
+  for (auto it = metadata_.begin(); it != metadata_.end();) {
+    if (ids.count(it->first)) {
+      ++it;
+      continue;
+    }
+    it = metadata_.erase(it);
+    removed = true;
+  }
+  if (removed)
+    ScheduleSave();
+}
+
+void BookmarkSyncMetadataStore::Clear() {
+  metadata_.clear();
+  ScheduleSave();
+}
+
+void BookmarkSyncMetadataStore::ScheduleSave() {
+  // writing before the load finished would drop the entries on disk
+  if (loaded_)
+    writer_.ScheduleWrite(this);
+}
+
+void BookmarkSyncMetadataStore::SaveNow() {
+  if (writer_.HasPendingWrite())
+    writer_.DoScheduledWrite();
+}
+
+bool BookmarkSyncMetadataStore::SerializeData(std::string* output) {
+  base::Value nodes(base::Value::Type::LIST);
+  nodes.GetList().reserve(metadata_.size());
+  for (const auto& entry : metadata_) {
+    base::Value node(base::Value::Type::LIST);
+    node.GetList().reserve(FIELD_COUNT);
+    node.GetList().emplace_back(base::Int64ToString(entry.first));
+    node.GetList().emplace_back(entry.second.object_id);
+    node.GetList().emplace_back(TimeToValue(entry.second.sync_timestamp));
+    node.GetList().emplace_back(TimeToValue(entry.second.last_send_time));
+    node.GetList().emplace_back(TimeToValue(entry.second.last_updated_time));
+    nodes.GetList().push_back(std::move(node));
+  }
+
+  base::Value root(base::Value::Type::DICTIONARY);
+  root.SetKey(kVersionKey, base::Value(kVersion));
+  root.SetKey(kNodesKey, std::move(nodes));
+  return base::JSONWriter::Write(root, output);
+}
+
+}  // namespace brave_sync
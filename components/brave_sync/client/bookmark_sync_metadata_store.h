@@ -0,0 +1,104 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_COMPONENTS_BRAVE_SYNC_CLIENT_BOOKMARK_SYNC_METADATA_STORE_H_
+#define BRAVE_COMPONENTS_BRAVE_SYNC_CLIENT_BOOKMARK_SYNC_METADATA_STORE_H_
+
+#include <stdint.h>
+
+#include <memory>
+#include <set>
+#include <string>
+#include <unordered_map>
+
+#include "base/callback.h"
+#include "base/files/file_path.h"
+#include "base/files/important_file_writer.h"
+#include "base/macros.h"
+#include "base/memory/weak_ptr.h"
+#include "base/sequenced_task_runner.h"
+#include "base/time/time.h"
+
+namespace base {
+class Value;
+}
+
+namespace brave_sync {
+
+// Sync bookkeeping for one bookmark node.
+struct BookmarkSyncMetadata {
+  BookmarkSyncMetadata();
+  BookmarkSyncMetadata(const BookmarkSyncMetadata& metadata);
+  ~BookmarkSyncMetadata();
+
+  // The "object_id" meta info of the node when the entry was written. An
+  // entry is only used for a node with the same object id, which keeps a
+  // stale entry from applying if node ids are ever reassigned.
+  std::string object_id;
+  // Time of the last sync record applied to the node. Null if the node was
+  // never synced or changed locally since.
+  base::Time sync_timestamp;
+  // Time the node was last sent to sync, null if not sent since its last
+  // local change.
+  base::Time last_send_time;
+  // Time of the last local change.
+  base::Time last_updated_time;
+};
+
+// Keeps the sync timestamps of bookmark nodes by node id, outside of the
+// bookmark model so that sync bookkeeping doesn't rewrite the Bookmarks
+// file. The store is loaded once in the background and written back in
+// batches by an ImportantFileWriter.
+//
+// The store can be used before it is loaded: entries written in the
+// meantime are merged with the ones read from disk, keeping the later of
+// each time.
+class BookmarkSyncMetadataStore
+    : public base::ImportantFileWriter::DataSerializer {
+ public:
+  BookmarkSyncMetadataStore(
+      const base::FilePath& path,
+      scoped_refptr<base::SequencedTaskRunner> task_runner);
+  ~BookmarkSyncMetadataStore() override;
+
+  void Load(base::OnceClosure callback);
+  bool loaded() const { return loaded_; }
+
+  // Returns the entry for |id| if it was written for |object_id|.
+  const BookmarkSyncMetadata* Get(int64_t id,
+                                  const std::string& object_id) const;
+  // Returns the entry for |id|, replacing it by an empty one if it belongs
+  // to another object id. The caller must not keep the pointer.
+  BookmarkSyncMetadata* GetMutable(int64_t id, const std::string& object_id);
+  // Moves the entry for |id| to the node's new object id.
+  void SetObjectId(int64_t id, const std::string& object_id);
+  void Remove(int64_t id);
+  // Removes every entry whose id is not in |ids|.
+  void RetainOnly(const std::set<int64_t>& ids);
+  void Clear();
+
+  // Schedules a write of the store. Writes are batched.
+  void ScheduleSave();
+  // Writes pending changes now, e.g. before shutdown.
+  void SaveNow();
+
+  // base::ImportantFileWriter::DataSerializer:
+  bool SerializeData(std::string* output) override;
+
+ private:
+  void OnLoaded(base::OnceClosure callback,
+                std::unique_ptr<base::Value> value);
+
+  std::unordered_map<int64_t, BookmarkSyncMetadata> metadata_;
+  bool loaded_;
+  base::ImportantFileWriter writer_;
+  scoped_refptr<base::SequencedTaskRunner> task_runner_;
+  base::WeakPtrFactory<BookmarkSyncMetadataStore> weak_factory_;
+
+  DISALLOW_COPY_AND_ASSIGN(BookmarkSyncMetadataStore);
+};
+
+}  // namespace brave_sync
+
+#endif  // BRAVE_COMPONENTS_BRAVE_SYNC_CLIENT_BOOKMARK_SYNC_METADATA_STORE_H_
@@ -0,0 +1,134 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_sync/client/bookmark_sync_metadata_store.h"
+
+#include <memory>
+
+#include "base/files/scoped_temp_dir.h"
+#include "base/run_loop.h"
+#include "base/test/scoped_task_environment.h"
+#include "base/threading/sequenced_task_runner_handle.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+// npm run test -- brave_unit_tests --filter=BookmarkSyncMetadataStoreTest.*
+
+namespace brave_sync {
+
+class BookmarkSyncMetadataStoreTest : public testing::Test {
+ public:
+  BookmarkSyncMetadataStoreTest() {}
+  ~BookmarkSyncMetadataStoreTest() override {}
+
+ protected:
+  void SetUp() override {
+    ASSERT_TRUE(temp_dir_.CreateUniqueTempDir());
+  }
+
+  std::unique_ptr<BookmarkSyncMetadataStore> CreateStore() {
+    return std::make_unique<BookmarkSyncMetadataStore>(
+        temp_dir_.GetPath().AppendASCII("brave_sync_bookmarks_metadata"),
+        base::SequencedTaskRunnerHandle::Get());
+  }
+
+  void Load(BookmarkSyncMetadataStore* store) {
+    base::RunLoop run_loop;
+    store->Load(run_loop.QuitClosure());
+    run_loop.Run();
+    EXPECT_TRUE(store->loaded());
+  }
+
+  base::test::ScopedTaskEnvironment scoped_task_environment_;
+  base::ScopedTempDir temp_dir_;
+};
+
+TEST_F(BookmarkSyncMetadataStoreTest, SavesAndLoads) {
+  const base::Time now = base::Time::FromJsTime(1540000000000);
+  {
+    auto store = CreateStore();
+    Load(store.get());
+    BookmarkSyncMetadata* metadata = store->GetMutable(5, "object-a");
+    metadata->sync_timestamp = now;
+    metadata->last_updated_time = now;
+    store->GetMutable(6, "")->last_updated_time = now;
+    store->SaveNow();
+    scoped_task_environment_.RunUntilIdle();
+  }
+
+  auto store = CreateStore();
+  Load(store.get());
+  const BookmarkSyncMetadata* metadata = store->Get(5, "object-a");
+  ASSERT_NE(metadata, nullptr);
+  EXPECT_EQ(metadata->sync_timestamp, now);
+  EXPECT_TRUE(metadata->last_send_time.is_null());
+  EXPECT_EQ(metadata->last_updated_time, now);
+  EXPECT_NE(store->Get(6, ""), nullptr);
+}
+
+TEST_F(BookmarkSyncMetadataStoreTest, EntriesBelongToAnObjectId) {
+  auto store = CreateStore();
+  Load(store.get());
+  store->GetMutable(5, "")->last_updated_time = base::Time::Now();
+
+  // the node got its object id when it was first sent
+  store->SetObjectId(5, "object-a");
+  EXPECT_EQ(store->Get(5, ""), nullptr);
+  ASSERT_NE(store->Get(5, "object-a"), nullptr);
+
+  // the id now belongs to another object
+  EXPECT_EQ(store->Get(5, "object-b"), nullptr);
+  EXPECT_TRUE(store->GetMutable(5, "object-b")->last_updated_time.is_null());
+  EXPECT_EQ(store->Get(5, "object-a"), nullptr);
+}
+
+TEST_F(BookmarkSyncMetadataStoreTest, WritesBeforeLoadAreMerged) {
+  const base::Time before = base::Time::FromJsTime(1540000000000);
+  const base::Time after = base::Time::FromJsTime(1540000001000);
+  {
+    auto store = CreateStore();
+    Load(store.get());
+    BookmarkSyncMetadata* metadata = store->GetMutable(5, "object-a");
+    metadata->sync_timestamp = before;
+    metadata->last_send_time = before;
+    store->GetMutable(6, "object-b")->sync_timestamp = before;
+    store->GetMutable(7, "object-c")->sync_timestamp = before;
+    store->SaveNow();
+    scoped_task_environment_.RunUntilIdle();
+  }
+
+  auto store = CreateStore();
+  // a local change clears the sync timestamp
+  BookmarkSyncMetadata* metadata = store->GetMutable(5, "object-a");
+  metadata->sync_timestamp = base::Time();
+  metadata->last_updated_time = after;
+  store->GetMutable(6, "object-b")->sync_timestamp = after;
+  // the id was reassigned to another object
+  store->GetMutable(7, "object-d")->last_updated_time = after;
+  Load(store.get());
+
+  const BookmarkSyncMetadata* merged = store->Get(5, "object-a");
+  ASSERT_NE(merged, nullptr);
+  EXPECT_EQ(merged->sync_timestamp, before);
+  EXPECT_EQ(merged->last_send_time, before);
+  EXPECT_EQ(merged->last_updated_time, after);
+  EXPECT_EQ(store->Get(6, "object-b")->sync_timestamp, after);
+  EXPECT_EQ(store->Get(7, "object-c"), nullptr);
+  ASSERT_NE(store->Get(7, "object-d"), nullptr);
+  EXPECT_TRUE(store->Get(7, "object-d")->sync_timestamp.is_null());
+}
+
+TEST_F(BookmarkSyncMetadataStoreTest, RetainOnly) {
+  auto store = CreateStore();
+  Load(store.get());
+  store->GetMutable(5, "object-a");
+  store->GetMutable(6, "object-b");
+  store->GetMutable(7, "object-c");
+
+  store->RetainOnly({5, 7});
+  EXPECT_NE(store->Get(5, "object-a"), nullptr);
+  EXPECT_EQ(store->Get(6, "object-b"), nullptr);
+  EXPECT_NE(store->Get(7, "object-c"), nullptr);
+}
+
+}  // namespace brave_sync
@@ -51,6 +51,10 @@ class SyncMessageHandler {
   //SAVE_BOOKMARKS_BASE_ORDER
   virtual void OnSaveBookmarksBaseOrder(const std::string &order) = 0;
   virtual void OnSyncWordsPrepared(const std::string &words) = 0;
+  // |records_sent| of the |records_total| records queued for the extension
+  // were dispatched to it
+  virtual void OnSyncRecordsProgress(size_t records_sent,
+                                     size_t records_total) = 0;
 };
 
 class BraveSyncClient {
@@ -75,7 +79,7 @@ class BraveSyncClient {
       const std::string &category_name,
       std::unique_ptr<SyncRecordAndExistingList> list) = 0;
   virtual void SendSyncRecords(const std::string &category_name,
-    const RecordsList &records) = 0;
+    std::unique_ptr<RecordsList> records) = 0;
   virtual void SendDeleteSyncUser() = 0;
   virtual void SendDeleteSyncCategory(const std::string &category_name) = 0;
   virtual void SendGetBookmarksBaseOrder(const std::string &device_id,
@@ -84,6 +88,9 @@ class BraveSyncClient {
 
   virtual void OnExtensionInitialized() = 0;
 
+  // the extension handled the last chunk of records sent to it
+  virtual void OnRecordsChunkProcessed() = 0;
+
   virtual void OnSyncEnabledChanged() = 0;
 };
 
@@ -4,6 +4,9 @@
 
 #include "brave/components/brave_sync/client/brave_sync_client_impl.h"
 
+#include <utility>
+
+#include "base/bind.h"
 #include "base/logging.h"
 #include "brave/browser/extensions/api/brave_sync_event_router.h"
 #include "brave/components/brave_sync/client/client_ext_impl_data.h"
@@ -46,6 +49,9 @@ BraveSyncClientImpl::BraveSyncClientImpl(SyncMessageHandler* handler,
     extension_loaded_(false),
     brave_sync_event_router_(new extensions::BraveSyncEventRouter(profile)),
     extension_registry_observer_(this) {
+  brave_sync_event_router_->set_progress_callback(
+      base::BindRepeating(&SyncMessageHandler::OnSyncRecordsProgress,
+                          base::Unretained(handler_)));
   // Handle when the extension system is ready
   extensions::ExtensionSystem::Get(profile)->ready().Post(
       FROM_HERE, base::Bind(&BraveSyncClientImpl::OnExtensionSystemReady,
@@ -88,19 +94,22 @@ void BraveSyncClientImpl::SendResolveSyncRecords(
   DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
   std::vector<extensions::api::brave_sync::RecordAndExistingObject> records_and_existing_objects_ext;
 
-  ConvertResolvedPairs(*records_and_existing_objects, records_and_existing_objects_ext);
+  ConvertResolvedPairs(std::move(*records_and_existing_objects),
+                       records_and_existing_objects_ext);
 
   brave_sync_event_router_->ResolveSyncRecords(category_name,
-    records_and_existing_objects_ext);
+    std::move(records_and_existing_objects_ext));
 }
 
-void BraveSyncClientImpl::SendSyncRecords(const std::string &category_name,
-                                          const RecordsList &records) {
+void BraveSyncClientImpl::SendSyncRecords(
+    const std::string &category_name,
+    std::unique_ptr<RecordsList> records) {
   DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
   std::vector<extensions::api::brave_sync::SyncRecord> records_ext;
-  ConvertSyncRecordsFromLibToExt(records, records_ext);
+  ConvertSyncRecordsFromLibToExt(std::move(*records), records_ext);
 
-  brave_sync_event_router_->SendSyncRecords(category_name, records_ext);
+  brave_sync_event_router_->SendSyncRecords(category_name,
+                                            std::move(records_ext));
 }
 
 void BraveSyncClientImpl::SendDeleteSyncUser()  {
@@ -128,6 +137,11 @@ void BraveSyncClientImpl::OnExtensionInitialized() {
     brave_sync_event_router_->LoadClient();
 }
 
+void BraveSyncClientImpl::OnRecordsChunkProcessed() {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
+  brave_sync_event_router_->OnChunkProcessed();
+}
+
 void BraveSyncClientImpl::OnSyncEnabledChanged() {
   DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
   if (sync_prefs_->GetSyncEnabled()) {
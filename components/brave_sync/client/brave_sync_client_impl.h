@@ -50,7 +50,7 @@ class BraveSyncClientImpl : public BraveSyncClient,
       const std::string& category_name,
       std::unique_ptr<SyncRecordAndExistingList> records) override;
   void SendSyncRecords(const std::string& category_name,
-    const RecordsList &records) override;
+    std::unique_ptr<RecordsList> records) override;
   void SendDeleteSyncUser() override;
   void SendDeleteSyncCategory(const std::string& category_name) override;
   void SendGetBookmarksBaseOrder(const std::string& device_id,
@@ -65,6 +65,7 @@ class BraveSyncClientImpl : public BraveSyncClient,
   BraveSyncClientImpl(SyncMessageHandler* handler, Profile* profile);
 
   void OnExtensionInitialized() override;
+  void OnRecordsChunkProcessed() override;
   void OnSyncEnabledChanged() override;
 
   // ExtensionRegistryObserver:
@@ -31,13 +31,15 @@ namespace brave_sync {
 void ConvertConfig(const brave_sync::client_data::Config &config,
   extensions::api::brave_sync::Config &config_extension);
 
-void ConvertSyncRecords(const std::vector<extensions::api::brave_sync::SyncRecord> &records_extension,
+// The record conversions take ownership of their input and move its fields
+// into the output instead of copying them.
+void ConvertSyncRecords(std::vector<extensions::api::brave_sync::SyncRecord> records_extension,
   std::vector<brave_sync::SyncRecordPtr> &records);
 
-void ConvertResolvedPairs(const SyncRecordAndExistingList &records_and_existing_objects,
+void ConvertResolvedPairs(SyncRecordAndExistingList records_and_existing_objects,
   std::vector<extensions::api::brave_sync::RecordAndExistingObject> &records_and_existing_objects_ext);
 
-void ConvertSyncRecordsFromLibToExt(const std::vector<brave_sync::SyncRecordPtr> &records,
+void ConvertSyncRecordsFromLibToExt(RecordsList records,
   std::vector<extensions::api::brave_sync::SyncRecord> &records_extension);
 
 } // namespace brave_sync
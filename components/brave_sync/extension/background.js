@@ -45,6 +45,9 @@ chrome.braveSync.onResolveSyncRecords.addListener(function(category_name, record
     }
   }
   console.log(`"resolve-sync-records" category_name=${JSON.stringify(category_name)} recordsAndExistingObjects=${JSON.stringify(recordsAndExistingObjectsArrArr)}`);
+  // the browser sends the next chunk of records once jslib answered with
+  // "resolved-sync-records"
+  ++pendingResolveChunks;
   callbackList["resolve-sync-records"](null, category_name, recordsAndExistingObjectsArrArr);
 });
 
@@ -62,6 +65,9 @@ chrome.braveSync.onSendSyncRecords.addListener(function(category_name, records)
     chrome.braveSync.resolvedSyncRecords(category_name, records);
     orderMap = {};
   }
+  // jslib doesn't report when the upload is done, the records are
+  // converted and queued by now
+  chrome.braveSync.recordsChunkProcessed();
 });
 
 chrome.braveSync.onSendGetBookmarksBaseOrder.addListener(function(deviceId, platform) {
@@ -79,6 +85,8 @@ chrome.braveSync.onNeedSyncWords.addListener(function(seed) {
 
 chrome.braveSync.onLoadClient.addListener(function() {
   console.log("in chrome.braveSync.onLoadClient");
+  // the browser drops the chunks sent to a previous jslib
+  pendingResolveChunks = 0;
   LoadJsLibScript();
 });
 
@@ -262,6 +270,11 @@ class InjectedObject {
         fixupSyncRecordsArrayExtensionToBrowser(arg2);
         console.log(`"resolved-sync-records" categoryName=${JSON.stringify(arg1)} records=${JSON.stringify(arg2)}`);
         chrome.braveSync.resolvedSyncRecords(arg1/*categoryName*/, arg2/*records*/);
+        // jslib is done with a chunk sent by onResolveSyncRecords
+        if (pendingResolveChunks > 0) {
+          --pendingResolveChunks;
+          chrome.braveSync.recordsChunkProcessed();
+        }
         break;
       case "save-bookmarks-base-order":
         console.log(`"save-bookmarks-base-order" order=${JSON.stringify(arg1)} `);
@@ -304,6 +317,8 @@ var callbackList = {}; /* message name to callback function */
 
 var getBookmarkOrderCallback = null;
 var orderMap = {}
+// Chunks passed to jslib to resolve that it didn't answer yet.
+var pendingResolveChunks = 0;
 
 if (!self.chrome) {
   self.chrome = {};
@@ -20,8 +20,14 @@ Site::Site(const Site& site) {
   favicon = site.favicon;
 }
 
+Site::Site(Site&& site) = default;
+
 Site::~Site() = default;
 
+Site& Site::operator=(const Site& site) = default;
+
+Site& Site::operator=(Site&& site) = default;
+
 std::unique_ptr<Site> Site::Clone(const Site& site) {
   return std::make_unique<Site>(site);
 }
@@ -141,6 +147,26 @@ const Device& SyncRecord::GetDevice() const {
   return *device_.get();
 }
 
+Bookmark* SyncRecord::GetMutableBookmark() {
+  DCHECK(has_bookmark());
+  return bookmark_.get();
+}
+
+Site* SyncRecord::GetMutableHistorySite() {
+  DCHECK(has_historysite());
+  return history_site_.get();
+}
+
+SiteSetting* SyncRecord::GetMutableSiteSetting() {
+  DCHECK(has_sitesetting());
+  return site_setting_.get();
+}
+
+Device* SyncRecord::GetMutableDevice() {
+  DCHECK(has_device());
+  return device_.get();
+}
+
 void SyncRecord::SetBookmark(std::unique_ptr<Bookmark> bookmark) {
   DCHECK(!has_bookmark() && !has_historysite() && !has_sitesetting() && !has_device());
   bookmark_ = std::move(bookmark);
@@ -26,7 +26,10 @@ class Site {
 public:
   Site();
   Site(const Site& site);
+  Site(Site&& site);
   ~Site();
+  Site& operator=(const Site& site);
+  Site& operator=(Site&& site);
   static std::unique_ptr<Site> Clone(const Site& site);
 
   std::string location;
@@ -131,6 +134,11 @@ public:
   const Site& GetHistorySite() const;
   const SiteSetting& GetSiteSetting() const;
   const Device& GetDevice() const;
+  // Let the record's payload be moved out when the record is consumed.
+  Bookmark* GetMutableBookmark();
+  Site* GetMutableHistorySite();
+  SiteSetting* GetMutableSiteSetting();
+  Device* GetMutableDevice();
 
   void SetBookmark(std::unique_ptr<Bookmark> bookmark);
   void SetHistorySite(std::unique_ptr<Site> history_site);
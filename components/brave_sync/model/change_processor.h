@@ -27,9 +27,9 @@ class ChangeProcessor {
   virtual void InitialSync() = 0;
 
   // get all local sync data matching `records` and return the matched pair
-  // in `records_and_existing_objects`
+  // in `records_and_existing_objects`, `records` are moved into the pairs
   virtual void GetAllSyncData(
-      const std::vector<std::unique_ptr<jslib::SyncRecord>>& records,
+      RecordsList records,
       SyncRecordAndExistingList* records_and_existing_objects) = 0;
   // update local data from `records`
   virtual void ApplyChangesFromSyncModel(const RecordsList& records) = 0;
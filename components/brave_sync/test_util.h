@@ -42,7 +42,7 @@ class MockBraveSyncClient : public BraveSyncClient {
   MOCK_METHOD2(SendResolveSyncRecords, void(const std::string& category_name,
     std::unique_ptr<SyncRecordAndExistingList> list));
   MOCK_METHOD2(SendSyncRecords, void (const std::string& category_name,
-    const RecordsList& records));
+    std::unique_ptr<RecordsList> records));
   MOCK_METHOD0(SendDeleteSyncUser, void());
   MOCK_METHOD1(SendDeleteSyncCategory, void(const std::string& category_name));
   MOCK_METHOD2(SendGetBookmarksBaseOrder, void(const std::string& device_id,
@@ -50,6 +50,7 @@ class MockBraveSyncClient : public BraveSyncClient {
   MOCK_METHOD1(NeedSyncWords, void(const std::string& seed));
   MOCK_METHOD1(NeedBytesFromSyncWords, void(const std::string& words));
   MOCK_METHOD0(OnExtensionInitialized, void());
+  MOCK_METHOD0(OnRecordsChunkProcessed, void());
   MOCK_METHOD0(OnSyncEnabledChanged, void());
 };
 
@@ -36,7 +36,6 @@ declare global {
       grantFinish: chrome.events.Event<(properties: Rewards.GrantFinish) => void>
       reconcileStamp: chrome.events.Event<(stamp: number) => void>
       addresses: chrome.events.Event<(addresses: Record<string, string>) => void>
-      contributeList: chrome.events.Event<(list: Rewards.Publisher[]) => void>
       balanceReports: chrome.events.Event<(reports: Record<string, Rewards.Report>) => void>
     }
     brave_welcome: {
@@ -27,6 +27,7 @@ declare namespace Rewards {
     addresses?: Record<AddressesType, Address>
     autoContributeList: Publisher[]
     connectedWallet: boolean
+    contributeListVersion: number
     contributeLoad: boolean
     contributionMinTime: number
     contributionMinVisits: number
@@ -117,6 +118,13 @@ declare namespace Rewards {
     tipDate?: number
   }
 
+  export interface ContributeListDiff {
+    version: number
+    reset: boolean
+    upserted: Publisher[]
+    removed: string[]
+  }
+
   export interface Report {
     ads: string
     closing: string
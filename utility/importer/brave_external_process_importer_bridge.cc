@@ -7,36 +7,48 @@
 #include "brave/utility/importer/brave_external_process_importer_bridge.h"
 
 #include "base/logging.h"
+#include "brave/common/payload_size.h"
 #include "build/build_config.h"
+#include "chrome/common/importer/importer_url_row.h"
 
 using chrome::mojom::ProfileImportObserver;
 
 namespace {
 
-const int kNumCookiesToSend = 100;
+// Groups are cut at whichever limit is reached first, so that many small
+// items share a message while large ones, such as favicons, don't make a
+// message grow without bound.
+const size_t kMaxGroupBytes = 512 * 1024;
+const size_t kMaxGroupItems = 1000;
 
 }  // namespace
 
+void BraveExternalProcessImporterBridge::SetHistoryItems(
+    const std::vector<ImporterURLRow>& rows,
+    importer::VisitSource visit_source) {
+  (*observer_)->OnHistoryImportStart(rows.size());
+  brave::SendInGroups(rows, kMaxGroupItems, kMaxGroupBytes,
+                      [&](const std::vector<ImporterURLRow>& group) {
+    (*observer_)->OnHistoryImportGroup(group, visit_source);
+  });
+}
+
+void BraveExternalProcessImporterBridge::SetFavicons(
+    const favicon_base::FaviconUsageDataList& favicons) {
+  (*observer_)->OnFaviconsImportStart(favicons.size());
+  brave::SendInGroups(favicons, kMaxGroupItems, kMaxGroupBytes,
+                      [&](const favicon_base::FaviconUsageDataList& group) {
+    (*observer_)->OnFaviconsImportGroup(group);
+  });
+}
+
 void BraveExternalProcessImporterBridge::SetCookies(
     const std::vector<net::CanonicalCookie>& cookies) {
   (*observer_)->OnCookiesImportStart(cookies.size());
-
-  // |cookies_left| is required for the checks below as Windows has a
-  // Debug bounds-check which prevents pushing an iterator beyond its end()
-  // (i.e., |it + 2 < s.end()| crashes in debug mode if |i + 1 == s.end()|).
-  int cookies_left = cookies.end() - cookies.begin();
-  for (std::vector<net::CanonicalCookie>::const_iterator it =
-           cookies.begin(); it < cookies.end();) {
-    std::vector<net::CanonicalCookie> cookies_group;
-    std::vector<net::CanonicalCookie>::const_iterator end_group =
-        it + std::min(cookies_left, kNumCookiesToSend);
-    cookies_group.assign(it, end_group);
-
-    (*observer_)->OnCookiesImportGroup(cookies_group);
-    cookies_left -= end_group - it;
-    it = end_group;
-  }
-  DCHECK_EQ(0, cookies_left);
+  brave::SendInGroups(cookies, kMaxGroupItems, kMaxGroupBytes,
+                      [&](const std::vector<net::CanonicalCookie>& group) {
+    (*observer_)->OnCookiesImportGroup(group);
+  });
 }
 
 void BraveExternalProcessImporterBridge::UpdateStats(
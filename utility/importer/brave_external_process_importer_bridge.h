@@ -19,6 +19,12 @@ class BraveExternalProcessImporterBridge :
       scoped_refptr<chrome::mojom::ThreadSafeProfileImportObserverPtr>
           observer);
 
+  // Payloads are sent in groups bounded by both item count and estimated
+  // size.
+  void SetHistoryItems(const std::vector<ImporterURLRow>& rows,
+                       importer::VisitSource visit_source) override;
+  void SetFavicons(
+      const favicon_base::FaviconUsageDataList& favicons) override;
   void SetCookies(const std::vector<net::CanonicalCookie>& cookies) override;
   void UpdateStats(const BraveStats& stats) override;
 
@@ -5,6 +5,8 @@
 #include "brave/utility/importer/brave_importer.h"
 
 #include <memory>
+#include <string>
+#include <utility>
 #include <vector>
 
 #include "base/files/file_util.h"
@@ -46,7 +48,22 @@
 
 using base::Time;
 
-BraveImporter::BraveImporter() {
+namespace {
+
+// Top-level sections of session-store-1 the importer reads. The rest of the
+// file, e.g. window and tab state, is dropped as soon as it is parsed.
+const char* const kSessionStoreSections[] = {
+  "historySites",
+  "bookmarkFolders",
+  "bookmarks",
+  "adblock",
+  "trackingProtection",
+  "httpsEverywhere",
+};
+
+}  // namespace
+
+BraveImporter::BraveImporter() : session_store_parsed_(false) {
 }
 
 BraveImporter::~BraveImporter() {
@@ -58,44 +75,33 @@ void BraveImporter::StartImport(const importer::SourceProfile& source_profile,
   bridge_ = bridge;
   source_path_ = source_profile.source_path;
 
-  // The order here is important!
   bridge_->NotifyStarted();
 
-  if ((items & importer::HISTORY) && !cancelled()) {
-    bridge_->NotifyItemStarted(importer::HISTORY);
-    ImportHistory();
-    bridge_->NotifyItemEnded(importer::HISTORY);
-  }
-
-  if ((items & importer::FAVORITES) && !cancelled()) {
-    bridge_->NotifyItemStarted(importer::FAVORITES);
-    ImportBookmarks();
-    bridge_->NotifyItemEnded(importer::FAVORITES);
-  }
-
-  if ((items & importer::PASSWORDS) && !cancelled()) {
-    bridge_->NotifyItemStarted(importer::PASSWORDS);
-    ImportPasswords(base::FilePath(FILE_PATH_LITERAL("UserPrefs")));
-    bridge_->NotifyItemEnded(importer::PASSWORDS);
-  }
+  // History, bookmarks and stats share the session store.
+  RunImportLanes(items, {
+    {importer::PASSWORDS, importer::COOKIES},
+    {importer::HISTORY, importer::FAVORITES, importer::STATS},
+  });
 
-  if ((items & importer::COOKIES) && !cancelled()) {
-    bridge_->NotifyItemStarted(importer::COOKIES);
-    ImportCookies();
-    bridge_->NotifyItemEnded(importer::COOKIES);
-  }
+  session_store_.reset();
+  bridge_->NotifyEnded();
+}
 
-  if ((items & importer::STATS) && !cancelled()) {
-    bridge_->NotifyItemStarted(importer::STATS);
-    ImportStats();
-    bridge_->NotifyItemEnded(importer::STATS);
+void BraveImporter::ImportItem(importer::ImportItem item) {
+  switch (item) {
+    case importer::PASSWORDS:
+      ImportPasswords(base::FilePath(FILE_PATH_LITERAL("UserPrefs")));
+      break;
+    case importer::STATS:
+      ImportStats();
+      break;
+    default:
+      ChromeImporter::ImportItem(item);
   }
-
-  bridge_->NotifyEnded();
 }
 
 void BraveImporter::ImportHistory() {
-  std::unique_ptr<base::Value> session_store_json = ParseBraveSessionStore();
+  base::Value* session_store_json = GetBraveSessionStore();
   if (!session_store_json)
     return;
 
@@ -138,6 +144,7 @@ void BraveImporter::ImportHistory() {
 
     rows.push_back(row);
   }
+  session_store_json->RemoveKey("historySites");
 
   if (!rows.empty() && !cancelled())
     bridge_->SetHistoryItems(rows, importer::VISIT_SOURCE_BRAVE_IMPORTED);
@@ -145,7 +152,7 @@ void BraveImporter::ImportHistory() {
 
 void BraveImporter::ParseBookmarks(
     std::vector<ImportedBookmarkEntry>* bookmarks) {
-  std::unique_ptr<base::Value> session_store_json = ParseBraveSessionStore();
+  base::Value* session_store_json = GetBraveSessionStore();
   if (!session_store_json)
     return;
 
@@ -181,6 +188,10 @@ void BraveImporter::ParseBookmarks(
                                bookmarks_dict,
                                bookmark_order_dict,
                                bookmarks);
+
+  session_store_json->RemoveKey("bookmarkFolders");
+  session_store_json->RemoveKey("bookmarks");
+  session_store_json->RemoveKey("cache");
 }
 
 void BraveImporter::RecursiveReadBookmarksFolder(
@@ -269,6 +280,14 @@ void BraveImporter::ImportBookmarks() {
   }
 }
 
+base::Value* BraveImporter::GetBraveSessionStore() {
+  if (!session_store_parsed_) {
+    session_store_parsed_ = true;
+    session_store_ = ParseBraveSessionStore();
+  }
+  return session_store_.get();
+}
+
 std::unique_ptr<base::Value> BraveImporter::ParseBraveSessionStore() {
   base::FilePath session_store_path =
     source_path_.Append(
@@ -281,14 +300,29 @@ std::unique_ptr<base::Value> BraveImporter::ParseBraveSessionStore() {
 
   std::unique_ptr<base::Value> session_store_json =
     base::JSONReader::Read(session_store_content);
-  if (!session_store_json) {
+  if (!session_store_json || !session_store_json->is_dict()) {
     LOG(ERROR) << "Parsing Brave session-store-1 JSON failed";
+    return nullptr;
   }
-  return session_store_json;
+  // the file contents aren't needed once parsed
+  std::string().swap(session_store_content);
+
+  auto sections = std::make_unique<base::Value>(base::Value::Type::DICTIONARY);
+  for (const char* key : kSessionStoreSections) {
+    base::Value* section = session_store_json->FindKey(key);
+    if (section)
+      sections->SetKey(key, std::move(*section));
+  }
+  // only the bookmark order is read from the cache
+  base::Value* bookmark_order =
+    session_store_json->FindPath({"cache", "bookmarkOrder"});
+  if (bookmark_order)
+    sections->SetPath({"cache", "bookmarkOrder"}, std::move(*bookmark_order));
+  return sections;
 }
 
 void BraveImporter::ImportStats() {
-  std::unique_ptr<base::Value> session_store_json = ParseBraveSessionStore();
+  base::Value* session_store_json = GetBraveSessionStore();
   if (!session_store_json)
     return;
 
@@ -30,10 +30,14 @@ class BraveImporter : public ChromeImporter {
  private:
   ~BraveImporter() override;
 
+  void ImportItem(importer::ImportItem item) override;
   void ImportBookmarks() override;
   void ImportHistory() override;
   void ImportStats();
 
+  // Returns the parts of session-store-1 the importer reads, parsing the
+  // file on first use. nullptr if it can't be read.
+  base::Value* GetBraveSessionStore();
   std::unique_ptr<base::Value> ParseBraveSessionStore();
 
   void ParseBookmarks(std::vector<ImportedBookmarkEntry>* bookmarks);
@@ -47,6 +51,10 @@ class BraveImporter : public ChromeImporter {
     base::Value* bookmark_order_dict,
     std::vector<ImportedBookmarkEntry>* bookmarks);
 
+  // Sections are removed once imported.
+  std::unique_ptr<base::Value> session_store_;
+  bool session_store_parsed_;
+
   DISALLOW_COPY_AND_ASSIGN(BraveImporter);
 };
 
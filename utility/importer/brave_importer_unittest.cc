@@ -164,6 +164,37 @@ TEST_F(BraveImporterTest, ImportBookmarks) {
   EXPECT_FALSE(bookmarks[5].is_folder);
 }
 
+// History, bookmarks and stats all come from session-store-1.
+TEST_F(BraveImporterTest, ImportSessionStoreItems) {
+  std::vector<ImporterURLRow> history;
+  std::vector<ImportedBookmarkEntry> bookmarks;
+  BraveStats stats;
+
+  EXPECT_CALL(*bridge_, NotifyStarted());
+  EXPECT_CALL(*bridge_, NotifyItemStarted(importer::HISTORY));
+  EXPECT_CALL(*bridge_, SetHistoryItems(_, _))
+      .WillOnce(::testing::SaveArg<0>(&history));
+  EXPECT_CALL(*bridge_, NotifyItemEnded(importer::HISTORY));
+  EXPECT_CALL(*bridge_, NotifyItemStarted(importer::FAVORITES));
+  EXPECT_CALL(*bridge_, AddBookmarks(_, _))
+      .WillOnce(::testing::SaveArg<0>(&bookmarks));
+  EXPECT_CALL(*bridge_, NotifyItemEnded(importer::FAVORITES));
+  EXPECT_CALL(*bridge_, NotifyItemStarted(importer::STATS));
+  EXPECT_CALL(*bridge_, UpdateStats(_))
+      .WillOnce(::testing::SaveArg<0>(&stats));
+  EXPECT_CALL(*bridge_, NotifyItemEnded(importer::STATS));
+  EXPECT_CALL(*bridge_, NotifyEnded());
+
+  importer_->StartImport(profile_,
+                         importer::HISTORY | importer::FAVORITES |
+                             importer::STATS,
+                         bridge_.get());
+
+  EXPECT_EQ(10u, history.size());
+  EXPECT_EQ(6u, bookmarks.size());
+  EXPECT_EQ(9, stats.adblock_count);
+}
+
 // The mock keychain only works on macOS, so only run this test on macOS (for now)
 #if defined(OS_MACOSX)
 TEST_F(BraveImporterTest, ImportPasswords) {
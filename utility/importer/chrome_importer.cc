@@ -4,15 +4,25 @@
 
 #include "brave/utility/importer/chrome_importer.h"
 
+#include <algorithm>
 #include <memory>
 #include <string>
+#include <utility>
 
+#include "base/atomic_ref_count.h"
+#include "base/bind.h"
+#include "base/containers/circular_deque.h"
 #include "base/files/file_util.h"
 #include "base/json/json_reader.h"
 #include "base/macros.h"
 #include "base/memory/ref_counted.h"
+#include "base/strings/string_split.h"
 #include "base/strings/string_util.h"
 #include "base/strings/utf_string_conversions.h"
+#include "base/synchronization/lock.h"
+#include "base/synchronization/waitable_event.h"
+#include "base/sys_info.h"
+#include "base/threading/simple_thread.h"
 #include "base/values.h"
 #include "brave/utility/importer/brave_external_process_importer_bridge.h"
 #include "build/build_config.h"
@@ -56,7 +66,180 @@ base::nix::DesktopEnvironment ChromeImporter::GetDesktopEnvironment() {
 
 using base::Time;
 
-ChromeImporter::ChromeImporter() {
+namespace {
+
+// History rows are read and sent to the browser this many at a time, so
+// the rows held in memory don't grow with the size of the history.
+const size_t kHistoryChunkSize = 1000;
+
+// Cookie rows are read, decrypted and sent to the browser this many at a
+// time.
+const size_t kCookieChunkSize = 1000;
+
+// Upper bound on the threads doing CPU-bound import work.
+const int kMaxImportThreads = 4;
+// Below this many encrypted cookie values extra threads aren't worth
+// starting.
+const size_t kMinCookiesPerThread = 64;
+
+// Favicons are read, re-encoded and sent to the browser this many at a
+// time.
+const size_t kFaviconBatchSize = 100;
+const size_t kMinFaviconsPerThread = 8;
+
+size_t GetMaxImportThreads() {
+  return std::min(static_cast<size_t>(kMaxImportThreads),
+                  static_cast<size_t>(base::SysInfo::NumberOfProcessors()));
+}
+
+// Counts down the ranges of one parallel run and wakes its caller once the
+// last one is done.
+class RangeCompletion {
+ public:
+  explicit RangeCompletion(size_t ranges)
+      : remaining_(static_cast<int>(ranges)),
+        done_(base::WaitableEvent::ResetPolicy::MANUAL,
+              base::WaitableEvent::InitialState::NOT_SIGNALED) {}
+  ~RangeCompletion() {}
+
+  void RangeDone() {
+    if (!remaining_.Decrement())
+      done_.Signal();
+  }
+
+  void Wait() { done_.Wait(); }
+
+ private:
+  base::AtomicRefCount remaining_;
+  base::WaitableEvent done_;
+
+  DISALLOW_COPY_AND_ASSIGN(RangeCompletion);
+};
+
+// Runs |task| for a range of indices on a worker thread, then tells
+// |completion|, if any.
+class RangeTask : public base::DelegateSimpleThread::Delegate {
+ public:
+  RangeTask(const base::RepeatingCallback<void(size_t)>& task,
+            size_t begin,
+            size_t end,
+            RangeCompletion* completion)
+      : task_(task), begin_(begin), end_(end), completion_(completion) {}
+  ~RangeTask() override {}
+
+  // base::DelegateSimpleThread::Delegate:
+  void Run() override {
+    for (size_t i = begin_; i < end_; ++i)
+      task_.Run(i);
+    if (completion_)
+      completion_->RangeDone();
+  }
+
+ private:
+  base::RepeatingCallback<void(size_t)> task_;
+  size_t begin_;
+  size_t end_;
+  RangeCompletion* completion_;  // NOT OWNED
+
+  DISALLOW_COPY_AND_ASSIGN(RangeTask);
+};
+
+// A row of the Cookies table, read before its value is decrypted.
+struct CookieRow {
+  std::string name;
+  std::string value;
+  std::string encrypted_value;
+  std::string domain;
+  std::string path;
+  int64_t creation_utc;
+  int64_t expires_utc;
+  int64_t last_access_utc;
+  bool secure;
+  bool http_only;
+  int same_site;
+  int priority;
+  // False if |encrypted_value| couldn't be decrypted.
+  bool decrypted;
+};
+
+void DecryptCookieRow(net::CookieCryptoDelegate* delegate, CookieRow* row) {
+  row->decrypted = delegate->DecryptString(row->encrypted_value, &row->value);
+}
+
+// A favicon as stored in the Favicons database, before it is re-encoded.
+struct FaviconRow {
+  favicon_base::FaviconUsageData usage;
+  std::vector<unsigned char> image_data;
+  // False if |image_data| couldn't be decoded.
+  bool reencoded;
+};
+
+void ReencodeFaviconRow(FaviconRow* row) {
+  row->reencoded = importer::ReencodeFavicon(
+      row->image_data.data(), row->image_data.size(), &row->usage.png_data);
+  std::vector<unsigned char>().swap(row->image_data);
+}
+
+}  // namespace
+
+// Worker threads for the CPU-bound steps of one import. The lanes share
+// them and every batch reuses them, rather than each batch starting and
+// joining threads of its own. They start on first use and are joined when
+// the pool goes away.
+class ChromeImporter::WorkerPool {
+ public:
+  WorkerPool() {}
+  ~WorkerPool() {
+    if (pool_)
+      pool_->JoinAll();
+  }
+
+  // Runs |task| for every index below |count|, spread over up to
+  // kMaxImportThreads threads with at least |min_per_thread| indices each,
+  // and returns once all are done. Lanes may call this at the same time.
+  void RunInParallel(size_t count,
+                     size_t min_per_thread,
+                     const base::RepeatingCallback<void(size_t)>& task) {
+    const size_t threads = std::min(GetMaxImportThreads(),
+                                    count / min_per_thread);
+    if (threads <= 1) {
+      RangeTask(task, 0, count, nullptr).Run();
+      return;
+    }
+
+    const size_t per_task = (count + threads - 1) / threads;
+    RangeCompletion completion((count + per_task - 1) / per_task);
+    std::vector<std::unique_ptr<RangeTask>> tasks;
+    for (size_t begin = 0; begin < count; begin += per_task) {
+      tasks.push_back(std::make_unique<RangeTask>(
+          task, begin, std::min(begin + per_task, count), &completion));
+    }
+
+    base::DelegateSimpleThreadPool* pool = GetPool();
+    for (const auto& range_task : tasks)
+      pool->AddWork(range_task.get());
+    completion.Wait();
+  }
+
+ private:
+  base::DelegateSimpleThreadPool* GetPool() {
+    base::AutoLock lock(lock_);
+    if (!pool_) {
+      pool_ = std::make_unique<base::DelegateSimpleThreadPool>(
+          "ImportWorker", GetMaxImportThreads());
+      pool_->Start();
+    }
+    return pool_.get();
+  }
+
+  // Guards starting |pool_|.
+  base::Lock lock_;
+  std::unique_ptr<base::DelegateSimpleThreadPool> pool_;
+
+  DISALLOW_COPY_AND_ASSIGN(WorkerPool);
+};
+
+ChromeImporter::ChromeImporter() : history_chunk_size_(kHistoryChunkSize) {
 }
 
 ChromeImporter::~ChromeImporter() {
@@ -68,34 +251,165 @@ void ChromeImporter::StartImport(const importer::SourceProfile& source_profile,
   bridge_ = bridge;
   source_path_ = source_profile.source_path;
 
-  // The order here is important!
   bridge_->NotifyStarted();
 
-  if ((items & importer::HISTORY) && !cancelled()) {
-    bridge_->NotifyItemStarted(importer::HISTORY);
-    ImportHistory();
-    bridge_->NotifyItemEnded(importer::HISTORY);
+  // Favicons are only kept for pages already in history or bookmarked, so
+  // history goes first. Passwords and cookies both use the OS key store.
+  worker_pool_ = std::make_unique<WorkerPool>();
+  RunImportLanes(items, {
+    {importer::PASSWORDS, importer::COOKIES},
+    {importer::HISTORY, importer::FAVORITES},
+  });
+  worker_pool_.reset();
+
+  bridge_->NotifyEnded();
+}
+
+// Passes the item notifications of all lanes to the bridge one item at a
+// time, so the browser never sees an item start before the previous one
+// ended. An item started while another is open is announced once that one
+// ends, and ended right away if it is already done by then.
+class ChromeImporter::ItemNotifier {
+ public:
+  explicit ItemNotifier(ImporterBridge* bridge)
+      : bridge_(bridge), open_item_(importer::NONE) {}
+  ~ItemNotifier() {}
+
+  void ItemStarted(importer::ImportItem item) {
+    base::AutoLock lock(lock_);
+    if (open_item_ == importer::NONE)
+      Open(item);
+    else
+      queued_items_.push_back(std::make_pair(item, false));
+  }
+
+  void ItemEnded(importer::ImportItem item) {
+    base::AutoLock lock(lock_);
+    if (item != open_item_) {
+      for (auto& queued_item : queued_items_) {
+        if (queued_item.first == item)
+          queued_item.second = true;
+      }
+      return;
+    }
+
+    Close();
+    while (!queued_items_.empty()) {
+      const std::pair<importer::ImportItem, bool> next =
+          queued_items_.front();
+      queued_items_.pop_front();
+      Open(next.first);
+      if (!next.second)
+        return;
+      Close();
+    }
   }
 
-  if ((items & importer::FAVORITES) && !cancelled()) {
-    bridge_->NotifyItemStarted(importer::FAVORITES);
-    ImportBookmarks();
-    bridge_->NotifyItemEnded(importer::FAVORITES);
+ private:
+  void Open(importer::ImportItem item) {
+    open_item_ = item;
+    bridge_->NotifyItemStarted(item);
   }
 
-  if ((items & importer::PASSWORDS) && !cancelled()) {
-    bridge_->NotifyItemStarted(importer::PASSWORDS);
-    ImportPasswords(base::FilePath(FILE_PATH_LITERAL("Preferences")));
-    bridge_->NotifyItemEnded(importer::PASSWORDS);
+  void Close() {
+    bridge_->NotifyItemEnded(open_item_);
+    open_item_ = importer::NONE;
   }
 
-  if ((items & importer::COOKIES) && !cancelled()) {
-    bridge_->NotifyItemStarted(importer::COOKIES);
-    ImportCookies();
-    bridge_->NotifyItemEnded(importer::COOKIES);
+  ImporterBridge* bridge_;
+  // Guards the members below and orders the calls to |bridge_|.
+  base::Lock lock_;
+  importer::ImportItem open_item_;
+  // Items started while another was open, and whether they already ended.
+  base::circular_deque<std::pair<importer::ImportItem, bool>> queued_items_;
+
+  DISALLOW_COPY_AND_ASSIGN(ItemNotifier);
+};
+
+// Imports the items of one lane in order.
+class ChromeImporter::ImportLane : public base::DelegateSimpleThread::Delegate {
+ public:
+  ImportLane(ChromeImporter* chrome_importer,
+             ItemNotifier* notifier,
+             uint16_t items,
+             std::vector<importer::ImportItem> lane)
+      : importer_(chrome_importer),
+        notifier_(notifier),
+        items_(items),
+        lane_(std::move(lane)) {}
+  ~ImportLane() override {}
+
+  bool empty() const {
+    for (importer::ImportItem item : lane_) {
+      if (items_ & item)
+        return false;
+    }
+    return true;
   }
 
-  bridge_->NotifyEnded();
+  // base::DelegateSimpleThread::Delegate:
+  void Run() override {
+    for (importer::ImportItem item : lane_) {
+      if (!(items_ & item) || importer_->cancelled())
+        continue;
+      notifier_->ItemStarted(item);
+      importer_->ImportItem(item);
+      notifier_->ItemEnded(item);
+    }
+  }
+
+ private:
+  ChromeImporter* importer_;
+  ItemNotifier* notifier_;
+  uint16_t items_;
+  std::vector<importer::ImportItem> lane_;
+
+  DISALLOW_COPY_AND_ASSIGN(ImportLane);
+};
+
+void ChromeImporter::RunImportLanes(
+    uint16_t items,
+    std::vector<std::vector<importer::ImportItem>> lanes) {
+  ItemNotifier notifier(bridge_);
+  std::vector<std::unique_ptr<ImportLane>> import_lanes;
+  for (auto& lane : lanes) {
+    auto import_lane = std::make_unique<ImportLane>(this, &notifier, items,
+                                                    std::move(lane));
+    if (!import_lane->empty())
+      import_lanes.push_back(std::move(import_lane));
+  }
+  if (import_lanes.empty())
+    return;
+
+  // the first lane runs on this thread
+  std::vector<std::unique_ptr<base::DelegateSimpleThread>> threads;
+  for (size_t i = 1; i < import_lanes.size(); ++i) {
+    threads.push_back(std::make_unique<base::DelegateSimpleThread>(
+        import_lanes[i].get(), "ImportLane"));
+    threads.back()->Start();
+  }
+  import_lanes.front()->Run();
+  for (const auto& thread : threads)
+    thread->Join();
+}
+
+void ChromeImporter::ImportItem(importer::ImportItem item) {
+  switch (item) {
+    case importer::HISTORY:
+      ImportHistory();
+      break;
+    case importer::FAVORITES:
+      ImportBookmarks();
+      break;
+    case importer::PASSWORDS:
+      ImportPasswords(base::FilePath(FILE_PATH_LITERAL("Preferences")));
+      break;
+    case importer::COOKIES:
+      ImportCookies();
+      break;
+    default:
+      NOTREACHED();
+  }
 }
 
 void ChromeImporter::ImportHistory() {
@@ -125,6 +439,7 @@ void ChromeImporter::ImportHistory() {
   s.BindInt(4, ui::PAGE_TRANSITION_KEYWORD_GENERATED);
 
   std::vector<ImporterURLRow> rows;
+  rows.reserve(history_chunk_size_);
   while (s.Step() && !cancelled()) {
     GURL url(s.ColumnString(0));
 
@@ -136,7 +451,13 @@ void ChromeImporter::ImportHistory() {
     row.typed_count = s.ColumnInt(3);
     row.visit_count = s.ColumnInt(4);
 
-    rows.push_back(row);
+    rows.push_back(std::move(row));
+
+    // the browser writes this chunk while the next one is read
+    if (rows.size() >= history_chunk_size_) {
+      bridge_->SetHistoryItems(rows, importer::VISIT_SOURCE_CHROME_IMPORTED);
+      rows.clear();
+    }
   }
 
   if (!rows.empty() && !cancelled())
@@ -196,65 +517,70 @@ void ChromeImporter::ImportBookmarks() {
   if (!db.Open(favicons_path))
     return;
 
-  FaviconMap favicon_map;
-  ImportFaviconURLs(&db, &favicon_map);
-  // Write favicons into profile.
-  if (!favicon_map.empty() && !cancelled()) {
-    favicon_base::FaviconUsageDataList favicons;
-    LoadFaviconData(&db, favicon_map, &favicons);
-    bridge_->SetFavicons(favicons);
-  }
-}
-
-void ChromeImporter::ImportFaviconURLs(
-  sql::Database* db,
-  FaviconMap* favicon_map) {
-  const char query[] = "SELECT icon_id, page_url FROM icon_mapping;";
-  sql::Statement s(db->GetUniqueStatement(query));
-
-  while (s.Step() && !cancelled()) {
-    int64_t icon_id = s.ColumnInt64(0);
-    GURL url = GURL(s.ColumnString(1));
-    (*favicon_map)[icon_id].insert(url);
-  }
+  ImportFavicons(&db);
 }
 
-void ChromeImporter::LoadFaviconData(
-    sql::Database* db,
-    const FaviconMap& favicon_map,
-    favicon_base::FaviconUsageDataList* favicons) {
-  const char query[] = "SELECT f.url, fb.image_data "
-                       "FROM favicons f "
-                       "JOIN favicon_bitmaps fb "
-                       "ON f.id = fb.icon_id "
-                       "WHERE f.id = ?;";
+void ChromeImporter::ImportFavicons(sql::Database* db) {
+  // One row per icon used by at least one page: the icon's first bitmap and
+  // the pages using it, separated by newlines, which URLs can't contain.
+  const char query[] =
+      "SELECT f.url, fb.image_data, "
+      "(SELECT GROUP_CONCAT(m.page_url, '\n') FROM icon_mapping m "
+      "WHERE m.icon_id = f.id) "
+      "FROM favicons f "
+      "JOIN favicon_bitmaps fb ON fb.id = "
+      "(SELECT MIN(b.id) FROM favicon_bitmaps b WHERE b.icon_id = f.id) "
+      "ORDER BY f.id";
   sql::Statement s(db->GetUniqueStatement(query));
-
   if (!s.is_valid())
     return;
 
-  for (FaviconMap::const_iterator i = favicon_map.begin();
-       i != favicon_map.end(); ++i) {
-    s.BindInt64(0, i->first);
-    if (s.Step()) {
-      favicon_base::FaviconUsageData usage;
+  std::vector<FaviconRow> rows;
+  bool done = false;
+  while (!done && !cancelled()) {
+    rows.clear();
+    while (rows.size() < kFaviconBatchSize) {
+      if (!s.Step()) {
+        done = true;
+        break;
+      }
 
-      usage.favicon_url = GURL(s.ColumnString(0));
-      if (!usage.favicon_url.is_valid())
+      FaviconRow row;
+      row.usage.favicon_url = GURL(s.ColumnString(0));
+      if (!row.usage.favicon_url.is_valid())
         continue;  // Don't bother importing favicons with invalid URLs.
 
-      std::vector<unsigned char> data;
-      s.ColumnBlobAsVector(1, &data);
-      if (data.empty())
+      s.ColumnBlobAsVector(1, &row.image_data);
+      if (row.image_data.empty())
         continue;  // Data definitely invalid.
 
-      if (!importer::ReencodeFavicon(&data[0], data.size(), &usage.png_data))
-        continue;  // Unable to decode.
+      for (const auto& page_url :
+           base::SplitStringPiece(s.ColumnString(2), "\n",
+                                  base::KEEP_WHITESPACE,
+                                  base::SPLIT_WANT_NONEMPTY)) {
+        row.usage.urls.insert(GURL(page_url));
+      }
+      if (row.usage.urls.empty())
+        continue;  // Not used by any page.
 
-      usage.urls = i->second;
-      favicons->push_back(usage);
+      rows.push_back(std::move(row));
     }
-    s.Reset(true);
+
+    worker_pool_->RunInParallel(
+        rows.size(), kMinFaviconsPerThread,
+        base::BindRepeating(
+            [](std::vector<FaviconRow>* rows, size_t i) {
+              ReencodeFaviconRow(&(*rows)[i]);
+            },
+            &rows));
+
+    favicon_base::FaviconUsageDataList favicons;
+    for (auto& row : rows) {
+      if (row.reencoded)  // Skip the ones that couldn't be decoded.
+        favicons.push_back(std::move(row.usage));
+    }
+    if (!favicons.empty() && !cancelled())
+      bridge_->SetFavicons(favicons);
   }
 }
 
@@ -424,36 +750,86 @@ void ChromeImporter::ImportCookies() {
   OSCrypt::SetConfig(std::make_unique<os_crypt::Config>());
 #endif
 
-  std::vector<net::CanonicalCookie> cookies;
-  while (s.Step() && !cancelled()) {
-    std::string encrypted_value = s.ColumnString(4);
-    std::string value;
-    if (!encrypted_value.empty() && delegate) {
-      if (!delegate->DecryptString(encrypted_value, &value)) {
-        continue;
+  // Rows are read, decrypted in parallel and sent to the browser a chunk at
+  // a time, so the rows held in memory don't grow with the cookie count.
+  // The database is only used from this thread.
+  std::vector<CookieRow> rows;
+  bool done = false;
+  while (!done && !cancelled()) {
+    rows.clear();
+    while (rows.size() < kCookieChunkSize) {
+      if (!s.Step()) {
+        done = true;
+        break;
       }
-    } else {
-      value = s.ColumnString(3);
+
+      CookieRow row;
+      row.creation_utc = s.ColumnInt64(0);
+      row.domain = s.ColumnString(1);
+      row.name = s.ColumnString(2);
+      row.encrypted_value = s.ColumnString(4);
+      row.path = s.ColumnString(5);
+      row.expires_utc = s.ColumnInt64(6);
+      row.secure = s.ColumnBool(7);
+      row.http_only = s.ColumnBool(8);
+      row.same_site = s.ColumnInt(9);
+      row.last_access_utc = s.ColumnInt64(10);
+      row.priority = s.ColumnInt(13);
+      row.decrypted = true;
+      if (row.encrypted_value.empty() || !delegate)
+        row.value = s.ColumnString(3);
+      rows.push_back(std::move(row));
     }
+    if (cancelled())
+      return;
 
-    auto cookie = net::CanonicalCookie(
-        s.ColumnString(2),                           // name
-        value,                                       // value
-        s.ColumnString(1),                           // domain
-        s.ColumnString(5),                           // path
-        Time::FromInternalValue(s.ColumnInt64(0)),   // creation_utc
-        Time::FromInternalValue(s.ColumnInt64(6)),   // expires_utc
-        Time::FromInternalValue(s.ColumnInt64(10)),  // last_access_utc
-        s.ColumnBool(7),                             // secure
-        s.ColumnBool(8),                             // http_only
-        static_cast<net::CookieSameSite>(s.ColumnInt(9)),    // samesite
-        static_cast<net::CookiePriority>(s.ColumnInt(13)));  // priority
-    if (cookie.IsCanonical()) {
-      cookies.push_back(cookie);
+    if (delegate) {
+      std::vector<CookieRow*> encrypted_rows;
+      for (auto& row : rows) {
+        if (!row.encrypted_value.empty())
+          encrypted_rows.push_back(&row);
+      }
+      // The first value is decrypted on this thread so that the key is
+      // fetched, and the user asked for access to it where needed, before
+      // the workers start; later calls reuse the key.
+      if (!encrypted_rows.empty()) {
+        DecryptCookieRow(delegate, encrypted_rows.front());
+        worker_pool_->RunInParallel(
+            encrypted_rows.size() - 1, kMinCookiesPerThread,
+            base::BindRepeating(
+                [](net::CookieCryptoDelegate* delegate,
+                   const std::vector<CookieRow*>* rows, size_t i) {
+                  DecryptCookieRow(delegate, (*rows)[i + 1]);
+                },
+                delegate, &encrypted_rows));
+      }
     }
-  }
 
-  if (!cookies.empty() && !cancelled()) {
-    bridge_->SetCookies(cookies);
+    std::vector<net::CanonicalCookie> cookies;
+    cookies.reserve(rows.size());
+    for (const auto& row : rows) {
+      if (!row.decrypted)
+        continue;
+
+      auto cookie = net::CanonicalCookie(
+          row.name,
+          row.value,
+          row.domain,
+          row.path,
+          Time::FromInternalValue(row.creation_utc),
+          Time::FromInternalValue(row.expires_utc),
+          Time::FromInternalValue(row.last_access_utc),
+          row.secure,
+          row.http_only,
+          static_cast<net::CookieSameSite>(row.same_site),
+          static_cast<net::CookiePriority>(row.priority));
+      if (cookie.IsCanonical()) {
+        cookies.push_back(std::move(cookie));
+      }
+    }
+
+    if (!cookies.empty() && !cancelled()) {
+      bridge_->SetCookies(cookies);
+    }
   }
 }
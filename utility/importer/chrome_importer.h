@@ -7,8 +7,7 @@
 
 #include <stdint.h>
 
-#include <map>
-#include <set>
+#include <memory>
 #include <vector>
 
 #include "base/compiler_specific.h"
@@ -16,6 +15,7 @@
 #include "base/macros.h"
 #include "base/nix/xdg_util.h"
 #include "build/build_config.h"
+#include "chrome/common/importer/importer_data_types.h"
 #include "chrome/utility/importer/importer.h"
 #include "components/favicon_base/favicon_usage_data.h"
 
@@ -38,11 +38,24 @@ class ChromeImporter : public Importer {
                    uint16_t items,
                    ImporterBridge* bridge) override;
 
+  void set_history_chunk_size_for_testing(size_t size) {
+    history_chunk_size_ = size;
+  }
+
  protected:
   ~ChromeImporter() override;
 
   static base::nix::DesktopEnvironment GetDesktopEnvironment();
 
+  // Runs each lane of item types on its own thread and returns once all are
+  // done. Items in a lane are imported in order, and only those in |items|.
+  // Lanes must not share state, including the files they read. The bridge
+  // is told about one item at a time, from start to end.
+  void RunImportLanes(uint16_t items,
+                      std::vector<std::vector<importer::ImportItem>> lanes);
+  // Imports one item type, between NotifyItemStarted and NotifyItemEnded.
+  virtual void ImportItem(importer::ImportItem item);
+
   virtual void ImportBookmarks();
   virtual void ImportHistory();
   virtual void ImportPasswords(const base::FilePath& prefs_filename);
@@ -52,21 +65,17 @@ class ChromeImporter : public Importer {
 
   base::FilePath source_path_;
 
- private:
-  // Multiple URLs can share the same favicon; this is a map
-  // of URLs -> IconIDs that we load as a temporary step before
-  // actually loading the icons.
-  typedef std::map<int64_t, std::set<GURL>> FaviconMap;
+  // Number of history rows passed to the bridge at a time.
+  size_t history_chunk_size_;
 
-  // Loads the urls associated with the favicons into favicon_map;
-  void ImportFaviconURLs(
-    sql::Database* db,
-    FaviconMap* favicon_map);
+ private:
+  class ImportLane;
+  class ItemNotifier;
+  class WorkerPool;
 
-  // Loads and reencodes the individual favicons.
-  void LoadFaviconData(sql::Database* db,
-                       const FaviconMap& favicon_map,
-                       favicon_base::FaviconUsageDataList* favicons);
+  // Reads, re-encodes and sends the favicons of the Favicons database in
+  // batches.
+  void ImportFavicons(sql::Database* db);
 
   void RecursiveReadBookmarksFolder(
     const base::DictionaryValue* folder,
@@ -74,6 +83,9 @@ class ChromeImporter : public Importer {
     bool is_in_toolbar,
     std::vector<ImportedBookmarkEntry>* bookmarks);
 
+  // Threads for parallel work, for the length of StartImport.
+  std::unique_ptr<WorkerPool> worker_pool_;
+
   DISALLOW_COPY_AND_ASSIGN(ChromeImporter);
 };
 
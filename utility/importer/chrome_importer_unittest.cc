@@ -6,11 +6,20 @@
 #include "brave/common/brave_paths.h"
 #include "brave/common/importer/brave_mock_importer_bridge.h"
 
+#include <algorithm>
+#include <set>
+#include <utility>
+#include <vector>
+
 #include "base/files/file_path.h"
 #include "base/files/file_util.h"
 #include "base/files/scoped_temp_dir.h"
 #include "base/strings/utf_string_conversions.h"
 #include "base/path_service.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/synchronization/lock.h"
+#include "base/synchronization/waitable_event.h"
+#include "base/test/test_timeouts.h"
 #include "chrome/common/chrome_paths.h"
 #include "chrome/common/importer/imported_bookmark_entry.h"
 #include "chrome/common/importer/importer_data_types.h"
@@ -18,7 +27,11 @@
 #include "chrome/common/importer/mock_importer_bridge.h"
 #include "components/favicon_base/favicon_usage_data.h"
 #include "components/os_crypt/os_crypt_mocker.h"
+#include "sql/database.h"
+#include "sql/statement.h"
 #include "testing/gtest/include/gtest/gtest.h"
+#include "third_party/skia/include/core/SkBitmap.h"
+#include "ui/gfx/codec/png_codec.h"
 
 using base::ASCIIToUTF16;
 using base::UTF16ToASCII;
@@ -84,6 +97,28 @@ TEST_F(ChromeImporterTest, ImportHistory) {
   EXPECT_EQ("https://www.nytimes.com/", history[2].url.spec());
 }
 
+TEST_F(ChromeImporterTest, ImportHistoryInChunks) {
+  std::vector<ImporterURLRow> first_chunk;
+  std::vector<ImporterURLRow> last_chunk;
+
+  EXPECT_CALL(*bridge_, NotifyStarted());
+  EXPECT_CALL(*bridge_, NotifyItemStarted(importer::HISTORY));
+  EXPECT_CALL(*bridge_, SetHistoryItems(_, _))
+      .WillOnce(::testing::SaveArg<0>(&first_chunk))
+      .WillOnce(::testing::SaveArg<0>(&last_chunk));
+  EXPECT_CALL(*bridge_, NotifyItemEnded(importer::HISTORY));
+  EXPECT_CALL(*bridge_, NotifyEnded());
+
+  importer_->set_history_chunk_size_for_testing(2);
+  importer_->StartImport(profile_, importer::HISTORY, bridge_.get());
+
+  ASSERT_EQ(2u, first_chunk.size());
+  EXPECT_EQ("https://brave.com/", first_chunk[0].url.spec());
+  EXPECT_EQ("https://github.com/brave", first_chunk[1].url.spec());
+  ASSERT_EQ(1u, last_chunk.size());
+  EXPECT_EQ("https://www.nytimes.com/", last_chunk[0].url.spec());
+}
+
 TEST_F(ChromeImporterTest, ImportBookmarks) {
   std::vector<ImportedBookmarkEntry> bookmarks;
 
@@ -134,6 +169,85 @@ TEST_F(ChromeImporterTest, ImportFavicons) {
             favicons[3].favicon_url.spec());
 }
 
+TEST_F(ChromeImporterTest, ImportFaviconsInBatches) {
+  // Replaces the Favicons database with 250 icons used by two pages each.
+  base::FilePath favicons_path = profile_dir_.AppendASCII("Favicons");
+  ASSERT_TRUE(base::DeleteFile(favicons_path, false));
+  {
+    sql::Database db;
+    ASSERT_TRUE(db.Open(favicons_path));
+    ASSERT_TRUE(db.Execute(
+        "CREATE TABLE favicons(id INTEGER PRIMARY KEY, url LONGVARCHAR)"));
+    ASSERT_TRUE(db.Execute(
+        "CREATE TABLE favicon_bitmaps(id INTEGER PRIMARY KEY, "
+        "icon_id INTEGER, image_data BLOB)"));
+    ASSERT_TRUE(db.Execute(
+        "CREATE TABLE icon_mapping(id INTEGER PRIMARY KEY, "
+        "page_url LONGVARCHAR, icon_id INTEGER)"));
+
+    SkBitmap bitmap;
+    bitmap.allocN32Pixels(16, 16);
+    bitmap.eraseColor(SK_ColorBLUE);
+    std::vector<unsigned char> png_data;
+    ASSERT_TRUE(gfx::PNGCodec::EncodeBGRASkBitmap(bitmap, false, &png_data));
+
+    for (int i = 1; i <= 250; ++i) {
+      const std::string site =
+          "https://site" + base::IntToString(i) + ".example.com/";
+      sql::Statement icon(db.GetUniqueStatement(
+          "INSERT INTO favicons(id, url) VALUES(?, ?)"));
+      icon.BindInt(0, i);
+      icon.BindString(1, site + "favicon.ico");
+      ASSERT_TRUE(icon.Run());
+
+      sql::Statement bitmap_row(db.GetUniqueStatement(
+          "INSERT INTO favicon_bitmaps(icon_id, image_data) VALUES(?, ?)"));
+      bitmap_row.BindInt(0, i);
+      bitmap_row.BindBlob(1, png_data.data(), png_data.size());
+      ASSERT_TRUE(bitmap_row.Run());
+
+      for (const char* page : {"", "news"}) {
+        sql::Statement mapping(db.GetUniqueStatement(
+            "INSERT INTO icon_mapping(page_url, icon_id) VALUES(?, ?)"));
+        mapping.BindString(0, site + page);
+        mapping.BindInt(1, i);
+        ASSERT_TRUE(mapping.Run());
+      }
+    }
+  }
+
+  std::vector<favicon_base::FaviconUsageDataList> batches(3);
+
+  EXPECT_CALL(*bridge_, NotifyStarted());
+  EXPECT_CALL(*bridge_, NotifyItemStarted(importer::FAVORITES));
+  EXPECT_CALL(*bridge_, AddBookmarks(_, _));
+  EXPECT_CALL(*bridge_, SetFavicons(_))
+      .WillOnce(::testing::SaveArg<0>(&batches[0]))
+      .WillOnce(::testing::SaveArg<0>(&batches[1]))
+      .WillOnce(::testing::SaveArg<0>(&batches[2]));
+  EXPECT_CALL(*bridge_, NotifyItemEnded(importer::FAVORITES));
+  EXPECT_CALL(*bridge_, NotifyEnded());
+
+  importer_->StartImport(profile_, importer::FAVORITES, bridge_.get());
+
+  ASSERT_EQ(100u, batches[0].size());
+  ASSERT_EQ(100u, batches[1].size());
+  ASSERT_EQ(50u, batches[2].size());
+  // icons keep their order across batches, with all the pages using them
+  EXPECT_EQ("https://site1.example.com/favicon.ico",
+            batches[0][0].favicon_url.spec());
+  EXPECT_EQ("https://site101.example.com/favicon.ico",
+            batches[1][0].favicon_url.spec());
+  EXPECT_EQ("https://site250.example.com/favicon.ico",
+            batches[2][49].favicon_url.spec());
+  for (const auto& batch : batches) {
+    for (const auto& favicon : batch) {
+      EXPECT_EQ(2u, favicon.urls.size());
+      EXPECT_FALSE(favicon.png_data.empty());
+    }
+  }
+}
+
 // The mock keychain only works on macOS, so only run this test on macOS (for now)
 #if defined(OS_MACOSX)
 TEST_F(ChromeImporterTest, ImportPasswords) {
@@ -192,3 +306,149 @@ TEST_F(ChromeImporterTest, ImportCookies) {
   OSCryptMocker::TearDown();
 }
 #endif
+
+namespace {
+
+// Imports nothing. The first items of the two lanes, HISTORY and PASSWORDS,
+// each wait for the other to start, and HISTORY then waits for PASSWORDS to
+// be done, which may cancel the import.
+class ConcurrentChromeImporter : public ChromeImporter {
+ public:
+  ConcurrentChromeImporter()
+      : cancel_(false),
+        history_met_passwords_(false),
+        passwords_met_history_(false),
+        history_started_(base::WaitableEvent::ResetPolicy::MANUAL,
+                         base::WaitableEvent::InitialState::NOT_SIGNALED),
+        passwords_started_(base::WaitableEvent::ResetPolicy::MANUAL,
+                           base::WaitableEvent::InitialState::NOT_SIGNALED),
+        passwords_done_(base::WaitableEvent::ResetPolicy::MANUAL,
+                        base::WaitableEvent::InitialState::NOT_SIGNALED) {}
+
+  void set_cancel() { cancel_ = true; }
+
+  // Whether both lanes were importing at once.
+  bool lanes_met() const {
+    return history_met_passwords_ && passwords_met_history_;
+  }
+
+  std::vector<importer::ImportItem> imported() {
+    base::AutoLock lock(lock_);
+    return imported_;
+  }
+
+ protected:
+  ~ConcurrentChromeImporter() override {}
+
+  void ImportItem(importer::ImportItem item) override {
+    {
+      base::AutoLock lock(lock_);
+      imported_.push_back(item);
+    }
+    if (item == importer::HISTORY) {
+      history_started_.Signal();
+      history_met_passwords_ =
+          passwords_started_.TimedWait(TestTimeouts::action_timeout());
+      passwords_done_.TimedWait(TestTimeouts::action_timeout());
+    } else if (item == importer::PASSWORDS) {
+      passwords_started_.Signal();
+      passwords_met_history_ =
+          history_started_.TimedWait(TestTimeouts::action_timeout());
+      if (cancel_)
+        Cancel();
+      passwords_done_.Signal();
+    }
+  }
+
+ private:
+  bool cancel_;
+  bool history_met_passwords_;
+  bool passwords_met_history_;
+  base::WaitableEvent history_started_;
+  base::WaitableEvent passwords_started_;
+  base::WaitableEvent passwords_done_;
+  base::Lock lock_;
+  std::vector<importer::ImportItem> imported_;
+
+  DISALLOW_COPY_AND_ASSIGN(ConcurrentChromeImporter);
+};
+
+}  // namespace
+
+class ChromeImporterLanesTest : public ::testing::Test {
+ public:
+  ChromeImporterLanesTest()
+      : importer_(new ConcurrentChromeImporter),
+        bridge_(new BraveMockImporterBridge) {}
+
+ protected:
+  // Records the item notifications, true for a start.
+  void SetUp() override {
+    EXPECT_CALL(*bridge_, NotifyStarted());
+    EXPECT_CALL(*bridge_, NotifyItemStarted(_))
+        .WillRepeatedly(::testing::Invoke([this](importer::ImportItem item) {
+          base::AutoLock lock(lock_);
+          notifications_.push_back(std::make_pair(true, item));
+        }));
+    EXPECT_CALL(*bridge_, NotifyItemEnded(_))
+        .WillRepeatedly(::testing::Invoke([this](importer::ImportItem item) {
+          base::AutoLock lock(lock_);
+          notifications_.push_back(std::make_pair(false, item));
+        }));
+    EXPECT_CALL(*bridge_, NotifyEnded());
+  }
+
+  // Checks that every item of |items| was started and ended once, and that
+  // no item started before the previous one ended.
+  void ExpectOneItemAtATime(std::set<importer::ImportItem> items) {
+    ASSERT_EQ(2 * items.size(), notifications_.size());
+    for (size_t i = 0; i < notifications_.size(); i += 2) {
+      EXPECT_TRUE(notifications_[i].first);
+      EXPECT_FALSE(notifications_[i + 1].first);
+      EXPECT_EQ(notifications_[i].second, notifications_[i + 1].second);
+      EXPECT_EQ(1u, items.erase(notifications_[i].second));
+    }
+  }
+
+  importer::SourceProfile profile_;
+  scoped_refptr<ConcurrentChromeImporter> importer_;
+  scoped_refptr<BraveMockImporterBridge> bridge_;
+  base::Lock lock_;
+  std::vector<std::pair<bool, importer::ImportItem>> notifications_;
+};
+
+TEST_F(ChromeImporterLanesTest, ImportsLanesConcurrently) {
+  importer_->StartImport(profile_,
+                         importer::HISTORY | importer::FAVORITES |
+                             importer::PASSWORDS | importer::COOKIES,
+                         bridge_.get());
+
+  EXPECT_TRUE(importer_->lanes_met());
+  std::vector<importer::ImportItem> imported = importer_->imported();
+  EXPECT_EQ(4u, imported.size());
+  // items of a lane keep their order
+  EXPECT_LT(std::find(imported.begin(), imported.end(), importer::HISTORY),
+            std::find(imported.begin(), imported.end(), importer::FAVORITES));
+  EXPECT_LT(std::find(imported.begin(), imported.end(), importer::PASSWORDS),
+            std::find(imported.begin(), imported.end(), importer::COOKIES));
+  ExpectOneItemAtATime({importer::HISTORY, importer::FAVORITES,
+                        importer::PASSWORDS, importer::COOKIES});
+}
+
+TEST_F(ChromeImporterLanesTest, CancelWhileBothLanesRun) {
+  importer_->set_cancel();
+  importer_->StartImport(profile_,
+                         importer::HISTORY | importer::FAVORITES |
+                             importer::PASSWORDS | importer::COOKIES,
+                         bridge_.get());
+
+  EXPECT_TRUE(importer_->lanes_met());
+  // the items running when cancelled finish, the rest don't start
+  std::vector<importer::ImportItem> imported = importer_->imported();
+  EXPECT_EQ(2u, imported.size());
+  EXPECT_EQ(imported.end(),
+            std::find(imported.begin(), imported.end(), importer::FAVORITES));
+  EXPECT_EQ(imported.end(),
+            std::find(imported.begin(), imported.end(), importer::COOKIES));
+  ExpectOneItemAtATime({importer::HISTORY, importer::PASSWORDS});
+}
@@ -4,6 +4,8 @@
 
 #include "brave/utility/importer/firefox_importer.h"
 
+#include <string>
+#include <utility>
 #include <vector>
 
 #include "base/files/file_enumerator.h"
@@ -25,7 +27,16 @@ using base::Time;
 
 namespace brave {
 
-FirefoxImporter::FirefoxImporter() {
+namespace {
+
+// Cookies read before they are passed to the bridge, which keeps memory flat
+// for large profiles and lets the browser store a chunk while the next one
+// is read.
+const size_t kCookieChunkSize = 1000;
+
+}  // namespace
+
+FirefoxImporter::FirefoxImporter() : cookie_chunk_size_(kCookieChunkSize) {
 }
 
 FirefoxImporter::~FirefoxImporter() {
@@ -59,45 +70,46 @@ void FirefoxImporter::ImportCookies() {
   }
 
   const char query[] =
-      "select baseDomain, name, value, host, path, expiry, lastAccessed, "
+      "select baseDomain, name, value, path, expiry, lastAccessed, "
       "creationTime, isSecure, isHttpOnly, sameSite FROM moz_cookies";
 
   sql::Statement s(db.GetUniqueStatement(query));
 
   std::vector<net::CanonicalCookie> cookies;
+  cookies.reserve(cookie_chunk_size_);
+  std::string domain;
   while (s.Step() && !cancelled()) {
-    std::string domain(".");
+    // the cookie domain is built in place, each column is read once
+    domain.assign(1, '.');
     domain.append(s.ColumnString(0));
-    std::string host;
-    if (s.ColumnString(3)[0] == '.') {
-      host.append("*");
-      host.append(s.ColumnString(3));
-    } else {
-      host = s.ColumnString(3);
-    }
 
     // Firefox represents expiry in *seconds* since the Unix epoch,
     // while lastAccessed and creationTime are measured in microseconds.
     // Source: netwerk/cookie/nsICookie2.idl.
-    const Time expiry = Time::FromDoubleT(s.ColumnInt64(5));
-    const Time last_accessed = Time::FromDoubleT(s.ColumnInt64(6) / 1000000);
-    const Time creation = Time::FromDoubleT(s.ColumnInt64(7) / 1000000);
-    
-    auto cookie = net::CanonicalCookie(
+    const Time expiry = Time::FromDoubleT(s.ColumnInt64(4));
+    const Time last_accessed = Time::FromDoubleT(s.ColumnInt64(5) / 1000000);
+    const Time creation = Time::FromDoubleT(s.ColumnInt64(6) / 1000000);
+
+    net::CanonicalCookie cookie(
         s.ColumnString(1),  // name
         s.ColumnString(2),  // value
         domain,  // domain
-        s.ColumnString(4),  // path
+        s.ColumnString(3),  // path
         creation,  // creation
         expiry,  // expiration
         last_accessed,  // last_access
-        s.ColumnBool(8),  // secure
-        s.ColumnBool(9),  // http_only
-        static_cast<net::CookieSameSite>(s.ColumnInt(10)),  // samesite
+        s.ColumnBool(7),  // secure
+        s.ColumnBool(8),  // http_only
+        static_cast<net::CookieSameSite>(s.ColumnInt(9)),  // samesite
         net::COOKIE_PRIORITY_DEFAULT  // priority
         );
-    if (cookie.IsCanonical()) {
-      cookies.push_back(cookie);
+    if (!cookie.IsCanonical())
+      continue;
+
+    cookies.push_back(std::move(cookie));
+    if (cookies.size() >= cookie_chunk_size_) {
+      bridge_->SetCookies(cookies);
+      cookies.clear();
     }
   }
 
@@ -18,6 +18,10 @@ class FirefoxImporter : public ::FirefoxImporter {
                    uint16_t items,
                    ImporterBridge* bridge) override;
 
+  void set_cookie_chunk_size_for_testing(size_t size) {
+    cookie_chunk_size_ = size;
+  }
+
  private:
   ~FirefoxImporter() override;
 
@@ -25,6 +29,9 @@ class FirefoxImporter : public ::FirefoxImporter {
 
   base::FilePath source_path_;
 
+  // Number of cookies passed to the bridge at a time.
+  size_t cookie_chunk_size_;
+
   DISALLOW_COPY_AND_ASSIGN(FirefoxImporter);
 };
 
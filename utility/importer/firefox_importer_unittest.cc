@@ -12,6 +12,7 @@
 #include "base/path_service.h"
 #include "chrome/common/importer/importer_data_types.h"
 #include "chrome/common/importer/mock_importer_bridge.h"
+#include "sql/database.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
 using ::testing::_;
@@ -71,3 +72,38 @@ TEST_F(FirefoxImporterTest, ImportCookies) {
   EXPECT_EQ("test", cookies[0].Name());
   EXPECT_EQ("test", cookies[0].Value());
 }
+
+TEST_F(FirefoxImporterTest, ImportCookiesInChunks) {
+  {
+    sql::Database db;
+    ASSERT_TRUE(db.Open(profile_dir_.AppendASCII("cookies.sqlite")));
+    ASSERT_TRUE(db.Execute(
+        "INSERT INTO moz_cookies (baseDomain, name, value, host, path, "
+        "expiry, lastAccessed, creationTime, isSecure, isHttpOnly) VALUES "
+        "('localhost', 'test2', 'test2', 'localhost', '/', 4102444800, "
+        "1528742146791000, 1528742146791000, 0, 0), "
+        "('localhost', 'test3', 'test3', 'localhost', '/', 4102444800, "
+        "1528742146791000, 1528742146791000, 0, 0)"));
+  }
+
+  std::vector<net::CanonicalCookie> first_chunk;
+  std::vector<net::CanonicalCookie> last_chunk;
+
+  EXPECT_CALL(*bridge_, NotifyStarted());
+  EXPECT_CALL(*bridge_, NotifyItemStarted(importer::COOKIES));
+  EXPECT_CALL(*bridge_, SetCookies(_))
+      .WillOnce(::testing::SaveArg<0>(&first_chunk))
+      .WillOnce(::testing::SaveArg<0>(&last_chunk));
+  EXPECT_CALL(*bridge_, NotifyItemEnded(importer::COOKIES));
+  EXPECT_CALL(*bridge_, NotifyEnded());
+
+  importer_->set_cookie_chunk_size_for_testing(2);
+  importer_->StartImport(profile_, importer::COOKIES, bridge_.get());
+
+  ASSERT_EQ(2u, first_chunk.size());
+  EXPECT_EQ("test", first_chunk[0].Name());
+  EXPECT_EQ("test2", first_chunk[1].Name());
+  ASSERT_EQ(1u, last_chunk.size());
+  EXPECT_EQ("test3", last_chunk[0].Name());
+  EXPECT_EQ(".localhost", last_chunk[0].Domain());
+}
@@ -0,0 +1,585 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/files/file_path.h"
+#include "base/files/file_util.h"
+#include "base/files/scoped_temp_dir.h"
+#include "base/json/json_writer.h"
+#include "base/macros.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/utf_string_conversions.h"
+#include "base/synchronization/lock.h"
+#include "base/time/time.h"
+#include "base/values.h"
+#include "brave/common/importer/brave_mock_importer_bridge.h"
+#include "brave/common/payload_size.h"
+#include "brave/utility/importer/brave_importer.h"
+#include "brave/utility/importer/chrome_importer.h"
+#include "brave/utility/importer/firefox_importer.h"
+#include "build/build_config.h"
+#include "chrome/common/importer/imported_bookmark_entry.h"
+#include "chrome/common/importer/importer_data_types.h"
+#include "chrome/common/importer/importer_url_row.h"
+#include "components/favicon_base/favicon_usage_data.h"
+#include "components/os_crypt/os_crypt.h"
+#include "components/os_crypt/os_crypt_mocker.h"
+#include "net/cookies/canonical_cookie.h"
+#include "sql/database.h"
+#include "sql/statement.h"
+#include "sql/transaction.h"
+#include "testing/gmock/include/gmock/gmock.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_test.h"
+#include "third_party/skia/include/core/SkBitmap.h"
+#include "ui/base/page_transition_types.h"
+#include "ui/gfx/codec/png_codec.h"
+
+#if defined(OS_POSIX)
+#include <sys/resource.h>
+#endif
+
+// npm run test -- brave_perftests --filter=ImporterPerfTest.*
+
+using testing::_;
+using testing::Invoke;
+using testing::NiceMock;
+
+namespace {
+
+// Size of a generated source profile. The "typical" numbers are a profile
+// after a few months of use; the others are 10x and 100x that.
+struct ProfileSize {
+  const char* name;
+  int history_urls;
+  int visits_per_url;
+  int cookies;
+  int favicons;
+  int pages_per_favicon;
+  int bookmark_folders;
+  int bookmarks_per_folder;
+};
+
+const ProfileSize kProfileSizes[] = {
+  {"typical", 2000, 3, 300, 200, 5, 10, 30},
+  {"10x", 20000, 3, 3000, 2000, 5, 100, 30},
+  {"100x", 200000, 3, 30000, 20000, 5, 1000, 30},
+};
+
+// Chrome stores times as microseconds since 1601.
+int64_t ToChromeTime(const base::Time& time) {
+  return time.ToInternalValue();
+}
+
+std::string HostForIndex(int index) {
+  return "site" + base::IntToString(index) + ".example.com";
+}
+
+std::string UrlForIndex(int index) {
+  return "https://" + HostForIndex(index % 5000) + "/page/" +
+         base::IntToString(index);
+}
+
+// A 16x16 PNG, which the importers decode and re-encode like a real icon.
+std::vector<unsigned char> MakeFaviconPng() {
+  SkBitmap bitmap;
+  bitmap.allocN32Pixels(16, 16);
+  bitmap.eraseARGB(255, 251, 84, 43);
+  std::vector<unsigned char> png;
+  gfx::PNGCodec::EncodeBGRASkBitmap(bitmap, false, &png);
+  return png;
+}
+
+bool WriteChromeHistory(const base::FilePath& path, const ProfileSize& size) {
+  sql::Database db;
+  if (!db.Open(path) ||
+      !db.Execute("CREATE TABLE urls(id INTEGER PRIMARY KEY AUTOINCREMENT,"
+                  "url LONGVARCHAR,title LONGVARCHAR,"
+                  "visit_count INTEGER DEFAULT 0 NOT NULL,"
+                  "typed_count INTEGER DEFAULT 0 NOT NULL,"
+                  "last_visit_time INTEGER NOT NULL,"
+                  "hidden INTEGER DEFAULT 0 NOT NULL)") ||
+      !db.Execute("CREATE TABLE visits(id INTEGER PRIMARY KEY,"
+                  "url INTEGER NOT NULL,visit_time INTEGER NOT NULL,"
+                  "from_visit INTEGER,transition INTEGER DEFAULT 0 NOT NULL,"
+                  "segment_id INTEGER,"
+                  "visit_duration INTEGER DEFAULT 0 NOT NULL)"))
+    return false;
+
+  sql::Transaction transaction(&db);
+  if (!transaction.Begin())
+    return false;
+
+  const int64_t now = ToChromeTime(base::Time::Now());
+  sql::Statement urls(db.GetUniqueStatement(
+      "INSERT INTO urls (id, url, title, visit_count, typed_count, "
+      "last_visit_time, hidden) VALUES (?, ?, ?, ?, ?, ?, 0)"));
+  sql::Statement visits(db.GetUniqueStatement(
+      "INSERT INTO visits (url, visit_time, transition) VALUES (?, ?, ?)"));
+  for (int i = 1; i <= size.history_urls; ++i) {
+    urls.BindInt(0, i);
+    urls.BindString(1, UrlForIndex(i));
+    urls.BindString(2, "Page " + base::IntToString(i) + " of a site");
+    urls.BindInt(3, size.visits_per_url);
+    urls.BindInt(4, i % 10 == 0 ? 1 : 0);
+    urls.BindInt64(5, now - i);
+    if (!urls.Run())
+      return false;
+    urls.Reset(true);
+
+    for (int visit = 0; visit < size.visits_per_url; ++visit) {
+      visits.BindInt(0, i);
+      visits.BindInt64(1, now - i - visit);
+      visits.BindInt(2, ui::PAGE_TRANSITION_LINK |
+                            ui::PAGE_TRANSITION_CHAIN_START |
+                            ui::PAGE_TRANSITION_CHAIN_END);
+      if (!visits.Run())
+        return false;
+      visits.Reset(true);
+    }
+  }
+  return transaction.Commit();
+}
+
+bool WriteChromeCookies(const base::FilePath& path, const ProfileSize& size) {
+  sql::Database db;
+  if (!db.Open(path) ||
+      !db.Execute("CREATE TABLE cookies (creation_utc INTEGER NOT NULL,"
+                  "host_key TEXT NOT NULL,name TEXT NOT NULL,"
+                  "value TEXT NOT NULL,path TEXT NOT NULL,"
+                  "expires_utc INTEGER NOT NULL,is_secure INTEGER NOT NULL,"
+                  "is_httponly INTEGER NOT NULL,"
+                  "last_access_utc INTEGER NOT NULL,"
+                  "has_expires INTEGER NOT NULL DEFAULT 1,"
+                  "is_persistent INTEGER NOT NULL DEFAULT 1,"
+                  "priority INTEGER NOT NULL DEFAULT 1,"
+                  "encrypted_value BLOB DEFAULT '',"
+                  "firstpartyonly INTEGER NOT NULL DEFAULT 0,"
+                  "UNIQUE (host_key, name, path))"))
+    return false;
+
+  sql::Transaction transaction(&db);
+  if (!transaction.Begin())
+    return false;
+
+  const base::Time now = base::Time::Now();
+  sql::Statement s(db.GetUniqueStatement(
+      "INSERT INTO cookies (creation_utc, host_key, name, value, path, "
+      "expires_utc, is_secure, is_httponly, last_access_utc, "
+      "encrypted_value) VALUES (?, ?, ?, '', '/', ?, 1, 0, ?, ?)"));
+  for (int i = 0; i < size.cookies; ++i) {
+    // values are encrypted like Chrome does, so decryption is measured too
+    std::string encrypted_value;
+    if (!OSCrypt::EncryptString("value" + base::IntToString(i),
+                                &encrypted_value))
+      return false;
+
+    s.BindInt64(0, ToChromeTime(now) - i);
+    s.BindString(1, "." + HostForIndex(i / 5));
+    s.BindString(2, "cookie" + base::IntToString(i % 5));
+    s.BindInt64(3, ToChromeTime(now + base::TimeDelta::FromDays(30)));
+    s.BindInt64(4, ToChromeTime(now));
+    s.BindBlob(5, encrypted_value.data(), encrypted_value.size());
+    if (!s.Run())
+      return false;
+    s.Reset(true);
+  }
+  return transaction.Commit();
+}
+
+bool WriteChromeFavicons(const base::FilePath& path, const ProfileSize& size) {
+  sql::Database db;
+  if (!db.Open(path) ||
+      !db.Execute("CREATE TABLE icon_mapping(id INTEGER PRIMARY KEY,"
+                  "page_url LONGVARCHAR NOT NULL,icon_id INTEGER)") ||
+      !db.Execute("CREATE TABLE favicons(id INTEGER PRIMARY KEY,"
+                  "url LONGVARCHAR NOT NULL,icon_type INTEGER DEFAULT 1)") ||
+      !db.Execute("CREATE TABLE favicon_bitmaps(id INTEGER PRIMARY KEY,"
+                  "icon_id INTEGER NOT NULL,last_updated INTEGER DEFAULT 0,"
+                  "image_data BLOB,width INTEGER DEFAULT 0,"
+                  "height INTEGER DEFAULT 0,"
+                  "last_requested INTEGER DEFAULT 0)"))
+    return false;
+
+  sql::Transaction transaction(&db);
+  if (!transaction.Begin())
+    return false;
+
+  const std::vector<unsigned char> png = MakeFaviconPng();
+  sql::Statement favicons(db.GetUniqueStatement(
+      "INSERT INTO favicons (id, url) VALUES (?, ?)"));
+  sql::Statement bitmaps(db.GetUniqueStatement(
+      "INSERT INTO favicon_bitmaps (icon_id, image_data, width, height) "
+      "VALUES (?, ?, 16, 16)"));
+  sql::Statement mappings(db.GetUniqueStatement(
+      "INSERT INTO icon_mapping (page_url, icon_id) VALUES (?, ?)"));
+  for (int i = 1; i <= size.favicons; ++i) {
+    favicons.BindInt(0, i);
+    favicons.BindString(1, "https://" + HostForIndex(i) + "/favicon.ico");
+    bitmaps.BindInt(0, i);
+    bitmaps.BindBlob(1, png.data(), png.size());
+    if (!favicons.Run() || !bitmaps.Run())
+      return false;
+    favicons.Reset(true);
+    bitmaps.Reset(true);
+
+    for (int page = 0; page < size.pages_per_favicon; ++page) {
+      mappings.BindString(0, UrlForIndex(i * size.pages_per_favicon + page));
+      mappings.BindInt(1, i);
+      if (!mappings.Run())
+        return false;
+      mappings.Reset(true);
+    }
+  }
+  return transaction.Commit();
+}
+
+bool WriteChromeBookmarks(const base::FilePath& path,
+                          const ProfileSize& size) {
+  const std::string date_added =
+      base::Int64ToString(ToChromeTime(base::Time::Now()));
+
+  base::Value folders(base::Value::Type::LIST);
+  int index = 0;
+  for (int i = 0; i < size.bookmark_folders; ++i) {
+    base::Value children(base::Value::Type::LIST);
+    for (int j = 0; j < size.bookmarks_per_folder; ++j, ++index) {
+      base::Value bookmark(base::Value::Type::DICTIONARY);
+      bookmark.SetKey("date_added", base::Value(date_added));
+      bookmark.SetKey("name",
+                      base::Value("Bookmark " + base::IntToString(index)));
+      bookmark.SetKey("type", base::Value("url"));
+      bookmark.SetKey("url", base::Value(UrlForIndex(index)));
+      children.GetList().push_back(std::move(bookmark));
+    }
+
+    base::Value folder(base::Value::Type::DICTIONARY);
+    folder.SetKey("children", std::move(children));
+    folder.SetKey("date_added", base::Value(date_added));
+    folder.SetKey("name", base::Value("Folder " + base::IntToString(i)));
+    folder.SetKey("type", base::Value("folder"));
+    folders.GetList().push_back(std::move(folder));
+  }
+
+  base::Value bookmark_bar(base::Value::Type::DICTIONARY);
+  bookmark_bar.SetKey("children", std::move(folders));
+  bookmark_bar.SetKey("name", base::Value("Bookmarks bar"));
+  bookmark_bar.SetKey("type", base::Value("folder"));
+
+  base::Value other(base::Value::Type::DICTIONARY);
+  other.SetKey("children", base::Value(base::Value::Type::LIST));
+  other.SetKey("name", base::Value("Other bookmarks"));
+  other.SetKey("type", base::Value("folder"));
+
+  base::Value roots(base::Value::Type::DICTIONARY);
+  roots.SetKey("bookmark_bar", std::move(bookmark_bar));
+  roots.SetKey("other", std::move(other));
+
+  base::Value root(base::Value::Type::DICTIONARY);
+  root.SetKey("roots", std::move(roots));
+  root.SetKey("version", base::Value(1));
+
+  std::string json;
+  return base::JSONWriter::Write(root, &json) &&
+         base::WriteFile(path, json.data(), json.size()) ==
+             static_cast<int>(json.size());
+}
+
+bool WriteChromeProfile(const base::FilePath& dir, const ProfileSize& size) {
+  return base::CreateDirectory(dir) &&
+         WriteChromeHistory(dir.AppendASCII("History"), size) &&
+         WriteChromeCookies(dir.AppendASCII("Cookies"), size) &&
+         WriteChromeFavicons(dir.AppendASCII("Favicons"), size) &&
+         WriteChromeBookmarks(dir.AppendASCII("Bookmarks"), size);
+}
+
+// session-store-1 of browser-laptop with the sections the importer reads.
+bool WriteBraveSessionStore(const base::FilePath& dir,
+                            const ProfileSize& size) {
+  const double now = base::Time::Now().ToJsTime();
+
+  base::Value history_sites(base::Value::Type::DICTIONARY);
+  for (int i = 1; i <= size.history_urls; ++i) {
+    const std::string location = UrlForIndex(i);
+    base::Value site(base::Value::Type::DICTIONARY);
+    site.SetKey("location", base::Value(location));
+    site.SetKey("title",
+                base::Value("Page " + base::IntToString(i) + " of a site"));
+    // browser-laptop times are fractional JS times
+    site.SetKey("lastAccessedTime", base::Value(now - i - 0.5));
+    site.SetKey("count", base::Value(size.visits_per_url));
+    site.SetKey("partitionNumber", base::Value(0));
+    history_sites.SetKey(location + "|0", std::move(site));
+  }
+
+  base::Value bookmarks(base::Value::Type::DICTIONARY);
+  base::Value bookmark_folders(base::Value::Type::DICTIONARY);
+  base::Value bookmark_order(base::Value::Type::DICTIONARY);
+  base::Value toolbar_order(base::Value::Type::LIST);
+  int index = 0;
+  for (int i = 1; i <= size.bookmark_folders; ++i) {
+    const std::string folder_key = base::IntToString(i);
+    base::Value folder(base::Value::Type::DICTIONARY);
+    folder.SetKey("title", base::Value("Folder " + folder_key));
+    folder.SetKey("folderId", base::Value(i));
+    folder.SetKey("parentFolderId", base::Value(0));
+    bookmark_folders.SetKey(folder_key, std::move(folder));
+
+    base::Value folder_entry(base::Value::Type::DICTIONARY);
+    folder_entry.SetKey("key", base::Value(folder_key));
+    folder_entry.SetKey("order", base::Value(i - 1));
+    folder_entry.SetKey("type", base::Value("bookmark-folder"));
+    toolbar_order.GetList().push_back(std::move(folder_entry));
+
+    base::Value folder_order(base::Value::Type::LIST);
+    for (int j = 0; j < size.bookmarks_per_folder; ++j, ++index) {
+      const std::string location = UrlForIndex(index);
+      const std::string key = location + "|0|" + folder_key;
+      base::Value bookmark(base::Value::Type::DICTIONARY);
+      bookmark.SetKey("location", base::Value(location));
+      bookmark.SetKey("title",
+                      base::Value("Bookmark " + base::IntToString(index)));
+      bookmark.SetKey("parentFolderId", base::Value(i));
+      bookmark.SetKey("type", base::Value("bookmark"));
+      bookmarks.SetKey(key, std::move(bookmark));
+
+      base::Value bookmark_entry(base::Value::Type::DICTIONARY);
+      bookmark_entry.SetKey("key", base::Value(key));
+      bookmark_entry.SetKey("order", base::Value(j));
+      bookmark_entry.SetKey("type", base::Value("bookmark"));
+      folder_order.GetList().push_back(std::move(bookmark_entry));
+    }
+    bookmark_order.SetKey(folder_key, std::move(folder_order));
+  }
+  bookmark_order.SetKey("0", std::move(toolbar_order));
+
+  base::Value root(base::Value::Type::DICTIONARY);
+  root.SetKey("historySites", std::move(history_sites));
+  root.SetKey("bookmarks", std::move(bookmarks));
+  root.SetKey("bookmarkFolders", std::move(bookmark_folders));
+  root.SetPath({"cache", "bookmarkOrder"}, std::move(bookmark_order));
+  root.SetPath({"adblock", "count"}, base::Value(size.history_urls));
+  root.SetPath({"trackingProtection", "count"}, base::Value(size.cookies));
+  root.SetPath({"httpsEverywhere", "count"}, base::Value(size.favicons));
+
+  std::string json;
+  const base::FilePath path = dir.AppendASCII("session-store-1");
+  return base::CreateDirectory(dir) &&
+         base::JSONWriter::Write(root, &json) &&
+         base::WriteFile(path, json.data(), json.size()) ==
+             static_cast<int>(json.size());
+}
+
+bool WriteFirefoxCookies(const base::FilePath& dir, const ProfileSize& size) {
+  sql::Database db;
+  if (!base::CreateDirectory(dir) ||
+      !db.Open(dir.AppendASCII("cookies.sqlite")) ||
+      !db.Execute("CREATE TABLE moz_cookies (id INTEGER PRIMARY KEY,"
+                  "baseDomain TEXT,originAttributes TEXT NOT NULL DEFAULT '',"
+                  "name TEXT,value TEXT,host TEXT,path TEXT,expiry INTEGER,"
+                  "lastAccessed INTEGER,creationTime INTEGER,"
+                  "isSecure INTEGER,isHttpOnly INTEGER,"
+                  "inBrowserElement INTEGER DEFAULT 0,"
+                  "sameSite INTEGER DEFAULT 0,"
+                  "CONSTRAINT moz_uniqueid UNIQUE (name, host, path, "
+                  "originAttributes))"))
+    return false;
+
+  sql::Transaction transaction(&db);
+  if (!transaction.Begin())
+    return false;
+
+  // expiry is in seconds, the other times in microseconds
+  const base::Time now = base::Time::Now();
+  const int64_t now_us = (now - base::Time::UnixEpoch()).InMicroseconds();
+  sql::Statement s(db.GetUniqueStatement(
+      "INSERT INTO moz_cookies (baseDomain, name, value, host, path, expiry, "
+      "lastAccessed, creationTime, isSecure, isHttpOnly) "
+      "VALUES (?, ?, ?, ?, '/', ?, ?, ?, 1, 0)"));
+  for (int i = 0; i < size.cookies; ++i) {
+    const std::string host = HostForIndex(i / 5);
+    s.BindString(0, host);
+    s.BindString(1, "cookie" + base::IntToString(i % 5));
+    s.BindString(2, "value" + base::IntToString(i));
+    s.BindString(3, "." + host);
+    s.BindInt64(4, (now + base::TimeDelta::FromDays(30)).ToTimeT());
+    s.BindInt64(5, now_us);
+    s.BindInt64(6, now_us - i);
+    if (!s.Run())
+      return false;
+    s.Reset(true);
+  }
+  return transaction.Commit();
+}
+
+// High-water mark of the resident set of the process in KB, 0 where
+// unsupported.
+int64_t GetPeakRssKb() {
+#if defined(OS_POSIX)
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0)
+    return 0;
+#if defined(OS_MACOSX)
+  return usage.ru_maxrss / 1024;  // bytes
+#else
+  return usage.ru_maxrss;
+#endif
+#else
+  return 0;
+#endif
+}
+
+// Counts what an importer hands to its bridge. The importers call the
+// bridge from several threads.
+class BridgeCounter {
+ public:
+  BridgeCounter() : calls_(0), items_(0), bytes_(0) {}
+
+  template <typename T>
+  void Add(const std::vector<T>& items) {
+    size_t bytes = 0;
+    for (const auto& item : items)
+      bytes += brave::EstimatePayloadSize(item);
+
+    base::AutoLock lock(lock_);
+    ++calls_;
+    items_ += items.size();
+    bytes_ += bytes;
+  }
+
+  size_t calls() const { return calls_; }
+  size_t items() const { return items_; }
+  size_t bytes() const { return bytes_; }
+
+ private:
+  base::Lock lock_;
+  size_t calls_;
+  size_t items_;
+  size_t bytes_;
+
+  DISALLOW_COPY_AND_ASSIGN(BridgeCounter);
+};
+
+}  // namespace
+
+class ImporterPerfTest : public testing::Test {
+ public:
+  ImporterPerfTest() {}
+  ~ImporterPerfTest() override {}
+
+ protected:
+  void SetUp() override {
+    ASSERT_TRUE(temp_dir_.CreateUniqueTempDir());
+    OSCryptMocker::SetUp();
+  }
+
+  void TearDown() override {
+    OSCryptMocker::TearDown();
+  }
+
+  base::FilePath GetProfileDir(const std::string& browser,
+                               const ProfileSize& size) {
+    return temp_dir_.GetPath().AppendASCII(browser).AppendASCII(size.name);
+  }
+
+  // Runs |importer| over the profile in |source_path| against a fake bridge
+  // and prints the wall time, the growth of the peak RSS, the number of
+  // bridge calls and the estimated IPC payload.
+  void Import(Importer* importer,
+              const base::FilePath& source_path,
+              uint16_t items,
+              const std::string& trace) {
+    BridgeCounter counter;
+    scoped_refptr<NiceMock<BraveMockImporterBridge>> bridge(
+        new NiceMock<BraveMockImporterBridge>);
+    ON_CALL(*bridge, SetHistoryItems(_, _))
+        .WillByDefault(Invoke(
+            [&counter](const std::vector<ImporterURLRow>& rows,
+                       importer::VisitSource) { counter.Add(rows); }));
+    ON_CALL(*bridge, AddBookmarks(_, _))
+        .WillByDefault(Invoke(
+            [&counter](const std::vector<ImportedBookmarkEntry>& bookmarks,
+                       const base::string16&) { counter.Add(bookmarks); }));
+    ON_CALL(*bridge, SetFavicons(_))
+        .WillByDefault(Invoke(
+            [&counter](const favicon_base::FaviconUsageDataList& favicons) {
+              counter.Add(favicons);
+            }));
+    ON_CALL(*bridge, SetCookies(_))
+        .WillByDefault(Invoke(
+            [&counter](const std::vector<net::CanonicalCookie>& cookies) {
+              counter.Add(cookies);
+            }));
+
+    importer::SourceProfile profile;
+    profile.source_path = source_path;
+
+    // ru_maxrss only grows, so the growth over the import is reported;
+    // filter to a single size for the absolute peak of one import
+    const int64_t rss_before = GetPeakRssKb();
+    const base::TimeTicks start = base::TimeTicks::Now();
+    importer->StartImport(profile, items, bridge.get());
+    const base::TimeDelta elapsed = base::TimeTicks::Now() - start;
+    const int64_t rss_after = GetPeakRssKb();
+
+    perf_test::PrintResult("import_time", "", trace,
+                           elapsed.InMillisecondsF(), "ms", true);
+    if (rss_after > 0) {
+      perf_test::PrintResult("peak_rss", "", trace,
+                             static_cast<size_t>(rss_after), "KB", false);
+      perf_test::PrintResult("peak_rss_growth", "", trace,
+                             static_cast<size_t>(rss_after - rss_before), "KB",
+                             true);
+    }
+    perf_test::PrintResult("bridge_calls", "", trace, counter.calls(),
+                           "count", false);
+    perf_test::PrintResult("imported_items", "", trace, counter.items(),
+                           "count", false);
+    perf_test::PrintResult("ipc_bytes", "", trace, counter.bytes(), "bytes",
+                           true);
+    EXPECT_GT(counter.items(), 0u);
+  }
+
+ private:
+  base::ScopedTempDir temp_dir_;
+};
+
+TEST_F(ImporterPerfTest, ChromeProfiles) {
+  for (const ProfileSize& size : kProfileSizes) {
+    const base::FilePath dir = GetProfileDir("chrome", size);
+    ASSERT_TRUE(WriteChromeProfile(dir, size));
+
+    scoped_refptr<ChromeImporter> importer(new ChromeImporter);
+    Import(importer.get(), dir,
+           importer::HISTORY | importer::FAVORITES | importer::COOKIES,
+           std::string("chrome_") + size.name);
+  }
+}
+
+TEST_F(ImporterPerfTest, BraveSessionStores) {
+  for (const ProfileSize& size : kProfileSizes) {
+    const base::FilePath dir = GetProfileDir("brave", size);
+    ASSERT_TRUE(WriteBraveSessionStore(dir, size));
+
+    scoped_refptr<BraveImporter> importer(new BraveImporter);
+    Import(importer.get(), dir,
+           importer::HISTORY | importer::FAVORITES | importer::STATS,
+           std::string("brave_") + size.name);
+  }
+}
+
+TEST_F(ImporterPerfTest, FirefoxCookies) {
+  for (const ProfileSize& size : kProfileSizes) {
+    const base::FilePath dir = GetProfileDir("firefox", size);
+    ASSERT_TRUE(WriteFirefoxCookies(dir, size));
+
+    scoped_refptr<brave::FirefoxImporter> importer(
+        new brave::FirefoxImporter);
+    Import(importer.get(), dir, importer::COOKIES,
+           std::string("firefox_") + size.name);
+  }
+}
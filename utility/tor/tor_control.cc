@@ -0,0 +1,309 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/utility/tor/tor_control.h"
+
+#include <string.h>
+
+#include <utility>
+#include <vector>
+
+#include "base/bind.h"
+#include "base/logging.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/string_split.h"
+#include "base/strings/string_util.h"
+#include "net/base/address_list.h"
+#include "net/base/io_buffer.h"
+#include "net/base/ip_address.h"
+#include "net/base/ip_endpoint.h"
+#include "net/base/net_errors.h"
+#include "net/log/net_log_source.h"
+#include "net/socket/tcp_client_socket.h"
+#include "net/traffic_annotation/network_traffic_annotation.h"
+
+namespace tor {
+
+namespace {
+
+const int kReadBufferSize = 4096;
+// Longest line accepted from the control port; status lines are far shorter.
+const size_t kMaxLineLength = 64 * 1024;
+
+const char kLineSeparator[] = "\r\n";
+const char kPortFilePrefix[] = "PORT=";
+const char kBootstrapPhaseKey[] = "status/bootstrap-phase=";
+const char kCircuitEstablishedKey[] = "status/circuit-established=";
+const char kStatusClientEvent[] = "STATUS_CLIENT";
+
+constexpr net::NetworkTrafficAnnotationTag kTorControlTrafficAnnotation =
+    net::DefineNetworkTrafficAnnotation("tor_control", R"(
+      semantics {
+        sender: "Tor Launcher"
+        description:
+          "Talks to the control port of the tor process launched by the "
+          "browser, to follow its progress connecting to the Tor network."
+        trigger: "The tor process was launched for a Tor window."
+        data: "The control port authentication cookie and status queries."
+        destination: LOCAL
+      }
+      policy {
+        cookies_allowed: NO
+        setting:
+          "This feature cannot be disabled by settings."
+        policy_exception_justification:
+          "Not implemented."
+      })");
+
+}  // namespace
+
+TorControl::TorControl(Delegate* delegate)
+    : delegate_(delegate),
+      weak_factory_(this) {
+  DCHECK(delegate_);
+}
+
+TorControl::~TorControl() {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+}
+
+void TorControl::Start(const net::IPEndPoint& address,
+                       const std::string& cookie) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  DCHECK(!socket_);
+
+  // The commands are pipelined, tor answers them in order.
+  const std::string commands =
+      "AUTHENTICATE " + base::HexEncode(cookie.data(), cookie.size()) +
+      kLineSeparator +
+      "SETEVENTS " + kStatusClientEvent + kLineSeparator +
+      "GETINFO status/bootstrap-phase status/circuit-established" +
+      kLineSeparator;
+  scoped_refptr<net::IOBuffer> buffer =
+      base::MakeRefCounted<net::StringIOBuffer>(commands);
+  write_buffer_ =
+      base::MakeRefCounted<net::DrainableIOBuffer>(buffer.get(),
+                                                   commands.size());
+  read_buffer_ = base::MakeRefCounted<net::IOBuffer>(kReadBufferSize);
+  read_data_.clear();
+
+  socket_ = std::make_unique<net::TCPClientSocket>(
+      net::AddressList(address), nullptr, nullptr, net::NetLogSource());
+  int result = socket_->Connect(base::BindOnce(&TorControl::OnConnected,
+                                               weak_factory_.GetWeakPtr()));
+  if (result != net::ERR_IO_PENDING)
+    OnConnected(result);
+}
+
+void TorControl::OnConnected(int result) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  if (result != net::OK) {
+    LOG(ERROR) << "tor control connect: " << net::ErrorToString(result);
+    Close();
+    return;
+  }
+
+  DoWrite();
+  if (socket_)
+    DoRead();
+}
+
+void TorControl::DoWrite() {
+  while (socket_ && write_buffer_->BytesRemaining() > 0) {
+    int result = socket_->Write(
+        write_buffer_.get(), write_buffer_->BytesRemaining(),
+        base::BindOnce(&TorControl::OnWrite, weak_factory_.GetWeakPtr()),
+        kTorControlTrafficAnnotation);
+    if (result == net::ERR_IO_PENDING)
+      return;
+    if (result <= 0) {
+      Close();
+      return;
+    }
+    write_buffer_->DidConsume(result);
+  }
+}
+
+void TorControl::OnWrite(int result) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  if (result <= 0) {
+    Close();
+    return;
+  }
+  write_buffer_->DidConsume(result);
+  DoWrite();
+}
+
+void TorControl::DoRead() {
+  while (socket_) {
+    int result = socket_->Read(
+        read_buffer_.get(), kReadBufferSize,
+        base::BindOnce(&TorControl::OnRead, weak_factory_.GetWeakPtr()));
+    if (result == net::ERR_IO_PENDING || !HandleRead(result))
+      return;
+  }
+}
+
+void TorControl::OnRead(int result) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  if (HandleRead(result))
+    DoRead();
+}
+
+bool TorControl::HandleRead(int result) {
+  if (result <= 0) {
+    // tor exited or closed the connection
+    Close();
+    return false;
+  }
+
+  read_data_.append(read_buffer_->data(), result);
+  size_t start = 0;
+  size_t end;
+  while (socket_ &&
+         (end = read_data_.find(kLineSeparator, start)) != std::string::npos) {
+    OnLine(read_data_.substr(start, end - start));
+    start = end + strlen(kLineSeparator);
+  }
+  if (!socket_)
+    return false;
+  read_data_.erase(0, start);
+
+  if (read_data_.size() > kMaxLineLength) {
+    LOG(ERROR) << "tor control line too long";
+    Close();
+    return false;
+  }
+  return true;
+}
+
+void TorControl::OnLine(const std::string& line) {
+  // Lines are "<status><separator><text>" where the separator is '-' or '+'
+  // for lines of a reply followed by more and ' ' for the last one.
+  if (line.size() < 4) {
+    LOG(ERROR) << "tor control malformed line: " << line;
+    Close();
+    return;
+  }
+  const base::StringPiece status(line.data(), 3);
+  const std::string text = line.substr(4);
+
+  if (status[0] == '4' || status[0] == '5') {
+    LOG(ERROR) << "tor control error: " << line;
+    Close();
+    return;
+  }
+
+  if (status == "250") {
+    if (base::StartsWith(text, kBootstrapPhaseKey,
+                         base::CompareCase::SENSITIVE)) {
+      int progress;
+      std::string summary;
+      if (ParseBootstrapStatus(text.substr(strlen(kBootstrapPhaseKey)),
+                               &progress, &summary))
+        delegate_->OnTorBootstrapProgress(progress, summary);
+    } else if (base::StartsWith(text, kCircuitEstablishedKey,
+                                base::CompareCase::SENSITIVE)) {
+      delegate_->OnTorCircuitEstablished(
+          text.substr(strlen(kCircuitEstablishedKey)) == "1");
+    }
+    return;
+  }
+
+  if (status == "650") {
+    // "STATUS_CLIENT <severity> <action> <arguments>"
+    std::vector<base::StringPiece> tokens = base::SplitStringPiece(
+        text, " ", base::TRIM_WHITESPACE, base::SPLIT_WANT_NONEMPTY);
+    if (tokens.size() < 3 || tokens[0] != kStatusClientEvent)
+      return;
+    if (tokens[2] == "BOOTSTRAP") {
+      int progress;
+      std::string summary;
+      if (ParseBootstrapStatus(text, &progress, &summary))
+        delegate_->OnTorBootstrapProgress(progress, summary);
+    } else if (tokens[2] == "CIRCUIT_ESTABLISHED") {
+      delegate_->OnTorCircuitEstablished(true);
+    } else if (tokens[2] == "CIRCUIT_NOT_ESTABLISHED") {
+      delegate_->OnTorCircuitEstablished(false);
+    }
+  }
+}
+
+void TorControl::Close() {
+  if (!socket_)
+    return;
+  socket_.reset();
+  weak_factory_.InvalidateWeakPtrs();
+  read_data_.clear();
+  delegate_->OnTorControlClosed();
+}
+
+// static
+bool TorControl::ParseControlPortFile(const std::string& contents,
+                                      net::IPEndPoint* address) {
+  DCHECK(address);
+  base::StringPiece value =
+      base::TrimWhitespaceASCII(contents, base::TRIM_ALL);
+  if (!value.starts_with(kPortFilePrefix))
+    return false;
+  value.remove_prefix(strlen(kPortFilePrefix));
+
+  const size_t colon = value.rfind(':');
+  if (colon == base::StringPiece::npos)
+    return false;
+
+  base::StringPiece host = value.substr(0, colon);
+  if (host.size() > 2 && host[0] == '[' && host[host.size() - 1] == ']')
+    host = host.substr(1, host.size() - 2);
+
+  net::IPAddress ip;
+  int port;
+  if (!ip.AssignFromIPLiteral(host) ||
+      !base::StringToInt(value.substr(colon + 1), &port) ||
+      port <= 0 || port > 65535)
+    return false;
+
+  *address = net::IPEndPoint(ip, static_cast<uint16_t>(port));
+  return true;
+}
+
+// static
+bool TorControl::ParseBootstrapStatus(const std::string& status,
+                                      int* progress,
+                                      std::string* summary) {
+  DCHECK(progress);
+  DCHECK(summary);
+  std::vector<base::StringPiece> tokens = base::SplitStringPiece(
+      status, " ", base::TRIM_WHITESPACE, base::SPLIT_WANT_NONEMPTY);
+  bool bootstrap = false;
+  bool has_progress = false;
+  for (const auto& token : tokens) {
+    if (token == "BOOTSTRAP") {
+      bootstrap = true;
+    } else if (token.starts_with("PROGRESS=")) {
+      has_progress =
+          base::StringToInt(token.substr(strlen("PROGRESS=")), progress) &&
+          *progress >= 0 && *progress <= 100;
+    }
+  }
+  if (!bootstrap || !has_progress)
+    return false;
+
+  // SUMMARY is a quoted string that may contain spaces and escapes.
+  summary->clear();
+  const char kSummaryKey[] = "SUMMARY=\"";
+  size_t pos = status.find(kSummaryKey);
+  if (pos == std::string::npos)
+    return true;
+  for (pos += strlen(kSummaryKey); pos < status.size(); ++pos) {
+    if (status[pos] == '"')
+      break;
+    if (status[pos] == '\\' && pos + 1 < status.size())
+      ++pos;
+    summary->push_back(status[pos]);
+  }
+  return true;
+}
+
+}  // namespace tor
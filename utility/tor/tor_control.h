@@ -0,0 +1,90 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_UTILITY_TOR_TOR_CONTROL_H_
+#define BRAVE_UTILITY_TOR_TOR_CONTROL_H_
+
+#include <memory>
+#include <string>
+
+#include "base/macros.h"
+#include "base/memory/ref_counted.h"
+#include "base/memory/weak_ptr.h"
+#include "base/sequence_checker.h"
+
+namespace net {
+class DrainableIOBuffer;
+class IOBuffer;
+class IPEndPoint;
+class StreamSocket;
+}
+
+namespace tor {
+
+// Client of the control port of a tor process, see control-spec.txt.
+// Authenticates with the cookie tor wrote and follows the bootstrap progress
+// and whether tor has established a circuit. Must be used on a sequence
+// with an IO message loop.
+class TorControl {
+ public:
+  // Called on the sequence of the TorControl, which must not be deleted from
+  // the calls.
+  class Delegate {
+   public:
+    virtual ~Delegate() {}
+
+    // |progress| is a percentage, |summary| tor's description of the phase.
+    virtual void OnTorBootstrapProgress(int progress,
+                                        const std::string& summary) = 0;
+    virtual void OnTorCircuitEstablished(bool established) = 0;
+    // The connection failed, was refused or tor closed it.
+    virtual void OnTorControlClosed() = 0;
+  };
+
+  explicit TorControl(Delegate* delegate);
+  ~TorControl();
+
+  // Connects to the control port at |address|, authenticates with the raw
+  // |cookie| and asks for the current status and for status events.
+  void Start(const net::IPEndPoint& address, const std::string& cookie);
+
+  // Parses the "PORT=<ip>:<port>" tor writes to --controlportwritetofile.
+  static bool ParseControlPortFile(const std::string& contents,
+                                   net::IPEndPoint* address);
+  // Parses a bootstrap status, e.g. "NOTICE BOOTSTRAP PROGRESS=80
+  // TAG=conn_or SUMMARY="Connecting to the Tor network"", as returned for
+  // status/bootstrap-phase and sent in STATUS_CLIENT events.
+  static bool ParseBootstrapStatus(const std::string& status,
+                                   int* progress,
+                                   std::string* summary);
+
+ private:
+  void OnConnected(int result);
+  void DoWrite();
+  void OnWrite(int result);
+  void DoRead();
+  void OnRead(int result);
+  // Returns false once reading should stop.
+  bool HandleRead(int result);
+  // Handles one line of a reply or of an asynchronous event.
+  void OnLine(const std::string& line);
+  void Close();
+
+  Delegate* delegate_;  // NOT OWNED
+  std::unique_ptr<net::StreamSocket> socket_;
+  scoped_refptr<net::DrainableIOBuffer> write_buffer_;
+  scoped_refptr<net::IOBuffer> read_buffer_;
+  // Received data after the last complete line.
+  std::string read_data_;
+
+  SEQUENCE_CHECKER(sequence_checker_);
+
+  base::WeakPtrFactory<TorControl> weak_factory_;
+
+  DISALLOW_COPY_AND_ASSIGN(TorControl);
+};
+
+}  // namespace tor
+
+#endif  // BRAVE_UTILITY_TOR_TOR_CONTROL_H_
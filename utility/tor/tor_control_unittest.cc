@@ -0,0 +1,275 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/utility/tor/tor_control.h"
+
+#include <memory>
+#include <string>
+
+#include "base/run_loop.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/test/scoped_task_environment.h"
+#include "net/base/io_buffer.h"
+#include "net/base/ip_address.h"
+#include "net/base/ip_endpoint.h"
+#include "net/base/net_errors.h"
+#include "net/base/test_completion_callback.h"
+#include "net/log/net_log_source.h"
+#include "net/socket/stream_socket.h"
+#include "net/socket/tcp_server_socket.h"
+#include "net/traffic_annotation/network_traffic_annotation_test_helper.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+// npm run test -- brave_unit_tests --filter=TorControl*
+
+namespace tor {
+
+namespace {
+
+const char kCookie[] = "0123456789abcdef0123456789abcdef";
+
+// Serves one control port connection on localhost, scripted by the test.
+class FakeTorControlServer {
+ public:
+  FakeTorControlServer() {}
+
+  void Listen() {
+    server_ = std::make_unique<net::TCPServerSocket>(nullptr,
+                                                     net::NetLogSource());
+    ASSERT_EQ(net::OK, server_->Listen(
+        net::IPEndPoint(net::IPAddress::IPv4Localhost(), 0), 1));
+    ASSERT_EQ(net::OK, server_->GetLocalAddress(&address_));
+  }
+
+  void Accept() {
+    net::TestCompletionCallback callback;
+    int result = server_->Accept(&connection_, callback.callback());
+    ASSERT_EQ(net::OK, callback.GetResult(result));
+  }
+
+  std::string ReadLine() {
+    size_t end;
+    while ((end = data_.find("\r\n")) == std::string::npos) {
+      scoped_refptr<net::IOBuffer> buffer =
+          base::MakeRefCounted<net::IOBuffer>(1024);
+      net::TestCompletionCallback callback;
+      int result = callback.GetResult(
+          connection_->Read(buffer.get(), 1024, callback.callback()));
+      if (result <= 0)
+        return std::string();
+      data_.append(buffer->data(), result);
+    }
+    std::string line = data_.substr(0, end);
+    data_.erase(0, end + 2);
+    return line;
+  }
+
+  void Send(const std::string& data) {
+    scoped_refptr<net::DrainableIOBuffer> buffer =
+        base::MakeRefCounted<net::DrainableIOBuffer>(
+            base::MakeRefCounted<net::StringIOBuffer>(data).get(),
+            data.size());
+    while (buffer->BytesRemaining() > 0) {
+      net::TestCompletionCallback callback;
+      int result = callback.GetResult(connection_->Write(
+          buffer.get(), buffer->BytesRemaining(), callback.callback(),
+          TRAFFIC_ANNOTATION_FOR_TESTS));
+      ASSERT_GT(result, 0);
+      buffer->DidConsume(result);
+    }
+  }
+
+  void CloseConnection() { connection_.reset(); }
+
+  const net::IPEndPoint& address() const { return address_; }
+
+ private:
+  std::unique_ptr<net::TCPServerSocket> server_;
+  std::unique_ptr<net::StreamSocket> connection_;
+  net::IPEndPoint address_;
+  std::string data_;
+
+  DISALLOW_COPY_AND_ASSIGN(FakeTorControlServer);
+};
+
+}  // namespace
+
+class TorControlTest : public testing::Test,
+                       public TorControl::Delegate {
+ public:
+  TorControlTest()
+      : scoped_task_environment_(
+            base::test::ScopedTaskEnvironment::MainThreadType::IO),
+        progress_(-1),
+        circuit_established_(false),
+        circuit_events_(0),
+        closed_(false) {}
+  ~TorControlTest() override {}
+
+  // TorControl::Delegate:
+  void OnTorBootstrapProgress(int progress,
+                              const std::string& summary) override {
+    progress_ = progress;
+    summary_ = summary;
+    Quit();
+  }
+  void OnTorCircuitEstablished(bool established) override {
+    circuit_established_ = established;
+    ++circuit_events_;
+    Quit();
+  }
+  void OnTorControlClosed() override {
+    closed_ = true;
+    Quit();
+  }
+
+ protected:
+  void SetUp() override {
+    server_.Listen();
+    control_ = std::make_unique<TorControl>(this);
+    control_->Start(server_.address(), kCookie);
+    server_.Accept();
+  }
+
+  // Checks the commands sent once connected.
+  void ExpectCommands() {
+    EXPECT_EQ("AUTHENTICATE " +
+                  base::HexEncode(kCookie, sizeof(kCookie) - 1),
+              server_.ReadLine());
+    EXPECT_EQ("SETEVENTS STATUS_CLIENT", server_.ReadLine());
+    EXPECT_EQ("GETINFO status/bootstrap-phase status/circuit-established",
+              server_.ReadLine());
+  }
+
+  // Runs until the delegate was called |count| more times about a circuit,
+  // or the connection closed.
+  void WaitForCircuitEvents(int count) {
+    const int expected = circuit_events_ + count;
+    while (circuit_events_ < expected && !closed_)
+      Run();
+  }
+
+  void WaitForClosed() {
+    while (!closed_)
+      Run();
+  }
+
+  // Declared first so that the sockets go away while the IO loop exists.
+  base::test::ScopedTaskEnvironment scoped_task_environment_;
+  FakeTorControlServer server_;
+  std::unique_ptr<TorControl> control_;
+
+  int progress_;
+  std::string summary_;
+  bool circuit_established_;
+  int circuit_events_;
+  bool closed_;
+
+ private:
+  void Run() {
+    base::RunLoop run_loop;
+    quit_closure_ = run_loop.QuitClosure();
+    run_loop.Run();
+  }
+
+  void Quit() {
+    if (quit_closure_)
+      std::move(quit_closure_).Run();
+  }
+
+  base::OnceClosure quit_closure_;
+
+  DISALLOW_COPY_AND_ASSIGN(TorControlTest);
+};
+
+TEST_F(TorControlTest, FollowsBootstrap) {
+  ExpectCommands();
+  server_.Send(
+      "250 OK\r\n"
+      "250 OK\r\n"
+      "250-status/bootstrap-phase=NOTICE BOOTSTRAP PROGRESS=85 "
+      "TAG=handshake_or SUMMARY=\"Finishing handshake with first hop\"\r\n"
+      "250-status/circuit-established=0\r\n"
+      "250 OK\r\n");
+  WaitForCircuitEvents(1);
+  EXPECT_FALSE(closed_);
+  EXPECT_EQ(85, progress_);
+  EXPECT_EQ("Finishing handshake with first hop", summary_);
+  EXPECT_FALSE(circuit_established_);
+
+  // events may arrive split at any point
+  server_.Send("650 STATUS_CLIENT NOTICE BOOTSTRAP PROGRESS=100 TAG=done ");
+  server_.Send("SUMMARY=\"Done\"\r\n650 STATUS_CLIENT NOTICE CIRCUIT_EST");
+  server_.Send("ABLISHED\r\n");
+  WaitForCircuitEvents(1);
+  EXPECT_FALSE(closed_);
+  EXPECT_EQ(100, progress_);
+  EXPECT_EQ("Done", summary_);
+  EXPECT_TRUE(circuit_established_);
+
+  server_.Send("650 STATUS_CLIENT NOTICE CIRCUIT_NOT_ESTABLISHED "
+               "REASON=CLOCK_JUMPED\r\n");
+  WaitForCircuitEvents(1);
+  EXPECT_FALSE(circuit_established_);
+
+  // tor exited
+  server_.CloseConnection();
+  WaitForClosed();
+}
+
+TEST_F(TorControlTest, ClosesOnAuthenticationFailure) {
+  ExpectCommands();
+  server_.Send("515 Authentication failed: Authentication cookie did not "
+               "match expected value.\r\n");
+  WaitForClosed();
+  EXPECT_EQ(-1, progress_);
+  EXPECT_EQ(0, circuit_events_);
+}
+
+TEST(TorControlParseTest, ParseControlPortFile) {
+  net::IPEndPoint address;
+  EXPECT_TRUE(TorControl::ParseControlPortFile("PORT=127.0.0.1:9151\n",
+                                               &address));
+  EXPECT_EQ("127.0.0.1:9151", address.ToString());
+  EXPECT_TRUE(TorControl::ParseControlPortFile("PORT=[::1]:40123", &address));
+  EXPECT_EQ("[::1]:40123", address.ToString());
+
+  EXPECT_FALSE(TorControl::ParseControlPortFile("", &address));
+  EXPECT_FALSE(TorControl::ParseControlPortFile("127.0.0.1:9151", &address));
+  EXPECT_FALSE(TorControl::ParseControlPortFile("PORT=127.0.0.1", &address));
+  EXPECT_FALSE(TorControl::ParseControlPortFile("PORT=localhost:9151",
+                                                &address));
+  EXPECT_FALSE(TorControl::ParseControlPortFile("PORT=127.0.0.1:0",
+                                                &address));
+  EXPECT_FALSE(TorControl::ParseControlPortFile("PORT=127.0.0.1:65536",
+                                                &address));
+}
+
+TEST(TorControlParseTest, ParseBootstrapStatus) {
+  int progress;
+  std::string summary;
+  EXPECT_TRUE(TorControl::ParseBootstrapStatus(
+      "NOTICE BOOTSTRAP PROGRESS=10 TAG=conn_dir "
+      "SUMMARY=\"Connecting to \\\"directory\\\" server\"",
+      &progress, &summary));
+  EXPECT_EQ(10, progress);
+  EXPECT_EQ("Connecting to \"directory\" server", summary);
+
+  EXPECT_TRUE(TorControl::ParseBootstrapStatus(
+      "STATUS_CLIENT NOTICE BOOTSTRAP PROGRESS=100 TAG=done",
+      &progress, &summary));
+  EXPECT_EQ(100, progress);
+  EXPECT_EQ("", summary);
+
+  EXPECT_FALSE(TorControl::ParseBootstrapStatus(
+      "NOTICE CIRCUIT_ESTABLISHED", &progress, &summary));
+  EXPECT_FALSE(TorControl::ParseBootstrapStatus(
+      "NOTICE BOOTSTRAP TAG=done", &progress, &summary));
+  EXPECT_FALSE(TorControl::ParseBootstrapStatus(
+      "NOTICE BOOTSTRAP PROGRESS=101", &progress, &summary));
+  EXPECT_FALSE(TorControl::ParseBootstrapStatus(
+      "NOTICE BOOTSTRAP PROGRESS=ten", &progress, &summary));
+}
+
+}  // namespace tor
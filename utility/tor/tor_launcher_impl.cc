@@ -17,12 +17,15 @@
 
 #include "base/command_line.h"
 #include "base/files/file_util.h"
+#include "base/message_loop/message_loop.h"
 #include "base/process/kill.h"
 #include "base/process/launch.h"
 #include "base/single_thread_task_runner.h"
 #include "base/task/post_task.h"
 #include "base/threading/thread.h"
 #include "base/threading/thread_task_runner_handle.h"
+#include "base/time/time.h"
+#include "net/base/ip_endpoint.h"
 
 #if defined(OS_POSIX)
 int pipehack[2];
@@ -74,6 +77,23 @@ static void TearDownPipeHack() {
 
 namespace tor {
 
+namespace {
+
+const char kControlPortFile[] = "controlport";
+const char kControlAuthCookieFile[] = "control_auth_cookie";
+const size_t kControlAuthCookieSize = 32;
+
+// tor writes the control port files shortly after it started, usually well
+// within a second. Past these attempts, and after the connection closed, the
+// control port is retried less often for as long as tor runs.
+const int kTorControlMaxAttempts = 100;
+constexpr base::TimeDelta kTorControlRetryDelay =
+    base::TimeDelta::FromMilliseconds(100);
+constexpr base::TimeDelta kTorControlReconnectDelay =
+    base::TimeDelta::FromSeconds(5);
+
+}  // namespace
+
 #if defined(OS_POSIX)
 class TorLauncherDelegate : public base::LaunchOptions::PreExecDelegate {
  public:
@@ -92,13 +112,25 @@ class TorLauncherDelegate : public base::LaunchOptions::PreExecDelegate {
 
 TorLauncherImpl::TorLauncherImpl(
     std::unique_ptr<service_manager::ServiceContextRef> service_ref)
-    : service_ref_(std::move(service_ref)) {
+    : service_ref_(std::move(service_ref)),
+      main_task_runner_(base::ThreadTaskRunnerHandle::Get()),
+      launch_id_(0),
+      control_launch_id_(0),
+      control_circuit_established_(false),
+      weak_factory_(this) {
+  weak_this_ = weak_factory_.GetWeakPtr();
 #if defined(OS_POSIX)
   SetupPipeHack();
 #endif
 }
 
 TorLauncherImpl::~TorLauncherImpl() {
+  if (control_thread_) {
+    control_thread_->task_runner()->PostTask(
+        FROM_HERE, base::BindOnce(&TorLauncherImpl::StopTorControl,
+                                  base::Unretained(this)));
+    control_thread_->Stop();
+  }
   if (tor_process_.IsValid()) {
     tor_process_.Terminate(0, true);
 #if defined(OS_POSIX)
@@ -147,11 +179,15 @@ void TorLauncherImpl::Launch(const TorConfig& config,
     args.AppendArg("--controlport");
     args.AppendArg("auto");
     args.AppendArg("--controlportwritetofile");
-    args.AppendArgPath(tor_watch_path.AppendASCII("controlport"));
+    args.AppendArgPath(tor_watch_path.AppendASCII(kControlPortFile));
     args.AppendArg("--cookieauthentication");
     args.AppendArg("1");
     args.AppendArg("--cookieauthfile");
-    args.AppendArgPath(tor_watch_path.AppendASCII("control_auth_cookie"));
+    args.AppendArgPath(tor_watch_path.AppendASCII(kControlAuthCookieFile));
+    // files of an earlier run would point at a stale port
+    base::DeleteFile(tor_watch_path.AppendASCII(kControlPortFile), false);
+    base::DeleteFile(tor_watch_path.AppendASCII(kControlAuthCookieFile),
+                     false);
   }
 
   base::LaunchOptions launchopts;
@@ -167,12 +203,28 @@ void TorLauncherImpl::Launch(const TorConfig& config,
 #endif
   tor_process_ = base::LaunchProcess(args, launchopts);
 
-  // TODO(darkdh): return success when tor connected to tor network
+  // Connecting to the Tor network is reported to the observer by the control
+  // port, see StartTorControl.
   bool result = tor_process_.IsValid();
 
   if (callback)
     std::move(callback).Run(result, tor_process_.Pid());
 
+  if (result && !tor_watch_path.empty()) {
+    if (!control_thread_) {
+      control_thread_.reset(new base::Thread("tor_control_thread"));
+      base::Thread::Options options(base::MessageLoop::TYPE_IO, 0);
+      if (!control_thread_->StartWithOptions(options)) {
+        NOTREACHED();
+      }
+    }
+    control_thread_->task_runner()->PostTask(
+        FROM_HERE,
+        base::BindOnce(&TorLauncherImpl::StartTorControl,
+                       base::Unretained(this), tor_watch_path, ++launch_id_,
+                       0));
+  }
+
   if (!child_monitor_thread_.get()) {
     child_monitor_thread_.reset(new base::Thread("child_monitor_thread"));
     if (!child_monitor_thread_->Start()) {
@@ -191,6 +243,11 @@ void TorLauncherImpl::SetCrashHandler(SetCrashHandlerCallback callback) {
 
 void TorLauncherImpl::ReLaunch(const TorConfig& config,
                                ReLaunchCallback callback) {
+  if (control_thread_) {
+    control_thread_->task_runner()->PostTask(
+        FROM_HERE, base::BindOnce(&TorLauncherImpl::StopTorControl,
+                                  base::Unretained(this)));
+  }
   if (tor_process_.IsValid())
     tor_process_.Terminate(0, true);
 
@@ -198,6 +255,100 @@ void TorLauncherImpl::ReLaunch(const TorConfig& config,
   Launch(config, std::move(callback));
 }
 
+void TorLauncherImpl::SetObserver(
+    tor::mojom::TorLauncherObserverPtr observer) {
+  observer_ = std::move(observer);
+}
+
+void TorLauncherImpl::StartTorControl(const base::FilePath& watch_path,
+                                      int launch_id,
+                                      int attempt) {
+  if (attempt == 0) {
+    tor_control_.reset();
+    control_launch_id_ = launch_id;
+    control_watch_path_ = watch_path;
+    control_circuit_established_ = false;
+  } else if (launch_id != control_launch_id_) {
+    // tor was relaunched or stopped since
+    return;
+  }
+
+  std::string port_file;
+  std::string cookie;
+  net::IPEndPoint address;
+  if (!base::ReadFileToString(watch_path.AppendASCII(kControlPortFile),
+                              &port_file) ||
+      !TorControl::ParseControlPortFile(port_file, &address) ||
+      !base::ReadFileToString(watch_path.AppendASCII(kControlAuthCookieFile),
+                              &cookie) ||
+      cookie.size() != kControlAuthCookieSize) {
+    if (attempt + 1 == kTorControlMaxAttempts)
+      LOG(ERROR) << "tor control port not available yet";
+    control_thread_->task_runner()->PostDelayedTask(
+        FROM_HERE,
+        base::BindOnce(&TorLauncherImpl::StartTorControl,
+                       base::Unretained(this), watch_path, launch_id,
+                       attempt + 1),
+        attempt + 1 < kTorControlMaxAttempts ? kTorControlRetryDelay
+                                             : kTorControlReconnectDelay);
+    return;
+  }
+
+  tor_control_ = std::make_unique<TorControl>(this);
+  tor_control_->Start(address, cookie);
+}
+
+void TorLauncherImpl::StopTorControl() {
+  control_launch_id_ = 0;
+  control_circuit_established_ = false;
+  tor_control_.reset();
+}
+
+void TorLauncherImpl::OnTorBootstrapProgress(int progress,
+                                             const std::string& summary) {
+  main_task_runner_->PostTask(
+      FROM_HERE, base::BindOnce(&TorLauncherImpl::NotifyTorBootstrapProgress,
+                                weak_this_, progress, summary));
+}
+
+void TorLauncherImpl::OnTorCircuitEstablished(bool established) {
+  control_circuit_established_ = established;
+  main_task_runner_->PostTask(
+      FROM_HERE, base::BindOnce(&TorLauncherImpl::NotifyTorCircuitEstablished,
+                                weak_this_, established));
+}
+
+void TorLauncherImpl::OnTorControlClosed() {
+  LOG(WARNING) << "tor control connection closed";
+  // nothing reports the circuit anymore, so it can't be relied on
+  if (control_circuit_established_)
+    OnTorCircuitEstablished(false);
+  // the delegate can't delete |tor_control_| while it calls out
+  base::ThreadTaskRunnerHandle::Get()->DeleteSoon(FROM_HERE,
+                                                  tor_control_.release());
+  // tor may still run, with a control port that failed the authentication or
+  // was rewritten; StopTorControl and relaunches end the retries
+  if (!control_launch_id_)
+    return;
+  control_thread_->task_runner()->PostDelayedTask(
+      FROM_HERE,
+      base::BindOnce(&TorLauncherImpl::StartTorControl,
+                     base::Unretained(this), control_watch_path_,
+                     control_launch_id_, kTorControlMaxAttempts),
+      kTorControlReconnectDelay);
+}
+
+void TorLauncherImpl::NotifyTorBootstrapProgress(int progress,
+                                                 const std::string& summary) {
+  if (observer_)
+    observer_->OnTorBootstrapProgress(progress, summary);
+}
+
+void TorLauncherImpl::NotifyTorCircuitEstablished(bool established) {
+  if (observer_)
+    observer_->OnTorCircuitEstablished(established);
+}
+
 void TorLauncherImpl::MonitorChild() {
 #if defined(OS_POSIX)
   char buf[PIPE_BUF];
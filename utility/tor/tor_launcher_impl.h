@@ -9,15 +9,21 @@
 #include <string>
 #include <vector>
 
+#include "base/files/file_path.h"
 #include "base/macros.h"
+#include "base/memory/weak_ptr.h"
 #include "base/process/process.h"
+#include "base/single_thread_task_runner.h"
+#include "base/threading/thread.h"
 #include "brave/common/tor/tor_launcher.mojom.h"
+#include "brave/utility/tor/tor_control.h"
 #include "mojo/public/cpp/bindings/interface_request.h"
 #include "services/service_manager/public/cpp/service_context_ref.h"
 
 namespace tor {
 
-class TorLauncherImpl : public tor::mojom::TorLauncher {
+class TorLauncherImpl : public tor::mojom::TorLauncher,
+                        public TorControl::Delegate {
  public:
   explicit TorLauncherImpl(
       std::unique_ptr<service_manager::ServiceContextRef> service_ref);
@@ -29,15 +35,49 @@ class TorLauncherImpl : public tor::mojom::TorLauncher {
   void SetCrashHandler(SetCrashHandlerCallback callback) override;
   void ReLaunch(const TorConfig& config,
               ReLaunchCallback callback) override;
+  void SetObserver(tor::mojom::TorLauncherObserverPtr observer) override;
+
+  // TorControl::Delegate, called on |control_thread_|
+  void OnTorBootstrapProgress(int progress,
+                              const std::string& summary) override;
+  void OnTorCircuitEstablished(bool established) override;
+  void OnTorControlClosed() override;
 
  private:
   void MonitorChild();
 
+  // Connects to the control port once tor wrote the port and cookie files to
+  // |watch_path|, retrying until it has. Attempts past kTorControlMaxAttempts
+  // are spaced further apart. Runs on |control_thread_|.
+  void StartTorControl(const base::FilePath& watch_path,
+                       int launch_id,
+                       int attempt);
+  void StopTorControl();
+
+  void NotifyTorBootstrapProgress(int progress, const std::string& summary);
+  void NotifyTorCircuitEstablished(bool established);
+
   SetCrashHandlerCallback crash_handler_callback_;
   std::unique_ptr<base::Thread> child_monitor_thread_;
   base::Process tor_process_;
   const std::unique_ptr<service_manager::ServiceContextRef> service_ref_;
 
+  tor::mojom::TorLauncherObserverPtr observer_;
+  scoped_refptr<base::SingleThreadTaskRunner> main_task_runner_;
+  std::unique_ptr<base::Thread> control_thread_;
+  // Incremented by every launch so that retries of an earlier launch stop.
+  int launch_id_;
+  // Only used on |control_thread_|.
+  std::unique_ptr<TorControl> tor_control_;
+  int control_launch_id_;
+  base::FilePath control_watch_path_;
+  // The circuit state last reported by |tor_control_|.
+  bool control_circuit_established_;
+
+  // Bound to the main thread, copied to post back from |control_thread_|.
+  base::WeakPtr<TorLauncherImpl> weak_this_;
+  base::WeakPtrFactory<TorLauncherImpl> weak_factory_;
+
   DISALLOW_COPY_AND_ASSIGN(TorLauncherImpl);
 };
 